@@ -1,5 +1,4 @@
 ﻿#pragma once
-#include "../src/precompiled.h"
 #include <string>
 #include <glm/vec3.hpp>
 
@@ -12,12 +11,13 @@ struct Config final
 	inline static constexpr int height = 1080;
 	inline static constexpr const char* const window_name = "8-Ball-Pool";
 
-	// Shadow
-	inline static constexpr int shadow_width = 2048;
-	inline static constexpr int shadow_height = 2048;
+	// Shadow (map resolution is part of the quality tier)
 	inline static constexpr float shadow_extent = 8.0f;
 	inline static constexpr float near_plane = 1.0f;
 	inline static constexpr float far_plane = 20.0f;
+	inline static constexpr int shadow_updates_per_frame = 6; // shadow maps redrawn per frame (new or moved lights always are)
+	inline static constexpr int shadow_realtime_lights = 3;   // most important lights refresh every frame...
+	inline static constexpr int shadow_refresh_interval = 4;  // ...the rest round-robin, at least every this many frames
 
 	// Camera
 	inline static constexpr bool bound_camera = true;
@@ -53,6 +53,7 @@ struct Config final
 	inline static constexpr const char* const screen_fragment_path = "screen.fragmentshader";
 	inline static constexpr const char* line_vertex_path = "line.vertexshader";
 	inline static constexpr const char* line_fragment_path = "line.fragmentshader";
+	inline static constexpr int overlay_vertices_per_frame = 1 << 16; // LineBatch ring: line vertices per frame (16 bytes each, 3 frames)
 
 
 
@@ -64,19 +65,48 @@ struct Config final
 	inline static constexpr const char* const ball_path = "ball.obj";
 	inline static constexpr const char* const lightbulb_path = "lamp.obj";
 	inline static constexpr const char* const ceiling_path = "ceiling.obj";
+	inline static constexpr unsigned transform_buffer_binding = 0; // SSBO of per-frame model matrices (defined into the shaders)
+
+	// Clustered lighting: froxel grid over the view frustum (sizes, depth range and bindings are defined into the shaders by Shader)
+	inline static constexpr int cluster_x = 16;
+	inline static constexpr int cluster_y = 9;
+	inline static constexpr int cluster_z = 24;              // exponential depth slices between cluster_near and cluster_far
+	inline static constexpr float cluster_near = 0.05f;
+	inline static constexpr float cluster_far = 20.0f;       // anything deeper shares the last slice
+	inline static constexpr unsigned light_buffer_binding = 1;
+	inline static constexpr unsigned cluster_buffer_binding = 2;
+	inline static constexpr unsigned light_index_binding = 3;
 
 
 	// Lighting
 	inline static constexpr int light_count = 3; // Existing lights controlled with LShift
 	inline static constexpr int physical_light_count = 10; // New physical lights controlled with numpad
-	inline static constexpr int max_shader_lights = 14; // Maximum number of lights in the shader
+	inline static constexpr int max_shadow_maps = 14; // Layers of the shadow map array (defined into the shaders); lights past this are unshadowed
+	inline static constexpr float light_radius = 6.0f; // Attenuation radius of the physical lights
+	inline static constexpr float virtual_light_radius = 8.0f; // ... and of the LShift lights
 	inline static constexpr const char* const hdr_path = "billiard_hall_4k.hdr";
 	//inline static constexpr const char* const hdr_path = "empty_play_room_4k.hdr";
 	//inline static constexpr const char* const hdr_path = "brown_photostudio_4k.hdr"; 
-	inline static constexpr int cube_map_size = 4096;
-	inline static constexpr int irradiance_scale = 128;
-	inline static constexpr int prefilter_scale = 1024;
-	inline static constexpr int max_mip_levels = 7;
+	inline static constexpr int max_mip_levels = 7; // prefilter map; cube map / irradiance / prefilter sizes come from the quality tier
+	inline static constexpr bool sh_irradiance = true; // diffuse IBL from 9 SH coefficients projected on the CPU instead of the irradiance cube map
+
+	// Quality
+	inline static constexpr const char* const quality_config_path = "quality.cfg"; // tier = low|medium|high|ultra, plus per-tier overrides
+	inline static constexpr double calibration_budget_ms = 8.0; // GPU time for shadows + scene + blur; rest of a 60 Hz frame is headroom
+	inline static constexpr size_t calibration_frames = 5;      // timed runs per pass, median taken
+
+	// Dynamic resolution (scene only; HUD and text stay native)
+	inline static constexpr bool dynamic_resolution = true;
+	inline static constexpr double dynamic_resolution_target_ms = 12.0;   // GPU frame time the controller holds
+	inline static constexpr double dynamic_resolution_low_water = 0.75;   // scale back up only below this fraction of the target
+	inline static constexpr double dynamic_resolution_smoothing = 0.1;    // EMA weight of each new GPU measurement
+	inline static constexpr int dynamic_resolution_down_frames = 6;       // frames over target before stepping down
+	inline static constexpr int dynamic_resolution_up_frames = 90;        // frames under the low water mark before stepping up
+	inline static constexpr int dynamic_resolution_cooldown_frames = 20;  // no decision right after a change
+	inline static constexpr float min_render_scale = 0.5f;
+	inline static constexpr float render_scale_step_down = 0.1f;
+	inline static constexpr float render_scale_step_up = 0.05f;
+	inline static constexpr float upscale_sharpness = 0.6f;              // adaptive sharpening applied when upscaling (0..1)
 
 	// Font
 	//inline static constexpr const char* const font_path = "CronusRound-KA6y.ttf";
@@ -86,8 +116,17 @@ struct Config final
 	//inline static constexpr const char* const font_path = "NotoSansSymbols2-Regular.ttf";
 	inline static constexpr unsigned default_font_size = 64;
 
+	// Input
+	inline static constexpr const char* const input_recording_path = "input_recording.bin"; // F9 records, F10 replays
+
+	// Save state
+	inline static constexpr const char* const autosave_path = "autosave.bin"; // the table after every shot; F6 restores it
+
 	// Physics
-	inline static float power_coeff = 10.0f;
+	inline static constexpr int simulation_rate = 120;        // fixed ticks per second on the simulation thread
+	inline static constexpr int simulation_max_catch_up = 8;  // ticks run back-to-back before the backlog is dropped
+	inline static constexpr float default_power_coeff = 10.0f;
+	inline static float power_coeff = default_power_coeff;   // strike force; render thread only (quick setup menu), the simulation gets it in SimulationInput
 	inline static float cue_rot_speed = 0.45f; // radians/sec (~34°/s). Tweak 0.35–0.85
 	inline static float velocity_multiplier = 0.985f;
 	inline static float spin_damping = 0.95f;          // Damping for spin
@@ -97,6 +136,8 @@ struct Config final
 	// Spin → linear coupling
 	inline static float spin_longitudinal_accel = 9.5f;   // more authority for draw/follow
 	inline static float spin_lateral_accel = 1.7f;   // gentler curve
+	inline static float draw_kick = 0.18f;           // backspin restarting a ball that has all but stopped
+	inline static float impact_spin_keep = 0.97f;    // follow/draw kept through a ball-ball impact
 
 	// Rails/rim
 	inline static float rail_longitudinal_keep = 0.92f;  // keep more top/back off the rail
@@ -114,5 +155,13 @@ struct Config final
 	inline static float angular_damping = 0.89f;  // spin lasts longer (per-second)
 
 	inline static float spin_transfer_coef = 0.3f;     // how strongly spin is transferred in collisions
+	// (the above are the game's tuning; each table carries a copy, see physics/PhysicsParams.hpp)
+
+	// Aiming guide: the shot played out ahead on a copy of the table
+	inline static constexpr int trajectory_bounces = 2;              // cushions/ball contacts drawn per path
+	inline static constexpr int trajectory_tick_budget = 120;        // prediction ticks per simulation tick; longer shots finish on later ticks
+	inline static constexpr float trajectory_max_seconds = 12.0f;    // a prediction stops here even if balls still roll
+	inline static constexpr int trajectory_sample_ticks = 4;         // path points while a ball curves between bounces...
+	inline static constexpr float trajectory_min_spacing = 0.005f;   // ...at least this far apart
 
 };
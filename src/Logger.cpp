@@ -0,0 +1,246 @@
+#include "headless.h"
+#include "Logger.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace {
+    constexpr size_t kQueueCapacity = 1024;         // power of two
+    constexpr size_t kMessageCapacity = 240;        // longer messages are truncated
+
+    struct Record {
+        std::atomic<size_t> sequence{ 0 };
+        int64_t time_us = 0;
+        Logger::Category category = Logger::Category::General;
+        Logger::LogLevel level = Logger::LogLevel::INFO;
+        uint32_t suppressed = 0;
+        uint32_t length = 0;
+        char text[kMessageCapacity]{};
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    const char* LevelName(const Logger::LogLevel level) {
+        switch (level) {
+            case Logger::LogLevel::DEBUG: return "DEBUG";
+            case Logger::LogLevel::INFO: return "INFO";
+            case Logger::LogLevel::WARNING: return "WARNING";
+            case Logger::LogLevel::ERROR: return "ERROR";
+            default: return "";
+        }
+    }
+
+    const char* CategoryName(const Logger::Category category) {
+        switch (category) {
+            case Logger::Category::Render: return "Render";
+            case Logger::Category::Assets: return "Assets";
+            case Logger::Category::Input: return "Input";
+            case Logger::Category::Physics: return "Physics";
+            default: return nullptr;
+        }
+    }
+
+    void Format(std::string& out, const int64_t time_us, const Logger::Category category, const Logger::LogLevel level,
+        const std::string_view text, const uint32_t suppressed) {
+        std::format_to(std::back_inserter(out), "[{:9.3f}] [{}] ", static_cast<double>(time_us) * 1e-6, LevelName(level));
+        if (const char* name = CategoryName(category))
+            std::format_to(std::back_inserter(out), "[{}] ", name);
+        out.append(text);
+        if (suppressed > 0)
+            std::format_to(std::back_inserter(out), " (+{} similar suppressed)", suppressed);
+        out.push_back('\n');
+    }
+
+    // Bounded MPSC ring (Vyukov): producers claim a slot with one CAS on the
+    // enqueue cursor; each slot's sequence number tells the writer when it is filled.
+    class LogQueue {
+    public:
+        LogQueue() {
+            for (size_t i = 0; i < kQueueCapacity; ++i)
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            for (size_t i = 0; i < Logger::category_count; ++i)
+                levels_[i].store(Logger::compiled_levels[i], std::memory_order_relaxed);
+
+            writer_ = std::thread([this] { Run(); });
+        }
+
+        ~LogQueue() { Stop(); }
+
+        LogQueue(const LogQueue&) = delete;
+        LogQueue& operator= (const LogQueue&) = delete;
+
+        void Push(const Logger::Category category, const Logger::LogLevel level, const std::string_view text, const uint32_t suppressed) {
+            const int64_t time_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_).count();
+
+            if (!running_.load(std::memory_order_acquire)) {
+                // Shut down: write synchronously (teardown, static destructors)
+                std::string line;
+                Format(line, time_us, category, level, text, suppressed);
+                std::lock_guard lock(output_mutex_);
+                Output(line);
+                return;
+            }
+
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Record* record;
+            for (;;) {
+                record = &slots_[pos & (kQueueCapacity - 1)];
+                const size_t sequence = record->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);   // full: never block the caller
+                    return;
+                }
+                else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+
+            record->time_us = time_us;
+            record->category = category;
+            record->level = level;
+            record->suppressed = suppressed;
+            record->length = static_cast<uint32_t>(std::min(text.size(), kMessageCapacity));
+            std::memcpy(record->text, text.data(), record->length);
+            record->sequence.store(pos + 1, std::memory_order_release);
+
+            if (!wake_.exchange(true, std::memory_order_acq_rel))
+                wake_.notify_one();
+        }
+
+        void Open(const std::string& filename) {
+            std::lock_guard lock(output_mutex_);
+            file_.open(filename, std::ios::out | std::ios::app);
+        }
+
+        void Stop() {
+            if (!running_.exchange(false))
+                return;
+            wake_.store(true, std::memory_order_release);
+            wake_.notify_one();
+            if (writer_.joinable())
+                writer_.join();
+
+            // Pick up anything pushed while the writer was exiting
+            std::string batch;
+            Drain(batch);
+
+            std::lock_guard lock(output_mutex_);
+            Output(batch);
+            if (file_.is_open())
+                file_.close();
+        }
+
+        std::atomic<int>& Level(const Logger::Category category) { return levels_[static_cast<size_t>(category)]; }
+
+    private:
+        void Run() {
+            std::string batch;
+            batch.reserve(16 * 1024);
+
+            for (;;) {
+                wake_.store(false, std::memory_order_release);
+                const bool stopping = !running_.load(std::memory_order_acquire);
+
+                Drain(batch);
+                if (!batch.empty()) {
+                    std::lock_guard lock(output_mutex_);
+                    Output(batch);
+                    batch.clear();
+                }
+
+                if (stopping)
+                    return;
+                wake_.wait(false, std::memory_order_acquire);
+            }
+        }
+
+        void Drain(std::string& batch) {
+            for (;;) {
+                Record& record = slots_[dequeue_pos_ & (kQueueCapacity - 1)];
+                if (record.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1)
+                    break;
+
+                Format(batch, record.time_us, record.category, record.level,
+                    std::string_view(record.text, record.length), record.suppressed);
+
+                record.sequence.store(dequeue_pos_ + kQueueCapacity, std::memory_order_release);
+                ++dequeue_pos_;
+            }
+
+            if (const uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed); dropped > 0)
+                std::format_to(std::back_inserter(batch), "[Logger] {} messages dropped (queue full)\n", dropped);
+        }
+
+        // One write + one flush per batch (output_mutex_ held)
+        void Output(const std::string& text) {
+            std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+            std::cout.flush();
+            if (file_.is_open()) {
+                file_.write(text.data(), static_cast<std::streamsize>(text.size()));
+                file_.flush();
+            }
+        }
+
+        std::array<Record, kQueueCapacity> slots_{};
+        alignas(64) std::atomic<size_t> enqueue_pos_{ 0 };
+        alignas(64) size_t dequeue_pos_ = 0;            // writer thread only
+        std::atomic<uint32_t> dropped_{ 0 };
+        std::atomic<bool> wake_{ false };
+        std::atomic<bool> running_{ true };
+
+        std::array<std::atomic<int>, Logger::category_count> levels_{};
+
+        const Clock::time_point start_ = Clock::now();
+        std::mutex output_mutex_;                       // writer vs. Init/Close, never on the hot path
+        std::ofstream file_;
+        std::thread writer_;
+    };
+
+    LogQueue& Queue() {
+        static LogQueue queue;
+        return queue;
+    }
+}
+
+void Logger::Init(const std::string& filename) {
+    Queue().Open(filename);
+}
+
+void Logger::SetLevel(const Category category, const LogLevel level) {
+    Queue().Level(category).store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool Logger::IsEnabled(const Category category, const LogLevel level) {
+    return level != LogLevel::OFF && static_cast<int>(level) >= Queue().Level(category).load(std::memory_order_relaxed);
+}
+
+void Logger::Write(const Category category, const LogLevel level, const std::string_view message, const uint32_t suppressed) {
+    Queue().Push(category, level, message, suppressed);
+}
+
+void Logger::Close() {
+    Queue().Stop();
+}
+
+bool Logger::RateLimit::Allow(uint32_t& suppressed) {
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+
+    int64_t start = window_start_.load(std::memory_order_relaxed);
+    if (now - start >= interval_ms && window_start_.compare_exchange_strong(start, now, std::memory_order_relaxed))
+        in_window_.store(0, std::memory_order_relaxed);
+
+    if (in_window_.fetch_add(1, std::memory_order_relaxed) < burst) {
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
@@ -1,41 +1,124 @@
 #pragma once
-#include "../precompiled.h"
+#include "headless.h"
 
+#include <atomic>
+
+// Compile-time floor (0 = DEBUG, 1 = INFO, 2 = WARNING, 3 = ERROR, 4 = OFF).
+// LOG_* calls below the floor of their category are compiled out entirely.
+#ifndef BILLIARDS_LOG_LEVEL
+#ifdef NDEBUG
+#define BILLIARDS_LOG_LEVEL 1
+#else
+#define BILLIARDS_LOG_LEVEL 0
+#endif
+#endif
+
+// Per-category floors default to the global one; raise one to strip a noisy subsystem
+#ifndef BILLIARDS_LOG_LEVEL_GENERAL
+#define BILLIARDS_LOG_LEVEL_GENERAL BILLIARDS_LOG_LEVEL
+#endif
+#ifndef BILLIARDS_LOG_LEVEL_RENDER
+#define BILLIARDS_LOG_LEVEL_RENDER BILLIARDS_LOG_LEVEL
+#endif
+#ifndef BILLIARDS_LOG_LEVEL_ASSETS
+#define BILLIARDS_LOG_LEVEL_ASSETS BILLIARDS_LOG_LEVEL
+#endif
+#ifndef BILLIARDS_LOG_LEVEL_INPUT
+#define BILLIARDS_LOG_LEVEL_INPUT BILLIARDS_LOG_LEVEL
+#endif
+#ifndef BILLIARDS_LOG_LEVEL_PHYSICS
+#define BILLIARDS_LOG_LEVEL_PHYSICS BILLIARDS_LOG_LEVEL
+#endif
+
+// Asynchronous logger: callers copy the message into a lock-free MPSC ring and
+// return; a background thread drains it and writes whole batches to stdout and
+// the log file. When the ring is full messages are dropped (and counted) rather
+// than stalling the caller.
 class Logger {
 public:
     enum class LogLevel {
+        DEBUG,
         INFO,
         WARNING,
-        ERROR
+        ERROR,
+        OFF
+    };
+
+    enum class Category {
+        General,
+        Render,
+        Assets,
+        Input,
+        Physics,
+        Count
     };
 
-    static void Init(const std::string& filename) {
-        instance().log_file_.open(filename, std::ios::out | std::ios::app);
+    static constexpr size_t category_count = static_cast<size_t>(Category::Count);
+
+    static constexpr std::array<int, category_count> compiled_levels = {
+        BILLIARDS_LOG_LEVEL_GENERAL,
+        BILLIARDS_LOG_LEVEL_RENDER,
+        BILLIARDS_LOG_LEVEL_ASSETS,
+        BILLIARDS_LOG_LEVEL_INPUT,
+        BILLIARDS_LOG_LEVEL_PHYSICS
+    };
+
+    [[nodiscard]] static constexpr bool IsCompiledIn(const Category category, const LogLevel level) {
+        return static_cast<int>(level) >= compiled_levels[static_cast<size_t>(category)] && level != LogLevel::OFF;
     }
 
+    // Opens (appends to) the log file; console output is always on
+    static void Init(const std::string& filename);
+
+    // Runtime per-category threshold, on top of the compile-time one
+    static void SetLevel(Category category, LogLevel level);
+    [[nodiscard]] static bool IsEnabled(Category category, LogLevel level);
+
+    // Enqueues a message; 'suppressed' is the number of rate-limited repeats it stands for
+    static void Write(Category category, LogLevel level, std::string_view message, uint32_t suppressed = 0);
+
+    // General category, runtime-filtered only (no rate limit)
     static void Log(const std::string& message, LogLevel level = LogLevel::INFO) {
-        std::string level_str;
-        switch (level) {
-            case LogLevel::INFO: level_str = "INFO"; break;
-            case LogLevel::WARNING: level_str = "WARNING"; break;
-            case LogLevel::ERROR: level_str = "ERROR"; break;
-        }
-        instance().log_file_ << "[" << level_str << "] " << message << std::endl;
-        std::cout << "[" << level_str << "] " << message << std::endl;
+        if (IsEnabled(Category::General, level))
+            Write(Category::General, level, message);
     }
 
-    static void Close() {
-        instance().log_file_.close();
-    }
+    // Drains what is queued, stops the writer thread and closes the file.
+    // Later messages are written synchronously.
+    static void Close();
 
-private:
-    Logger() = default;
-    ~Logger() = default;
+    // Per call-site limiter used by the LOG_* macros: lets a burst through, then
+    // one message per interval; the dropped repeats are reported with the next one
+    class RateLimit {
+    public:
+        static constexpr uint32_t burst = 5;
+        static constexpr int64_t interval_ms = 1000;
 
-    static Logger& instance() {
-        static Logger instance;
-        return instance;
-    }
+        [[nodiscard]] bool Allow(uint32_t& suppressed);
 
-    std::ofstream log_file_;
+    private:
+        std::atomic<int64_t> window_start_{ 0 };
+        std::atomic<uint32_t> in_window_{ 0 };
+        std::atomic<uint32_t> suppressed_{ 0 };
+    };
+
+private:
+    Logger() = delete;
 };
+
+#define BILLIARDS_LOG(category, level, message)                                                                 \
+    do {                                                                                                        \
+        if constexpr (Logger::IsCompiledIn(Logger::Category::category, Logger::LogLevel::level)) {              \
+            if (Logger::IsEnabled(Logger::Category::category, Logger::LogLevel::level)) {                       \
+                static Logger::RateLimit log_rate_limit_;                                                       \
+                if (uint32_t log_suppressed_ = 0; log_rate_limit_.Allow(log_suppressed_))                       \
+                    Logger::Write(Logger::Category::category, Logger::LogLevel::level, message, log_suppressed_); \
+            }                                                                                                   \
+        }                                                                                                       \
+    } while (false)
+
+// LOG_WARNING(Render, "...") - the message expression is only evaluated when it will be logged
+#define LOG_DEBUG(category, message)   BILLIARDS_LOG(category, DEBUG, message)
+#define LOG_INFO(category, message)    BILLIARDS_LOG(category, INFO, message)
+#define LOG_WARNING(category, message) BILLIARDS_LOG(category, WARNING, message)
+#define LOG_ERROR(category, message)   BILLIARDS_LOG(category, ERROR, message)
@@ -1,7 +1,6 @@
 ﻿#include "../precompiled.h"
 #include "App.hpp"
 #include "../objects/CueBallMap.hpp"
-#include "../objects/Table.hpp"
 
 
 // ------------------------------
@@ -11,13 +10,11 @@ namespace {
 	GLuint sceneFBO = 0, sceneColor = 0, sceneDepth = 0;
 	GLuint pingFBO[2]{ 0,0 }, pingColor[2]{ 0,0 };
 	GLuint quadVAO = 0, quadVBO = 0;
-	static GLuint guideVAO = 0, guideVBO = 0;
-	static GLuint ringVAO = 0, ringVBO = 0;
 
 	int    ppW = 0, ppH = 0;
+	int    renderW = 0, renderH = 0;   // dynamic resolution: the scene fills this corner of the ppW x ppH targets
 
 	std::shared_ptr<Shader> blurShader, screenShader;
-	static std::shared_ptr<Shader> lineShader;
 
 	// Smooth 0→1 when menu opens, 1→0 when it closes
 	static float g_menuFx = 0.0f;
@@ -94,6 +91,17 @@ namespace {
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		ppW = w; ppH = h;
+		renderW = w; renderH = h;
+	}
+
+	// Targets stay allocated at window size; a lower scale just renders into a smaller corner
+	static void setRenderScale(float scale) {
+		renderW = std::clamp(static_cast<int>(ppW * scale + 0.5f), 1, ppW);
+		renderH = std::clamp(static_cast<int>(ppH * scale + 0.5f), 1, ppH);
+	}
+
+	static glm::vec2 renderUvScale() {
+		return glm::vec2(static_cast<float>(renderW) / ppW, static_cast<float>(renderH) / ppH);
 	}
 
 	static void renderQuad() {
@@ -107,6 +115,8 @@ namespace {
 		blurShader->Bind();
 		blurShader->SetInt(0, "src");
 		blurShader->SetVec2(glm::vec2(1.f / ppW, 1.f / ppH), "texel");
+		blurShader->SetVec2(renderUvScale(), "uvScale");
+		glViewport(0, 0, renderW, renderH);
 
 		bool horizontal = true;
 		GLuint cur = inputTex;
@@ -145,138 +155,23 @@ namespace {
 		screenShader->SetFloat(gamma, "gamma");
 		screenShader->SetFloat(timeSec, "time");
 
+		// Upscale from the dynamic-resolution corner to the full window
+		const glm::vec2 uvScale = renderUvScale();
+		screenShader->SetVec2(uvScale, "uvScale");
+		screenShader->SetFloat(uvScale.x < 0.999f ? Config::upscale_sharpness : 0.0f, "upscaleSharpen");
+		glViewport(0, 0, ppW, ppH);
+
 		glDisable(GL_DEPTH_TEST);
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, tex);
 		renderQuad();
 	}
 
-	static void ensureGuideResources() {
-		if (guideVAO != 0 && ringVAO != 0 && lineShader) return;
-
-		if (guideVAO == 0) {
-			glGenVertexArrays(1, &guideVAO);
-			glGenBuffers(1, &guideVBO);
-			glBindVertexArray(guideVAO);
-			glBindBuffer(GL_ARRAY_BUFFER, guideVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6, nullptr, GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-			glEnableVertexAttribArray(0);
-			glBindVertexArray(0);
-		}
-
-		if (ringVAO == 0) { // for the hollow impact circle
-			glGenVertexArrays(1, &ringVAO);
-			glGenBuffers(1, &ringVBO);
-			glBindVertexArray(ringVAO);
-			glBindBuffer(GL_ARRAY_BUFFER, ringVBO);
-			// room for 64 verts (x,y,z)
-			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 3 * 64, nullptr, GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-			glEnableVertexAttribArray(0);
-			glBindVertexArray(0);
-		}
-
-		if (!lineShader)
-			lineShader = std::make_shared<Shader>(Config::line_vertex_path, Config::line_fragment_path);
-	}
-
-	// solve |O + tD - C|^2 = R^2  (D must be normalized)
-	static bool raySphere(const glm::vec3& O, const glm::vec3& D,
-		const glm::vec3& C, float R, float& tHit)
-	{
-		const glm::vec3 oc = O - C;
-		const float b = glm::dot(oc, D);
-		const float c = glm::dot(oc, oc) - R * R;
-		const float disc = b * b - c;
-		if (disc < 0.0f) return false;
-		const float t = -b - std::sqrt(disc);
-		if (t <= 0.0f) return false;
-		tHit = t;
-		return true;
-	}
-
-	static void drawLine3D(const glm::mat4& view, const glm::mat4& proj,
-		const glm::vec3& a, const glm::vec3& b,
-		float width, const glm::vec3& color)
-	{
-		ensureGuideResources();
-		glBindVertexArray(guideVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, guideVBO);
-		float v[6] = { a.x,a.y,a.z, b.x,b.y,b.z };
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(v), v);
-
-		lineShader->Bind();
-		glm::mat4 mvp = proj * view;
-		lineShader->SetMat4(mvp, "uMVP");
-		lineShader->SetVec3(color, "uColor");
-		glLineWidth(width);
-		glDrawArrays(GL_LINES, 0, 2);
-		glBindVertexArray(0);
-	}
-
-	// Hollow circle in XZ-plane (y fixed)
-	static void drawCircleXZ(const glm::mat4& view, const glm::mat4& proj,
-		const glm::vec3& center, float radius,
-		int segments, float width, const glm::vec3& color)
-	{
-		ensureGuideResources();
-		segments = std::min(std::max(segments, 12), 64);
-		std::vector<float> verts; verts.reserve(3 * segments);
-		for (int i = 0; i < segments; ++i) {
-			float t = (float)i / (float)segments * 2.0f * glm::pi<float>();
-			float cx = center.x + radius * std::cos(t);
-			float cz = center.z + radius * std::sin(t);
-			verts.push_back(cx);
-			verts.push_back(center.y);
-			verts.push_back(cz);
-		}
-		glBindVertexArray(ringVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, ringVBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float) * verts.size(), verts.data());
-
-		lineShader->Bind();
-		glm::mat4 mvp = proj * view;
-		lineShader->SetMat4(mvp, "uMVP");
-		lineShader->SetVec3(color, "uColor");
-		glLineWidth(width);
-		glDrawArrays(GL_LINE_LOOP, 0, segments);
-		glBindVertexArray(0);
-	}
-
-	// Clip distance so that C + t*dir stays strictly inside cushions
-	static float clipToTableXZ(const glm::vec3& C, const glm::vec3& dir,
-		float tDesired, float margin)
-	{
-		float tMax = tDesired;
-
-		if (dir.x > 0.0f)  tMax = std::min(tMax, (Table::bound_x_ - margin - C.x) / dir.x);
-		if (dir.x < 0.0f)  tMax = std::min(tMax, (-Table::bound_x_ + margin - C.x) / dir.x);
-		if (dir.z > 0.0f)  tMax = std::min(tMax, (Table::bound_z_ - margin - C.z) / dir.z);
-		if (dir.z < 0.0f)  tMax = std::min(tMax, (-Table::bound_z_ + margin - C.z) / dir.z);
-
-		return std::max(0.0f, tMax);
-	}
-
-	// Clip the ray O + t*dir against inner table bounds (XZ), keeping a margin
-	static float clipRayToTableXZ(const glm::vec3& O, const glm::vec3& dir,
-		float tDesired, float margin)
-	{
-		float tMax = tDesired;
-
-		if (dir.x > 0.0f)  tMax = std::min(tMax, (Table::bound_x_ - margin - O.x) / dir.x);
-		if (dir.x < 0.0f)  tMax = std::min(tMax, (-Table::bound_x_ + margin - O.x) / dir.x);
-		if (dir.z > 0.0f)  tMax = std::min(tMax, (Table::bound_z_ - margin - O.z) / dir.z);
-		if (dir.z < 0.0f)  tMax = std::min(tMax, (-Table::bound_z_ + margin - O.z) / dir.z);
-
-		return std::max(0.0f, tMax);
-	}
-
 } // anonymous namespace
 
 // -------------------------------------------------------------
 
-App::App() :
+App::App(LockstepOptions lockstep) :
 	window_(std::make_unique<Window>()),
 	text_renderer_(std::make_unique<TextRenderer>()),
 	menu_(std::make_unique<Menu>(window_->GetWidth(), window_->GetHeight())),
@@ -286,9 +181,13 @@ App::App() :
 	depthShader(std::make_shared<Shader>(Config::depth_vertex_path, Config::depth_fragment_path)),
 	camera_(std::make_unique<Camera>()),
 	cue_ball_map_(std::make_shared<CueBallMap>(*camera_, window_->GetGLFWWindow())),
-	lightSpaceMatrices_{}
+	lightSpaceMatrices_{},
+	lockstep_(std::move(lockstep))
 {
 	//Logger::Init("log.txt");
+	Quality::Load(Config::quality_config_path);
+	Input::Install(window_->GetGLFWWindow());
+	resolution_scaler_ = std::make_unique<ResolutionScaler>();
 	text_renderer_->Init();
 	camera_->Init();
 
@@ -320,6 +219,7 @@ void App::OnUpdate()
 	const double current_frame = glfwGetTime();
 	delta_time_ = current_frame - last_frame_;
 	last_frame_ = current_frame;
+	GlState::ResetCounters();
 
 	// Smooth step for menu animation (open/close)
 	{
@@ -328,61 +228,49 @@ void App::OnUpdate()
 		g_menuFx += (target - g_menuFx) * (1.0f - std::exp(-speed * static_cast<float>(delta_time_)));
 	}
 
+	Input::NewFrame();
 	HandleState();
+	ApplyQuality();
+
+	// GPU time of everything drawn below drives the render scale of the next frames
+	resolution_scaler_->BeginFrame();
+	setRenderScale(resolution_scaler_->Scale());
 
 	// ---------- render scene into offscreen FBO ----------
 	glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
-	glViewport(0, 0, ppW, ppH);
+	glViewport(0, 0, renderW, renderH);
 	glClearColor(0.15f, 0.15f, 0.15f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	glEnable(GL_DEPTH_TEST);
 
+	// Newest simulation state; everything below reads this instead of the live world
+	const WorldSnapshot* snapshot = nullptr;
+
 	if (world_)
 	{
 		camera_->UpdateViewMatrix(static_cast<float>(delta_time_));
-		camera_->UpdateMain(main_shader_, *world_);
+		camera_->UpdateMain(main_shader_);
 
 		environment_->Prepare();
 
-		// 1) all shadow maps
-		RenderShadowMap();
-
-		// make sure we’re back rendering into the offscreen scene FBO
-		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
-		glViewport(0, 0, ppW, ppH);
+		// 0) hand this frame's input to the simulation thread, take its latest state
+		simulation_->SubmitInput(SampleInput());
+		PostPhysicsTuning();
+		snapshot = &simulation_->LatestSnapshot();
+		world_->UpdateTransforms(*snapshot);
+		GatherLights();
 
-		// 2) bind depth maps & matrices in one go
-		main_shader_->Bind();
-		int total_lights = Config::light_count + (int)world_->GetLights().size();
-		int finalLightCount = std::min(total_lights, Config::max_shader_lights);
-		main_shader_->SetInt(finalLightCount, "lightCount");
-
-		int units[Config::max_shader_lights];
-		for (int i = 0; i < finalLightCount; ++i) {
-			glActiveTexture(GL_TEXTURE0 + 9 + i);
-			glBindTexture(GL_TEXTURE_2D, environment_->depthMap[i]);
-			units[i] = 9 + i;
-			std::string matName = "lightSpaceMatrix[" + std::to_string(i) + "]";
-			main_shader_->SetMat4(lightSpaceMatrices_[i], matName.c_str());
-		}
-		main_shader_->SetIntArray("shadowMap[0]", units, finalLightCount);
-		main_shader_->Unbind();
-
-		world_->Update(static_cast<float>(delta_time_), !in_menu_);
-		world_->Draw(main_shader_);
+		// 1) all shadow maps
+		RenderShadowMap(*snapshot, Quality::Current());
 
-		camera_->UpdateBackground(background_shader_);
-		environment_->Draw(background_shader_);
+		// 2) lit scene + skybox into the offscreen scene FBO
+		RenderScene(*snapshot, Quality::Current());
 
 		// CueBallMap visibility
 		bool isTopDownView = camera_->IsTopDownView();
-		bool ballsMoving = world_->AreBallsInMotion();
+		bool ballsMoving = snapshot->balls_in_motion;
 		bool shouldVisible = isTopDownView && !ballsMoving;
 		cue_ball_map_->SetVisible(shouldVisible);
-		if (cue_ball_map_->IsVisible()) {
-			cue_ball_map_->Draw();
-			cue_ball_map_->HandleMouseInput(window_->GetGLFWWindow());
-		}
 	}
 	glBindFramebuffer(GL_FRAMEBUFFER, 0); // backbuffer
 
@@ -394,7 +282,7 @@ void App::OnUpdate()
 
 	GLuint shown = sceneColor;
 	if (paused) {
-		shown = blurChain(sceneColor, 6); // stronger blur
+		shown = blurChain(sceneColor, Quality::Current().pause_blur_passes); // stronger blur
 		// Animated grading
 		const float v = 0.15f * g_menuFx;
 		const float ta = 0.18f * g_menuFx;                   // tint intensity
@@ -409,7 +297,7 @@ void App::OnUpdate()
 			tSec);
 	}
 	else if (firstPage) {
-		shown = blurChain(sceneColor, 4); // mild blur
+		shown = blurChain(sceneColor, Quality::Current().menu_blur_passes); // mild blur
 		const float v = 0.12f * g_menuFx;
 		const float ta = 0.18f * g_menuFx;
 		const float sat = 1.0f - 0.10f * g_menuFx;
@@ -431,83 +319,66 @@ void App::OnUpdate()
 			tSec);
 	}
 
+	// Spin selector is HUD: drawn after the upscale so it stays at native resolution
+	if (snapshot && cue_ball_map_->IsVisible()) {
+		cue_ball_map_->Draw();
+		cue_ball_map_->HandleMouseInput(window_->GetGLFWWindow());
+	}
+
 	// ---- aiming guideline overlay (optional) ----
-	if (world_ && !in_menu_ && menu_->IsGuidelineOn() && !world_->AreBallsInMotion())
+	// The simulation thread plays the lined-up shot ahead (TrajectoryPreview); this only draws it
+	if (snapshot && !in_menu_ && menu_->IsGuidelineOn() && !snapshot->balls_in_motion)
 	{
-		const auto& balls = world_->GetBalls();
-		const glm::vec3 O = balls[0]->translation_;
-		const glm::vec3 D = glm::normalize(world_->GetCue()->AimDir());  // cue-ball travel dir
-
-		// Find first object-ball hit (Minkowski radius = 2R)
-		const float R = 2.0f * Ball::radius_;
-		float bestT = std::numeric_limits<float>::max();
-		int hitIdx = -1;
-		for (int i = 1; i < (int)balls.size(); ++i) {
-			if (!balls[i]->IsDrawn()) continue;
-			float t;
-			if (raySphere(O, D, balls[i]->translation_, R, t)) {
-				if (t < bestT) { bestT = t; hitIdx = i; }
-			}
-		}
-
-		const glm::mat4 view = camera_->GetViewMatrix();
-		const glm::mat4 proj = camera_->GetProjectionMatrix();
-
-		glDisable(GL_DEPTH_TEST); // HUD-style overlay
-
-		// Clip the white line so it never crosses cushions
-		const float margin = 0.025f; // keep a small distance from cushions
-		float tBound = clipRayToTableXZ(O, D, 1000.0f, margin); // "far" but clipped to table
-		float tLine = (hitIdx != -1) ? std::min(bestT, tBound) : tBound;
+		const PredictedPaths& paths = snapshot->trajectory;
 
-		glm::vec3 impact = O + D * tLine;
-		drawLine3D(view, proj, O, impact, 2.0f, glm::vec3(1.0f));
+		// Cue ball: to the contact and on, through its cushions
+		overlay_lines_.Polyline(paths.cue, glm::vec3(1.0f), 2.0f);
 
-		// Larger hollow circle at contact (only if a real hit and still inside bounds)
-		if (hitIdx != -1 && tLine > 1e-4f) {
+		if (paths.object_slot != -1) {
+			// Larger hollow circle where the cue ball meets the first object ball
 			const float ringR = Ball::radius_ * 0.60f;   // enlarged ring
-			const float eps = Ball::radius_ * 0.03f;   // pull back slightly to avoid z-fighting
-			glm::vec3 ringCenter = impact - D * eps;
-			ringCenter.y = Ball::radius_;
-			drawCircleXZ(view, proj, ringCenter, ringR, 64, 3.0f, glm::vec3(1.0f)); // more segments, thicker line
-		}
+			overlay_lines_.Circle(paths.contact, ringR, glm::vec3(1.0f), 3.0f, 64); // more segments, thicker line
 
-		// Predicted object-ball direction; color depends on legality (still clipped to table)
-		if (hitIdx != -1) {
-			const bool legalTarget = world_->IsLegalAimTarget(hitIdx);
-
-			const glm::vec3 C = balls[hitIdx]->translation_;
-			const glm::vec3 objDir = glm::normalize(C - impact);   // line-of-centers
-			const float want = 0.90f;                            // desired preview length
-			const float margin2 = 0.025f;                          // same cushion distance
-			float tClipped = clipToTableXZ(C, objDir, want, margin2);
-			if (tClipped > 1e-4f) {
-				glm::vec3 endY = C + objDir * tClipped;
-				glm::vec3 col = legalTarget ? glm::vec3(1.0f, 1.0f, 0.0f)
-					: glm::vec3(1.0f, 0.1f, 0.1f);
-				drawLine3D(view, proj, C, endY, 2.0f, col);
-			}
+			// Object ball's path; color depends on legality
+			const bool legalTarget = snapshot->legal_targets[paths.object_slot];
+			glm::vec3 col = legalTarget ? glm::vec3(1.0f, 1.0f, 0.0f)
+				: glm::vec3(1.0f, 0.1f, 0.1f);
+			overlay_lines_.Polyline(paths.object, col, 2.0f);
 		}
 	}
 
+	// ---- overlay lines: everything queued this frame, HUD-style ----
+	if (snapshot) {
+		glDisable(GL_DEPTH_TEST);
+		overlay_lines_.Flush(camera_->GetProjectionMatrix() * camera_->GetViewMatrix());
+	}
+
 	// ---- text UI pass ----
 	GLboolean depthWasEnabled = glIsEnabled(GL_DEPTH_TEST);
 	glDisable(GL_DEPTH_TEST);
 
-	if (world_) {
-		const auto& players = world_->GetPlayers();
-		const auto& current_player = players[world_->GetCurrentPlayerIndex()];
-		int curIdx = world_->GetCurrentPlayerIndex();
+	if (snapshot) {
+		const auto& players = snapshot->players;
+		const auto& current_player = players[snapshot->current_player];
+		int curIdx = snapshot->current_player;
 		const std::string& shownName = players[curIdx].GetName(); // use synced, real player name
 		menu_->AddText(0.0f, 0.95f, "Current Player: " + shownName, 0.6f);
 
 
-		float clockSec = world_->GetShotClock();
+		float clockSec = snapshot->shot_clock;
 		menu_->AddText(0.0f, 0.90f, "Shot Clock: " + std::to_string((int)clockSec), 0.6f);
 
-		const std::string msg = world_->GetMessage();
+		const std::string& msg = snapshot->message;
 		if (!msg.empty())
 			menu_->AddText(0.35f, 0.95f, msg, 0.75f);
+
+		if (show_render_stats_) {
+			// issued / requested: what the render queue's state cache let through
+			const GlState::Counters& c = GlState::GetCounters();
+			menu_->AddText(0.0f, 0.85f, std::format("Draws {}  Programs {}/{}  Textures {}/{}  VAOs {}/{}  Uniforms {}/{}",
+				c.draws, c.programs, c.program_requests, c.textures, c.texture_requests,
+				c.vertex_arrays, c.vertex_array_requests, c.uniforms, c.uniform_requests), 0.45f);
+		}
 	}
 
 	if (in_menu_)
@@ -518,6 +389,9 @@ void App::OnUpdate()
 	text_renderer_->Render(menu_->GetTexts());
 	glDisable(GL_BLEND);
 
+	// Before the menu handling below: Load() may run the calibration, which times its own passes
+	resolution_scaler_->EndFrame();
+
 	// ------------------------------
 	// Handle menu clicks (missing before)
 	// ------------------------------
@@ -529,16 +403,20 @@ void App::OnUpdate()
 			if (!world_) {
 				Load();
 				has_started_ = true;            // mark game as started
-				world_->ResetPlayerIndex();
-				world_->UpdatePlayerNames(menu_->P1Name(), menu_->P2Name());
+				simulation_->Post([p1 = menu_->P1Name(), p2 = menu_->P2Name()](World& world) {
+					world.ResetPlayerIndex();
+					world.UpdatePlayerNames(p1, p2);
+				});
 				last_frame_ = glfwGetTime();
 			}
 		}
 		// Reset
 		if (menu_->ConsumeResetClicked() && world_) {
-			world_->Reset();
-			world_->ResetGame();
-			world_->UpdatePlayerNames(menu_->P1Name(), menu_->P2Name()); // update names on reset
+			simulation_->Post([p1 = menu_->P1Name(), p2 = menu_->P2Name()](World& world) {
+				world.Reset();
+				world.ResetGame();
+				world.UpdatePlayerNames(p1, p2); // update names on reset
+			});
 		}
 		// Exit
 		if (menu_->ConsumeExitClicked()) {
@@ -550,25 +428,16 @@ void App::OnUpdate()
 	if (world_) {
 		std::string n1, n2;
 		if (menu_->ConsumeEditedNames(n1, n2)) {
-			world_->UpdatePlayerNames(n1, n2);
+			simulation_->Post([n1, n2](World& world) { world.UpdatePlayerNames(n1, n2); });
 		}
 	}
 
 	if (depthWasEnabled) glEnable(GL_DEPTH_TEST);
 
 	// light toggles 0..9
-	static bool key_was_pressed[10] = { false };
-	GLFWwindow* w = window_->GetGLFWWindow();
 	for (int key = GLFW_KEY_0; key <= GLFW_KEY_9; ++key) {
-		int lightIndex = key - GLFW_KEY_0;
-		bool isPressed = (glfwGetKey(w, key) == GLFW_PRESS);
-		if (isPressed && !key_was_pressed[lightIndex]) {
-			if (world_) world_->ToggleLight(lightIndex);
-			key_was_pressed[lightIndex] = true;
-		}
-		else if (!isPressed && key_was_pressed[lightIndex]) {
-			key_was_pressed[lightIndex] = false;
-		}
+		if (Input::WasPressed(key) && world_)
+			world_->ToggleLight(key - GLFW_KEY_0);
 	}
 }
 
@@ -598,13 +467,28 @@ void App::OnResize() const
 
 void App::Load()
 {
-	world_ = std::make_unique<World>(cue_ball_map_, *camera_);
-	environment_ = std::make_unique<Environment>();
+	// HDR decode + SH projection run on the pool while the models load
+	auto environment_source = Environment::LoadAsync();
+	world_ = std::make_unique<World>();
+	environment_ = std::make_unique<Environment>(environment_source.get());
+	quality_revision_ = Quality::Revision();
 	menu_->InstallCharCallback(window_->GetGLFWWindow());
 
 	camera_->Init();
 	world_->Init();
 
+	try
+	{
+		world_->OpenSession(lockstep_);
+	}
+	catch (const std::exception& e)
+	{
+		LOG_ERROR(General, std::string("Lockstep: ") + e.what() + ", playing locally");
+	}
+
+	simulation_ = std::make_unique<Simulation>(*world_);
+	simulation_->Start();
+
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LESS);
 	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
@@ -621,9 +505,116 @@ void App::Load()
 	main_shader_->SetInt(7, "material.aoMap");
 	main_shader_->SetInt(8, "material.metallicMap");
 	main_shader_->Unbind();
+
+	if (Calibration::IsNeeded())
+		CalibrateQuality();
+}
+
+void App::CalibrateQuality()
+{
+	// The opening table from the default camera: the same draws the first frames will make
+	const WorldSnapshot& snapshot = simulation_->LatestSnapshot();
+	camera_->UpdateViewMatrix(0.0f);
+	camera_->UpdateMain(main_shader_);
+	environment_->Prepare();
+	world_->UpdateTransforms(snapshot);
+	GatherLights();
+
+	Calibration::Passes passes;
+	passes.shadow = [&](const QualitySettings& quality) {
+		// time every layer, as on a frame where all lights changed
+		environment_->ResizeShadowMaps(quality.shadow_size);
+		shadow_scheduler_.Invalidate();
+		RenderShadowMap(snapshot, quality);
+	};
+	passes.scene = [&](const QualitySettings& quality) {
+		glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		RenderScene(snapshot, quality);
+	};
+	passes.blur = [&](const QualitySettings& quality) {
+		blurChain(sceneColor, quality.pause_blur_passes);
+	};
+	Calibration::Run(passes);
+
+	// Size everything for the pick now instead of on the first frame
+	environment_->Reallocate(Quality::Current());
+	shadow_scheduler_.Invalidate();
+	quality_revision_ = Quality::Revision();
+	Quality::Save(Config::quality_config_path);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void App::GatherLights()
+{
+	frame_lights_.clear();
+
+	// 1) Virtual lights
+	for (int i = 0; i < Config::light_count; ++i) {
+		const float lx = (i % 2) ? 2.0f * i : -2.0f * i;
+		frame_lights_.push_back({ glm::vec3(lx, 2.0f, 0.0f), Config::virtual_light_radius, glm::vec3(20.0f) });
+	}
+
+	// 2) Physical lights that are switched on
+	for (const auto& light : world_->GetLights()) {
+		if (light->IsOn())
+			frame_lights_.push_back({ light->GetPosition(), light->GetRadius(), light->GetColor() });
+	}
+
+	// Shadow map layers go to the first lights that reach the table; the others could only
+	// shadow the room around it. RenderShadowMap / shadowCount apply the tier's budget
+	const BoundingSphere& table = world_->GetTableBounds();
+	int layer = 0;
+	for (PointLight& light : frame_lights_) {
+		if (layer == Config::max_shadow_maps)
+			break;
+		if (table.Intersects({ light.position, light.radius }))
+			light.shadow_layer = layer++;
+	}
+
+	if (Input::IsDown(GLFW_KEY_LEFT_SHIFT)) {
+		// example: treat the camera as a dynamic (unshadowed) light
+		frame_lights_.push_back({ camera_->GetPosition(), Config::virtual_light_radius, glm::vec3(10.0f) });
+	}
+}
+
+void App::RenderScene(const WorldSnapshot& snapshot, const QualitySettings& quality)
+{
+	// make sure we’re back rendering into the offscreen scene FBO
+	glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+	glViewport(0, 0, renderW, renderH);
+
+	// bin this frame's lights into the view's froxels (SSBOs at Config::*_binding)
+	light_clusters_.Build(frame_lights_, camera_->GetViewMatrix(), camera_->GetProjectionMatrix());
+
+	// bind the shadow map array & matrices in one go
+	const int shadowCount = std::min(quality.shadowed_lights, Config::max_shadow_maps);
+	main_shader_->Bind();
+	main_shader_->SetVec2(glm::vec2(renderW, renderH), "clusterScreenSize");
+	main_shader_->SetInt(shadowCount, "shadowCount");
+	main_shader_->SetInt(quality.pcf_radius, "pcfRadius");
+
+	main_shader_->SetBool(Config::sh_irradiance, "useShIrradiance");
+	const IrradianceSH& sh = environment_->GetIrradianceSH();
+	for (int i = 0; i < static_cast<int>(sh.coefficients.size()); ++i)
+		main_shader_->SetVec3(sh.coefficients[i], "shIrradiance[" + std::to_string(i) + "]");
+
+	glActiveTexture(GL_TEXTURE9);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, environment_->depthMapArray);
+	main_shader_->SetInt(9, "shadowMaps");
+	for (int i = 0; i < shadowCount; ++i) {
+		std::string matName = "lightSpaceMatrix[" + std::to_string(i) + "]";
+		main_shader_->SetMat4(lightSpaceMatrices_[i], matName.c_str());
+	}
+	main_shader_->Unbind();
+
+	world_->Draw(main_shader_, snapshot);
+
+	camera_->UpdateBackground(background_shader_);
+	environment_->Draw(background_shader_);
 }
 
-void App::RenderShadowMap()
+void App::RenderShadowMap(const WorldSnapshot& snapshot, const QualitySettings& quality)
 {
 	// --- save current framebuffer & viewport (so we can restore them) ---
 	GLint prevFBO = 0; glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFBO);
@@ -633,40 +624,38 @@ void App::RenderShadowMap()
 	const float S = Config::shadow_extent;
 	glm::mat4 lightProjection = glm::ortho(-S, S, -S, S, Config::near_plane, Config::far_plane);
 
-	const auto& physicalLights = world_->GetLights();
-	const int total_lights = Config::light_count + static_cast<int>(physicalLights.size());
-	const int finalLightCount = std::min(total_lights, Config::max_shader_lights);
-
-	for (int i = 0; i < finalLightCount; ++i)
+	shadow_requests_.clear();
+	for (const PointLight& light : frame_lights_)
 	{
-		glm::vec3 lightPos;
-		bool isOn = true;
+		// Lights past the tier's shadow budget are shaded unshadowed (see shadowCount)
+		const int layer = light.shadow_layer;
+		if (layer < 0 || layer >= quality.shadowed_lights) continue;
 
-		if (i < Config::light_count) {
-			const float light_position_x = (i % 2) ? 2.0f * i : -2.0f * i;
-			lightPos = glm::vec3(light_position_x, 2.0f, 0.0f);
-		}
-		else {
-			const int physicalIndex = i - Config::light_count;
-			if (physicalIndex >= static_cast<int>(physicalLights.size())) break;
-			auto& l = physicalLights[physicalIndex];
-			lightPos = l->GetPosition();
-			isOn = l->IsOn();
-		}
-		if (!isOn) continue;
+		glm::mat4 lightView = glm::lookAt(light.position, glm::vec3(0.0f), glm::vec3(0, 1, 0));
+		lightSpaceMatrices_[layer] = lightProjection * lightView;
 
-		glm::mat4 lightView = glm::lookAt(lightPos, glm::vec3(0.0f), glm::vec3(0, 1, 0));
-		glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-		lightSpaceMatrices_[i] = lightSpaceMatrix;
+		// How much of the light the camera gets: brightness under the same windowed falloff as the shader
+		const float d = glm::distance(light.position, camera_->GetPosition());
+		const float window = glm::clamp(1.0f - std::pow(d / light.radius, 4.0f), 0.0f, 1.0f);
+		const float luminance = glm::dot(light.color, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+		const float importance = luminance * window * window / std::max(d * d, 1.0f);
+
+		shadow_requests_.push_back({ layer, importance, light.position, lightSpaceMatrices_[layer] });
+	}
+
+	// Distant / dim lights keep last frame's map unless the scheduler picks them
+	for (const size_t index : shadow_scheduler_.Schedule(shadow_requests_))
+	{
+		const ShadowScheduler::Request& request = shadow_requests_[index];
 
 		depthShader->Bind();
-		depthShader->SetMat4(lightSpaceMatrix, "lightSpaceMatrix");
+		depthShader->SetMat4(request.light_space, "lightSpaceMatrix");
 
-		glViewport(0, 0, Config::shadow_width, Config::shadow_height);
-		glBindFramebuffer(GL_FRAMEBUFFER, environment_->depthMapFBO[i]);
+		glViewport(0, 0, environment_->GetShadowSize(), environment_->GetShadowSize());
+		glBindFramebuffer(GL_FRAMEBUFFER, environment_->depthMapFBO[request.layer]);
 		glClear(GL_DEPTH_BUFFER_BIT);
 
-		world_->Draw(depthShader);
+		world_->DrawShadowCasters(depthShader, snapshot, Frustum(request.light_space), request.light_position);
 	}
 
 	// --- restore framebuffer & viewport exactly as they were ---
@@ -675,14 +664,70 @@ void App::RenderShadowMap()
 }
 
 
+void App::ApplyQuality()
+{
+	// Tier switched from the settings modal: resize render targets before this frame uses them
+	if (!environment_ || quality_revision_ == Quality::Revision())
+		return;
+
+	environment_->Reallocate(Quality::Current());
+	shadow_scheduler_.Invalidate();
+	quality_revision_ = Quality::Revision();
+	Quality::Save(Config::quality_config_path);
+	LOG_INFO(Render, std::string("Quality set to ") + Quality::Name(Quality::Tier()));
+}
+
+SimulationInput App::SampleInput() const
+{
+	// Buttons reach the simulation as timestamped events (Input); only continuous state goes here
+	SimulationInput input;
+	input.in_game = !in_menu_;
+	input.spin = cue_ball_map_ ? cue_ball_map_->GetSpin() : glm::vec2(0.0f);
+	input.strike_force = Config::power_coeff;
+	input.guideline = menu_->IsGuidelineOn();
+
+	const glm::dvec2 cursor = Input::Cursor();
+	int screen_w, screen_h; glfwGetWindowSize(window_->GetGLFWWindow(), &screen_w, &screen_h);
+	std::tie(input.mouse_ray_origin, input.mouse_ray_dir) =
+		camera_->GetMouseRay(static_cast<float>(cursor.x), static_cast<float>(cursor.y), screen_w, screen_h);
+
+	return input;
+}
+
+void App::PostPhysicsTuning()
+{
+	const PhysicsParams tuning{};
+	if (tuning == physics_tuning_)
+		return;
+	physics_tuning_ = tuning;
+	simulation_->Post([tuning](World& world) { world.SetPhysicsTuning(tuning); });
+}
+
 void App::HandleState()
 {
 	GLFWwindow* window = window_->GetGLFWWindow();
 
-	// --- Edge-trigger for ESC ---
-	static int prevEsc = GLFW_RELEASE;
-	const int escNow = glfwGetKey(window, GLFW_KEY_ESCAPE);
-	const bool escPressed = (escNow == GLFW_PRESS && prevEsc == GLFW_RELEASE);
+	// F9: start/stop recording input, F10: replay the last recording
+	if (Input::WasPressed(GLFW_KEY_F9)) {
+		if (Input::IsRecording()) Input::StopRecording();
+		else Input::StartRecording(Config::input_recording_path);
+	}
+	if (Input::WasPressed(GLFW_KEY_F10) && !Input::IsRecording())
+		Input::StartReplay(Config::input_recording_path);
+
+	// F5: retake the last shot, F6: restore the autosave
+	if (simulation_ && !in_menu_) {
+		if (Input::WasPressed(GLFW_KEY_F5))
+			simulation_->Post([](World& world) { world.RetakeShot(); });
+		if (Input::WasPressed(GLFW_KEY_F6))
+			simulation_->Post([](World& world) { world.LoadAutosave(); });
+	}
+
+	// F3: render queue / state cache counters
+	if (Input::WasPressed(GLFW_KEY_F3))
+		show_render_stats_ = !show_render_stats_;
+
+	const bool escPressed = Input::WasPressed(GLFW_KEY_ESCAPE);
 
 	// Ask the menu whether any modal is open (settings/help)
 	bool modalOpen = false;
@@ -695,7 +740,6 @@ void App::HandleState()
 		if (escPressed) {
 			in_menu_ = true;
 			glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-			prevEsc = escNow;
 			return;
 		}
 	}
@@ -703,7 +747,6 @@ void App::HandleState()
 	else {
 		if (!has_started_ && escPressed && !modalOpen) {
 			window_->SetCloseFlag();
-			prevEsc = escNow;
 			return;
 		}
 		// Note: when a modal is open, ESC is handled inside Menu.cpp to close it.
@@ -711,10 +754,7 @@ void App::HandleState()
 
 	// 3) Only handle camera toggle when NOT in menu
 	if (!in_menu_) {
-		static int last_mouse_button_state = GLFW_RELEASE;
-		const int mouse_button_state = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
-
-		if (mouse_button_state == GLFW_PRESS && last_mouse_button_state == GLFW_RELEASE) {
+		if (Input::WasMousePressed(GLFW_MOUSE_BUTTON_LEFT)) {
 			const bool cueMapVisible = (cue_ball_map_ && cue_ball_map_->IsVisible());
 			const bool cueMapHit = (cue_ball_map_ && cue_ball_map_->IsWithinBounds());
 
@@ -729,9 +769,5 @@ void App::HandleState()
 				);
 			}
 		}
-
-		last_mouse_button_state = mouse_button_state;
 	}
-
-	prevEsc = escNow;
 }
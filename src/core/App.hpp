@@ -1,9 +1,18 @@
 #pragma once
 #include "../precompiled.h"
 #include "../core/World.hpp"
+#include "../core/Simulation.hpp"
 #include "../core/Environment.hpp"
+#include "../core/Quality.hpp"
+#include "../core/Calibration.hpp"
+#include "../core/ResolutionScaler.hpp"
+#include "../core/LightClusters.hpp"
+#include "../core/ShadowScheduler.hpp"
+#include "../core/GlState.hpp"
+#include "../core/LineBatch.hpp"
 #include "../interface/Camera.hpp"
 #include "../interface/Window.hpp"
+#include "../interface/Input.hpp"
 #include "../interface/TextRenderer.hpp"
 #include "../objects/CueBallMap.hpp"
 #include "Logger.hpp"
@@ -11,7 +20,7 @@
 class App
 {
 public:
-	App();
+	explicit App(LockstepOptions lockstep = {});
 	~App();
 
 	App(const App&) = delete;
@@ -25,15 +34,25 @@ private:
 	void OnUpdate();
 	void OnResize() const;
 	void Load();
-	void RenderShadowMap();
+	void RenderShadowMap(const WorldSnapshot& snapshot, const QualitySettings& quality);
+	void RenderScene(const WorldSnapshot& snapshot, const QualitySettings& quality);
+	void GatherLights();
+	void CalibrateQuality();
 	void HandleState();
+	void ApplyQuality();
+	[[nodiscard]] SimulationInput SampleInput() const;
+	// The quick setup menu edits the ball model in Config on this thread; a change goes
+	// to the simulation as a command, never read there
+	void PostPhysicsTuning();
 
 	std::unique_ptr<Window> window_ = nullptr;
 	std::unique_ptr<Camera> camera_ = nullptr;
 	std::unique_ptr<World> world_ = nullptr;
+	std::unique_ptr<Simulation> simulation_ = nullptr;     // declared after world_: stops before it is destroyed
 	std::unique_ptr<Environment> environment_ = nullptr;
 	std::unique_ptr<TextRenderer> text_renderer_ = nullptr;
 	std::unique_ptr<Menu> menu_ = nullptr;
+	std::unique_ptr<ResolutionScaler> resolution_scaler_ = nullptr;
 	std::array<std::unique_ptr<Light>, 10> lights_;
 	std::array<bool, 10> lightOn_{ true, true, true, true, true, true, true, true, true, true };
 	std::shared_ptr<Shader> main_shader_ = nullptr;
@@ -46,9 +65,25 @@ private:
 	// Add depth shader
 	std::shared_ptr<Shader> depthShader = nullptr;
 
-	// For each of the up to 14 lights
-	std::array<glm::mat4, Config::max_shader_lights> lightSpaceMatrices_;
+	// Lights of the current frame (virtual + switched-on physical), shared by the shadow and lit passes
+	std::vector<PointLight> frame_lights_;
+	LightClusters light_clusters_;
 
+	// One per shadow map layer
+	std::array<glm::mat4, Config::max_shadow_maps> lightSpaceMatrices_;
+	ShadowScheduler shadow_scheduler_;
+	std::vector<ShadowScheduler::Request> shadow_requests_;
+
+	// Aiming guide and debug lines, queued during the frame and drawn in one go
+	LineBatch overlay_lines_;
+
+	PhysicsParams physics_tuning_{};   // last sent by PostPhysicsTuning
+
+	unsigned quality_revision_ = 0;   // Quality::Revision() the render targets were sized for
+
+	LockstepOptions lockstep_{};       // --host / --join: the match is played against a peer
+
+	bool show_render_stats_ = false;   // F3: GlState counters on the HUD
 	bool in_menu_{ true };
 	bool has_started_ = false;
 	double delta_time_ = 0.0f;
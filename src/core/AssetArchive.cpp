@@ -0,0 +1,146 @@
+#include "../headless.h"
+#include "AssetArchive.hpp"
+
+#include <cstring>
+
+namespace {
+	constexpr uint64_t kAlignment = 16;
+
+	uint64_t alignUp(const uint64_t value) {
+		return (value + kAlignment - 1) & ~(kAlignment - 1);
+	}
+}
+
+namespace AssetArchive
+{
+
+// ============================================================================
+// Writer
+// ============================================================================
+void Writer::Add(const std::string& path, std::vector<uint8_t> bytes)
+{
+	files_[path] = std::move(bytes);
+}
+
+bool Writer::Write(const std::filesystem::path& archive_path) const
+{
+	std::vector<Entry> entries;
+	std::vector<char> paths;
+	entries.reserve(files_.size());
+
+	for (const auto& [path, bytes] : files_)
+	{
+		Entry e{};
+		e.path_offset = static_cast<uint32_t>(paths.size());
+		e.path_length = static_cast<uint32_t>(path.size());
+		e.size = bytes.size();
+		paths.insert(paths.end(), path.begin(), path.end());
+		entries.push_back(e);
+	}
+
+	Header header{};
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.entry_count = static_cast<uint32_t>(entries.size());
+	header.path_bytes = static_cast<uint32_t>(paths.size());
+	header.entries_offset = alignUp(sizeof(Header));
+	header.paths_offset = header.entries_offset + entries.size() * sizeof(Entry);
+
+	uint64_t cursor = alignUp(header.paths_offset + paths.size());
+	for (auto& e : entries)
+	{
+		e.data_offset = cursor;
+		cursor = alignUp(cursor + e.size);
+	}
+
+	// Write to a temp file first so a failed pack never replaces a good archive
+	auto tmp_path = archive_path;
+	tmp_path += ".tmp";
+
+	{
+		std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out)
+			return false;
+
+		auto write = [&](uint64_t offset, const void* data, size_t bytes) {
+			static constexpr char zeros[kAlignment]{};
+			const auto pos = static_cast<uint64_t>(out.tellp());
+			if (offset > pos) out.write(zeros, static_cast<std::streamsize>(offset - pos));
+			if (bytes) out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+		};
+
+		write(0, &header, sizeof(header));
+		write(header.entries_offset, entries.data(), entries.size() * sizeof(Entry));
+		write(header.paths_offset, paths.data(), paths.size());
+
+		size_t i = 0;
+		for (const auto& [path, bytes] : files_)
+		{
+			write(entries[i].data_offset, bytes.data(), bytes.size());
+			++i;
+		}
+
+		if (!out)
+			return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmp_path, archive_path, ec);
+	if (ec) {
+		std::filesystem::remove(tmp_path, ec);
+		return false;
+	}
+	return true;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+Reader::Reader(const std::filesystem::path& archive_path) : file_(archive_path)
+{
+	if (!file_.IsOpen() || file_.Size() < sizeof(Header))
+		return;
+
+	const auto* header = reinterpret_cast<const Header*>(file_.Data());
+	if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version)
+		return;
+
+	const auto fits = [&](uint64_t offset, uint64_t bytes) { return offset + bytes <= file_.Size(); };
+	if (!fits(header->entries_offset, uint64_t(header->entry_count) * sizeof(Entry))
+		|| !fits(header->paths_offset, header->path_bytes))
+		return;
+
+	const auto* entries = reinterpret_cast<const Entry*>(file_.Data() + header->entries_offset);
+	for (uint32_t i = 0; i < header->entry_count; ++i)
+	{
+		if (uint64_t(entries[i].path_offset) + entries[i].path_length > header->path_bytes
+			|| !fits(entries[i].data_offset, entries[i].size))
+			return;
+	}
+
+	header_ = header;
+	entries_ = entries;
+}
+
+std::string_view Reader::PathOf(const Entry& entry) const
+{
+	const char* base = reinterpret_cast<const char*>(file_.Data() + header_->paths_offset);
+	return { base + entry.path_offset, entry.path_length };
+}
+
+std::optional<std::span<const unsigned char>> Reader::Find(const std::string_view path) const
+{
+	if (!header_)
+		return std::nullopt;
+
+	const auto* end = entries_ + header_->entry_count;
+	const auto* it = std::lower_bound(entries_, end, path,
+		[this](const Entry& e, const std::string_view p) { return PathOf(e) < p; });
+
+	if (it == end || PathOf(*it) != path)
+		return std::nullopt;
+
+	return std::span<const unsigned char>(file_.Data() + it->data_offset, static_cast<size_t>(it->size));
+}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "../headless.h"
+#include "MappedFile.hpp"
+
+#include <optional>
+#include <span>
+
+// Single-file asset archive (assets.pak) produced by the AssetPacker tool.
+//
+// Layout (little-endian):
+//   Header | Entry[] sorted by path | path bytes | data blobs (16-byte aligned)
+// Paths are the install-relative, '/'-separated paths of the loose files
+// ("assets/textures/ball0.jpg", "src/shaders/shader.vertexshader"), so an
+// archive and a loose install are interchangeable.
+namespace AssetArchive
+{
+	inline constexpr char magic[4] = { '8', 'B', 'P', 'K' };
+	inline constexpr uint32_t version = 1;
+	inline constexpr const char* const file_name = "assets.pak";
+
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t entry_count;
+		uint32_t path_bytes;
+		uint64_t entries_offset;
+		uint64_t paths_offset;
+	};
+
+	struct Entry
+	{
+		uint32_t path_offset;                       // into the path bytes
+		uint32_t path_length;
+		uint64_t data_offset;                       // from the start of the file
+		uint64_t size;
+	};
+
+	static_assert(std::is_trivially_copyable_v<Header>);
+	static_assert(std::is_trivially_copyable_v<Entry>);
+
+	// Collects files in memory and serializes them in one go (tool side)
+	class Writer
+	{
+	public:
+		void Add(const std::string& path, std::vector<uint8_t> bytes);
+		[[nodiscard]] size_t Count() const { return files_.size(); }
+
+		// Returns false if the file cannot be written
+		bool Write(const std::filesystem::path& archive_path) const;
+
+	private:
+		std::map<std::string, std::vector<uint8_t>> files_;    // ordered: entries come out sorted
+	};
+
+	// Read-only mapped archive; lookups are a binary search over the entry table
+	class Reader
+	{
+	public:
+		// Maps 'archive_path'; IsValid() is false if missing, truncated or a different version
+		explicit Reader(const std::filesystem::path& archive_path);
+
+		[[nodiscard]] bool IsValid() const { return header_ != nullptr; }
+		[[nodiscard]] uint32_t Count() const { return header_ ? header_->entry_count : 0; }
+
+		// Zero-copy view of a file's bytes, or nullopt if it isn't packed
+		[[nodiscard]] std::optional<std::span<const unsigned char>> Find(std::string_view path) const;
+
+	private:
+		[[nodiscard]] std::string_view PathOf(const Entry& entry) const;
+
+		MappedFile file_;
+		const Header* header_ = nullptr;
+		const Entry* entries_ = nullptr;
+	};
+}
@@ -0,0 +1,38 @@
+#include "../precompiled.h"
+#include "Bounds.hpp"
+
+BoundingSphere BoundingSphere::FromBox(const glm::vec3& min, const glm::vec3& max, const glm::mat4& model)
+{
+	const float max_scale = std::sqrt(std::max({
+		glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+		glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+		glm::dot(glm::vec3(model[2]), glm::vec3(model[2])) }));
+
+	BoundingSphere sphere;
+	sphere.center = glm::vec3(model * glm::vec4((min + max) * 0.5f, 1.0f));
+	sphere.radius = glm::length((max - min) * 0.5f) * max_scale;
+	return sphere;
+}
+
+Frustum::Frustum(const glm::mat4& view_projection)
+{
+	// glm is column-major: row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+	const glm::mat4 m = glm::transpose(view_projection);
+	planes_[0] = m[3] + m[0];   // left
+	planes_[1] = m[3] - m[0];   // right
+	planes_[2] = m[3] + m[1];   // bottom
+	planes_[3] = m[3] - m[1];   // top
+	planes_[4] = m[3] + m[2];   // near
+	planes_[5] = m[3] - m[2];   // far
+
+	for (glm::vec4& plane : planes_)
+		plane /= glm::length(glm::vec3(plane));
+}
+
+bool Frustum::Intersects(const BoundingSphere& sphere) const
+{
+	for (const glm::vec4& plane : planes_)
+		if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+			return false;
+	return true;
+}
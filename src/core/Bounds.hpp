@@ -0,0 +1,29 @@
+#pragma once
+#include "../precompiled.h"
+
+struct BoundingSphere
+{
+	glm::vec3 center{ 0.0f };
+	float radius = 0.0f;
+
+	[[nodiscard]] bool Contains(const glm::vec3& point) const { return glm::distance(center, point) <= radius; }
+	[[nodiscard]] bool Intersects(const BoundingSphere& other) const
+	{
+		return glm::distance(center, other.center) <= radius + other.radius;
+	}
+
+	// Sphere around a model-space box, carried through 'model' (conservative under non-uniform scale)
+	static BoundingSphere FromBox(const glm::vec3& min, const glm::vec3& max, const glm::mat4& model);
+};
+
+// The six clip planes of a view-projection matrix (Gribb/Hartmann), normals pointing inward
+class Frustum final
+{
+public:
+	explicit Frustum(const glm::mat4& view_projection);
+
+	[[nodiscard]] bool Intersects(const BoundingSphere& sphere) const;
+
+private:
+	std::array<glm::vec4, 6> planes_{};
+};
@@ -0,0 +1,79 @@
+#include "../precompiled.h"
+#include "Calibration.hpp"
+#include "../Logger.hpp"
+
+std::string Calibration::DeviceId()
+{
+	auto text = [](const GLenum name) {
+		const auto* s = reinterpret_cast<const char*>(glGetString(name));
+		return std::string(s ? s : "?");
+	};
+	// Stored in quality.cfg, where '#' would start a comment
+	std::string id = text(GL_RENDERER) + " | " + text(GL_VERSION);
+	std::replace(id.begin(), id.end(), '#', ' ');
+	return id;
+}
+
+bool Calibration::IsNeeded()
+{
+	return Quality::CalibratedDevice() != DeviceId();
+}
+
+QualityTier Calibration::Run(const Passes& passes)
+{
+	const double start = glfwGetTime();
+	QualityTier pick = QualityTier::Low;
+
+	// Every knob grows from one tier to the next, so the first tier over budget ends the search
+	for (int t = 0; t < static_cast<int>(QualityTier::Count); ++t)
+	{
+		const QualityTier tier = static_cast<QualityTier>(t);
+		const QualitySettings& settings = Quality::Preset(tier);
+
+		PassTimes times;
+		times.shadow_ms = TimePass([&] { passes.shadow(settings); });
+		times.scene_ms = TimePass([&] { passes.scene(settings); });
+		times.blur_ms = TimePass([&] { passes.blur(settings); });
+
+		LOG_INFO(Render, std::format("Calibration {}: shadow {:.2f} ms, scene {:.2f} ms, blur {:.2f} ms",
+			Quality::Name(tier), times.shadow_ms, times.scene_ms, times.blur_ms));
+
+		if (times.Total() > Config::calibration_budget_ms)
+			break;
+		pick = tier;
+	}
+
+	Quality::SetCalibratedDevice(DeviceId());
+	Quality::SetTier(pick);
+	LOG_INFO(Render, std::format("Calibrated for {} in {:.0f} ms: {} quality",
+		DeviceId(), (glfwGetTime() - start) * 1000.0, Quality::Name(pick)));
+	return pick;
+}
+
+double Calibration::TimePass(const std::function<void()>& pass)
+{
+	// One untimed run so shader compilation and first-touch allocation don't count
+	pass();
+
+	std::array<GLuint, Config::calibration_frames> queries{};
+	glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+	for (const GLuint query : queries)
+	{
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		pass();
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+
+	std::array<double, Config::calibration_frames> samples{};
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		GLuint64 ns = 0;
+		glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+		samples[i] = static_cast<double>(ns) * 1e-6;
+	}
+	glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+
+	// Median: one descheduled run should not decide the tier
+	std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+	return samples[samples.size() / 2];
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "../precompiled.h"
+#include "Quality.hpp"
+
+// First-launch GPU micro-benchmark. App hands over its real frame passes; each is
+// rendered offscreen at every tier's settings and timed with GL timer queries, and
+// the richest tier whose frame fits Config::calibration_budget_ms is selected.
+class Calibration final
+{
+public:
+	Calibration() = delete;
+
+	struct PassTimes
+	{
+		double shadow_ms = 0.0;
+		double scene_ms = 0.0;
+		double blur_ms = 0.0;
+
+		[[nodiscard]] double Total() const { return shadow_ms + scene_ms + blur_ms; }
+	};
+
+	// One frame's worth of work at the given settings
+	struct Passes
+	{
+		std::function<void(const QualitySettings&)> shadow;
+		std::function<void(const QualitySettings&)> scene;
+		std::function<void(const QualitySettings&)> blur;
+	};
+
+	// Renderer and version strings of the current context (the version carries the driver build)
+	[[nodiscard]] static std::string DeviceId();
+
+	// True when the saved quality was not calibrated on this GPU/driver
+	[[nodiscard]] static bool IsNeeded();
+
+	// Times the tiers from Low upward (stopping at the first over budget), then
+	// selects the pick with Quality::SetTier and records the device it was made on
+	static QualityTier Run(const Passes& passes);
+
+private:
+	[[nodiscard]] static double TimePass(const std::function<void()>& pass);
+};
@@ -1,8 +1,28 @@
 #include "../precompiled.h"
 #include "Environment.hpp"
 #include "../core/Loader.hpp"
+#include "../core/Quality.hpp"
+#include "../core/ThreadPool.hpp"
 
-Environment::Environment() : fbo_{}, rbo_{},
+std::future<EnvironmentSource> Environment::LoadAsync()
+{
+    return ThreadPool::Shared().Submit([] {
+        const double start = glfwGetTime();
+
+        EnvironmentSource source;
+        source.hdr = Loader::LoadEnvironment(Config::hdr_path);
+        const double decoded = glfwGetTime();
+
+        if (Config::sh_irradiance)
+            source.irradiance = IrradianceSH::FromEquirect(source.hdr.rgb.data(), source.hdr.width, source.hdr.height, ThreadPool::Shared());
+
+        LOG_INFO(Render, std::format("Environment {}x{}: decoded in {:.1f} ms, SH in {:.1f} ms", source.hdr.width, source.hdr.height,
+            (decoded - start) * 1000.0, (glfwGetTime() - decoded) * 1000.0));
+        return source;
+    });
+}
+
+Environment::Environment(EnvironmentSource source) : fbo_{}, rbo_{},
 cube_map_shader_(std::make_unique<Shader>(Config::cubemap_vertex_path, Config::cubemap_fragment_path)),
 brdf_shader_(std::make_unique<Shader>(Config::brdf_vertex_path, Config::brdf_fragment_path)),
 irradiance_shader_(std::make_unique<Shader>(Config::cubemap_vertex_path, Config::irradiance_fragment_path)),
@@ -13,8 +33,40 @@ prefilter_shader_(std::make_unique<Shader>(Config::cubemap_vertex_path, Config::
     CreateBuffers();
 
     // Create multiple shadow maps
+    glGenFramebuffers(Config::max_shadow_maps, depthMapFBO);
+    glGenTextures(1, &depthMapArray);
+
+    // Only the equirect texture is kept; the pixels are released with 'source'
+    hdr_texture_ = std::make_shared<Texture>(source.hdr.rgb.data(), source.hdr.width, source.hdr.height);
+    irradiance_sh_ = source.irradiance;
+
+    Reallocate(Quality::Current());
+}
+
+void Environment::Reallocate(const QualitySettings& quality)
+{
+    ResizeShadowMaps(quality.shadow_size);
+
+    if (quality.cube_map_size != cube_map_size_ || quality.irradiance_size != irradiance_size_ ||
+        quality.prefilter_size != prefilter_size_)
+    {
+        cube_map_size_ = quality.cube_map_size;
+        irradiance_size_ = quality.irradiance_size;
+        prefilter_size_ = quality.prefilter_size;
+        CreateEnvironmentMaps();
+    }
+}
+
+void Environment::ResizeShadowMaps(const int size)
+{
+    if (size == shadow_size_)
+        return;
+    shadow_size_ = size;
     CreateShadowMapsForAllLights();
+}
 
+void Environment::CreateEnvironmentMaps()
+{
     const glm::mat4 capture_projection = glm::perspective(glm::half_pi<float>(), 1.0f, Config::near_clip, Config::far_clip);
     const glm::mat4 capture_views[] =
     {
@@ -26,18 +78,27 @@ prefilter_shader_(std::make_unique<Shader>(Config::cubemap_vertex_path, Config::
         glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f, -1.0f), glm::vec3(0.0f, -1.0f,  0.0f))
     };
 
-    hdr_texture_ = Loader::LoadEnvironment(Config::hdr_path);
-    cube_map_ = std::make_unique<Texture>(Config::cube_map_size, true);
+    // Capture depth at cube map size; the irradiance/prefilter passes resize it as they go
+    glBindRenderbuffer(GL_RENDERBUFFER, rbo_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, cube_map_size_, cube_map_size_);
+
+    // Assigning over the previous maps (after a tier switch) deletes them
+    cube_map_ = std::make_unique<Texture>(cube_map_size_, true);
     RenderCubeMap(capture_projection, capture_views);
 
-    irradiance_map_ = std::make_unique<Texture>(Config::irradiance_scale, false);
-    RenderIrradianceMap(capture_projection, capture_views);
+    if (Config::sh_irradiance) {
+        irradiance_map_.reset();
+    }
+    else {
+        irradiance_map_ = std::make_unique<Texture>(irradiance_size_, false);
+        RenderIrradianceMap(capture_projection, capture_views);
+    }
 
-    prefilter_map_ = std::make_unique<Texture>(Config::prefilter_scale, true);
+    prefilter_map_ = std::make_unique<Texture>(prefilter_size_, true);
     // Ensure all mip levels exist so we can render into them
     glBindTexture(GL_TEXTURE_CUBE_MAP, prefilter_map_->GetId());
     for (unsigned mip = 0; mip < Config::max_mip_levels; ++mip) {
-        unsigned w = (unsigned)(Config::prefilter_scale * std::pow(0.5f, (float)mip));
+        unsigned w = (unsigned)(prefilter_size_ * std::pow(0.5f, (float)mip));
         unsigned h = w;
         for (unsigned face = 0; face < 6; ++face) {
             glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip,
@@ -51,14 +112,16 @@ prefilter_shader_(std::make_unique<Shader>(Config::cubemap_vertex_path, Config::
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
     RenderPrefilterMap(capture_projection, capture_views);
 
-    brdf_lut_ = std::make_unique<Texture>(nullptr, Config::cube_map_size, Config::cube_map_size);
+    brdf_lut_ = std::make_unique<Texture>(static_cast<float*>(nullptr), cube_map_size_, cube_map_size_);
     RenderBrdfLut();
 }
 
 void Environment::Prepare() const
 {
-    glActiveTexture(GL_TEXTURE1);
-    irradiance_map_->Bind();
+    if (irradiance_map_) {
+        glActiveTexture(GL_TEXTURE1);
+        irradiance_map_->Bind();
+    }
     glActiveTexture(GL_TEXTURE2);
     prefilter_map_->Bind();
     glActiveTexture(GL_TEXTURE3);
@@ -92,39 +155,38 @@ void Environment::CreateBuffers()
 
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
     glBindRenderbuffer(GL_RENDERBUFFER, rbo_);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, Config::cube_map_size, Config::cube_map_size);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo_);
 }
 
 void Environment::CreateShadowMapsForAllLights()
 {
-    glGenFramebuffers(Config::max_shader_lights, depthMapFBO);
-    glGenTextures(Config::max_shader_lights, depthMap);
-
-    // For each possible light we might have a shadow map
-    for (int i = 0; i < Config::max_shader_lights; i++)
+    // One layer per possible shadowed light. An array (rather than one texture per
+    // light) lets the shader pick the layer per fragment from the cluster light list;
+    // re-specifying the storage on resize keeps the texture and FBO names stable.
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depthMapArray);
+    glTexImage3D(
+        GL_TEXTURE_2D_ARRAY,
+        0,
+        GL_DEPTH_COMPONENT24,
+        shadow_size_,
+        shadow_size_,
+        Config::max_shadow_maps,
+        0,
+        GL_DEPTH_COMPONENT,
+        GL_FLOAT,
+        nullptr
+    );
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+    for (int i = 0; i < Config::max_shadow_maps; i++)
     {
-        glBindTexture(GL_TEXTURE_2D, depthMap[i]);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_DEPTH_COMPONENT24,
-            Config::shadow_width,
-            Config::shadow_height,
-            0,
-            GL_DEPTH_COMPONENT,
-            GL_FLOAT,
-            nullptr
-        );
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-        float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
         glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO[i]);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap[i], 0);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMapArray, 0, i);
         glDrawBuffer(GL_NONE);
         glReadBuffer(GL_NONE);
     }
@@ -207,7 +269,7 @@ void Environment::RenderCubeMap(const glm::mat4& capture_projection, const glm::
     glActiveTexture(GL_TEXTURE1);
     hdr_texture_->Bind();
 
-    glViewport(0, 0, Config::cube_map_size, Config::cube_map_size);
+    glViewport(0, 0, cube_map_size_, cube_map_size_);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
     for (unsigned int i = 0; i < 6; ++i)
     {
@@ -230,7 +292,7 @@ void Environment::RenderIrradianceMap(const glm::mat4& capture_projection, const
 {
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
     glBindRenderbuffer(GL_RENDERBUFFER, rbo_);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, Config::irradiance_scale, Config::irradiance_scale);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, irradiance_size_, irradiance_size_);
 
     irradiance_shader_->Bind();
     irradiance_shader_->SetInt(1, "environmentMap");
@@ -239,7 +301,7 @@ void Environment::RenderIrradianceMap(const glm::mat4& capture_projection, const
     glActiveTexture(GL_TEXTURE1);
     cube_map_->Bind();
 
-    glViewport(0, 0, Config::irradiance_scale, Config::irradiance_scale);
+    glViewport(0, 0, irradiance_size_, irradiance_size_);
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
 
     for (unsigned int i = 0; i < 6; ++i)
@@ -271,8 +333,8 @@ void Environment::RenderPrefilterMap(const glm::mat4& capture_projection, const
 
     for (unsigned int mip = 0; mip < Config::max_mip_levels; ++mip)
     {
-        const unsigned int mip_width = static_cast<unsigned int>(Config::prefilter_scale * std::pow(0.5, mip));
-        const unsigned int mip_height = static_cast<unsigned int>(Config::prefilter_scale * std::pow(0.5, mip));
+        const unsigned int mip_width = static_cast<unsigned int>(prefilter_size_ * std::pow(0.5, mip));
+        const unsigned int mip_height = static_cast<unsigned int>(prefilter_size_ * std::pow(0.5, mip));
 
         glBindRenderbuffer(GL_RENDERBUFFER, rbo_);
         glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mip_width, mip_height);
@@ -300,10 +362,10 @@ void Environment::RenderBrdfLut() const
 {
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
     glBindRenderbuffer(GL_RENDERBUFFER, rbo_);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, Config::cube_map_size, Config::cube_map_size);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, cube_map_size_, cube_map_size_);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, brdf_lut_->GetId(), 0);
 
-    glViewport(0, 0, Config::cube_map_size, Config::cube_map_size);
+    glViewport(0, 0, cube_map_size_, cube_map_size_);
 
     brdf_shader_->Bind();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -3,22 +3,47 @@
 #include "../core/Shader.hpp"
 #include "../core/Mesh.hpp"
 #include "../core/Texture.hpp"
+#include "../core/SphericalHarmonics.hpp"
+#include "../core/HdrDecoder.hpp"
+
+#include <future>
+
+struct QualitySettings;
+
+// CPU half of the environment: decoded HDR and its irradiance SH (no GL involved)
+struct EnvironmentSource
+{
+	HdrImage hdr;
+	IrradianceSH irradiance;
+};
 
 class Environment final
 {
 public:
-	Environment();
+	// Starts decoding Config::hdr_path (and the SH projection) on the thread pool,
+	// so it overlaps the rest of the loading; the GL side is built from the result
+	[[nodiscard]] static std::future<EnvironmentSource> LoadAsync();
+	explicit Environment(EnvironmentSource source);
 
 	void Prepare() const;
 	void Draw(const std::shared_ptr<Shader>& background_shader) const;
 
-	// For multiple shadow maps:
-	unsigned depthMapFBO[Config::max_shader_lights];
-	unsigned depthMap[Config::max_shader_lights];
+	// Resizes the shadow maps and re-renders the IBL maps when the tier changed their size
+	void Reallocate(const QualitySettings& quality);
+	void ResizeShadowMaps(int size);
+	[[nodiscard]] int GetShadowSize() const { return shadow_size_; }
+
+	// Diffuse IBL when Config::sh_irradiance (no irradiance cube map is made then)
+	[[nodiscard]] const IrradianceSH& GetIrradianceSH() const { return irradiance_sh_; }
+
+	// For multiple shadow maps: one depth array texture, one FBO per layer
+	unsigned depthMapFBO[Config::max_shadow_maps];
+	unsigned depthMapArray;
 
 private:
 	void CreateBuffers();
 	void CreateShadowMapsForAllLights();
+	void CreateEnvironmentMaps();
 	void CreateCube();
 	void CreateQuad();
 
@@ -30,6 +55,11 @@ private:
 	unsigned fbo_;
 	unsigned rbo_;
 
+	int shadow_size_ = 0;
+	int cube_map_size_ = 0;
+	int irradiance_size_ = 0;
+	int prefilter_size_ = 0;
+
 	std::unique_ptr<Mesh> cube_ = nullptr;
 	std::unique_ptr<Mesh> quad_ = nullptr;
 
@@ -38,6 +68,7 @@ private:
 	std::shared_ptr<Texture> irradiance_map_ = nullptr;
 	std::shared_ptr<Texture> prefilter_map_ = nullptr;
 	std::shared_ptr<Texture> brdf_lut_ = nullptr;
+	IrradianceSH irradiance_sh_{};
 
 	std::unique_ptr<Shader> cube_map_shader_ = nullptr;
 	std::unique_ptr<Shader> brdf_shader_ = nullptr;
@@ -0,0 +1,79 @@
+#include "../precompiled.h"
+#include "FileSystem.hpp"
+#include "Logger.hpp"
+
+namespace {
+	std::filesystem::path executableDirectory() {
+#ifdef _WIN32
+		std::wstring buffer(MAX_PATH, L'\0');
+		for (;;) {
+			const DWORD length = GetModuleFileNameW(nullptr, buffer.data(), static_cast<DWORD>(buffer.size()));
+			if (length == 0)
+				return std::filesystem::current_path();
+			if (length < buffer.size()) {
+				buffer.resize(length);
+				break;
+			}
+			buffer.resize(buffer.size() * 2);
+		}
+		return std::filesystem::path(buffer).parent_path();
+#else
+		std::error_code ec;
+		const auto exe = std::filesystem::read_symlink("/proc/self/exe", ec);
+		return ec ? std::filesystem::current_path() : exe.parent_path();
+#endif
+	}
+}
+
+const std::filesystem::path& FileSystem::BaseDirectory()
+{
+	static const auto base = executableDirectory();
+	return base;
+}
+
+const AssetArchive::Reader* FileSystem::Archive()
+{
+	// Mounted once on first use; stays mapped for the life of the process
+	static const auto archive = [] {
+		auto reader = std::make_unique<AssetArchive::Reader>(BaseDirectory() / AssetArchive::file_name);
+		if (reader->IsValid())
+			LOG_INFO(Assets, "Mounted " + std::string(AssetArchive::file_name) + " (" + std::to_string(reader->Count()) + " files)");
+		return reader;
+	}();
+	return archive->IsValid() ? archive.get() : nullptr;
+}
+
+bool FileSystem::IsPacked(const std::string& path)
+{
+	const auto* archive = Archive();
+	return archive && archive->Find(path).has_value();
+}
+
+std::filesystem::path FileSystem::Resolve(const std::string& path)
+{
+	auto next_to_exe = BaseDirectory() / path;
+	if (std::filesystem::exists(next_to_exe))
+		return next_to_exe;
+
+	// IDE/dev runs: assets live in the working directory
+	auto in_working_dir = std::filesystem::current_path() / path;
+	if (std::filesystem::exists(in_working_dir))
+		return in_working_dir;
+
+	return next_to_exe;
+}
+
+FileView FileSystem::Open(const std::string& path)
+{
+	if (const auto* archive = Archive())
+	{
+		if (const auto bytes = archive->Find(path))
+			return FileView(*bytes);
+	}
+
+	MappedFile file(Resolve(path));
+	if (!file.IsOpen())
+		return {};
+
+	return FileView(std::move(file));
+}
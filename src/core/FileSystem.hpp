@@ -0,0 +1,56 @@
+#pragma once
+#include "../precompiled.h"
+#include "AssetArchive.hpp"
+
+// Read-only bytes of one file: either a view into the mounted archive or a
+// memory-mapped loose file. Move-only; the archive outlives every view.
+class FileView
+{
+public:
+	FileView() = default;
+	explicit FileView(std::span<const unsigned char> bytes) : bytes_(bytes) {}
+	explicit FileView(MappedFile&& file)
+		: file_(std::move(file)), bytes_(file_.Data(), file_.Size()) {}
+
+	FileView(FileView&& other) noexcept
+		: file_(std::move(other.file_)), bytes_(std::exchange(other.bytes_, {})) {}
+	FileView& operator= (FileView&& other) noexcept
+	{
+		file_ = std::move(other.file_);
+		bytes_ = std::exchange(other.bytes_, {});
+		return *this;
+	}
+
+	[[nodiscard]] explicit operator bool() const { return bytes_.data() != nullptr; }
+	[[nodiscard]] const unsigned char* Data() const { return bytes_.data(); }
+	[[nodiscard]] size_t Size() const { return bytes_.size(); }
+	[[nodiscard]] std::span<const unsigned char> Bytes() const { return bytes_; }
+	[[nodiscard]] std::string_view Text() const { return { reinterpret_cast<const char*>(bytes_.data()), bytes_.size() }; }
+
+private:
+	MappedFile file_;
+	std::span<const unsigned char> bytes_;
+};
+
+// Virtual file interface used by Loader, Shader and TextRenderer.
+// Paths are install-relative and '/'-separated ("assets/fonts/NotoSans-Bold.ttf").
+// Lookups hit assets.pak next to the executable first, then loose files next
+// to the executable, then loose files in the working directory.
+class FileSystem
+{
+public:
+	// Zero-copy view of a file; empty (false) if it exists nowhere
+	[[nodiscard]] static FileView Open(const std::string& path);
+
+	// True if 'path' is served from the archive
+	[[nodiscard]] static bool IsPacked(const std::string& path);
+
+	// Loose-file location for 'path' (may not exist)
+	[[nodiscard]] static std::filesystem::path Resolve(const std::string& path);
+
+	// Directory of the running executable
+	[[nodiscard]] static const std::filesystem::path& BaseDirectory();
+
+private:
+	[[nodiscard]] static const AssetArchive::Reader* Archive();
+};
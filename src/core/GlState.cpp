@@ -0,0 +1,135 @@
+#include "../precompiled.h"
+#include "GlState.hpp"
+
+#include <cstring>
+
+namespace
+{
+	constexpr GLuint kUnknown = ~0u;
+	constexpr int kTextureUnits = 16;
+
+	struct TextureBinding
+	{
+		GLenum target = 0;
+		GLuint texture = kUnknown;
+	};
+
+	// Raw bits of up to a vec3, so ints and floats share one map
+	using UniformValue = std::array<uint32_t, 3>;
+
+	GLuint g_program = kUnknown;
+	GLuint g_vertex_array = kUnknown;
+	int g_active_unit = -1;
+	std::array<TextureBinding, kTextureUnits> g_textures{};
+	std::unordered_map<uint64_t, UniformValue> g_uniforms;   // (program << 32 | location)
+
+	GlState::Counters g_counters{};
+
+	// True when the value differs from the cached one (and remembers it)
+	bool UniformChanged(const GLint location, const void* data, const size_t bytes)
+	{
+		UniformValue value{};
+		std::memcpy(value.data(), data, bytes);
+
+		const uint64_t key = (static_cast<uint64_t>(g_program) << 32) | static_cast<uint32_t>(location);
+		const auto [it, inserted] = g_uniforms.try_emplace(key, value);
+		if (!inserted && it->second == value)
+			return false;
+		it->second = value;
+		return true;
+	}
+}
+
+void GlState::Invalidate()
+{
+	g_program = kUnknown;
+	g_vertex_array = kUnknown;
+	g_active_unit = -1;
+	g_textures.fill({});
+	g_uniforms.clear();
+}
+
+void GlState::UseProgram(const GLuint program)
+{
+	++g_counters.program_requests;
+	if (program == g_program)
+		return;
+	glUseProgram(program);
+	g_program = program;
+	++g_counters.programs;
+}
+
+void GlState::BindTexture(const int unit, const GLenum target, const GLuint texture)
+{
+	++g_counters.texture_requests;
+	TextureBinding& binding = g_textures[unit];
+	if (binding.target == target && binding.texture == texture)
+		return;
+
+	if (unit != g_active_unit)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		g_active_unit = unit;
+	}
+	glBindTexture(target, texture);
+	binding = { target, texture };
+	++g_counters.textures;
+}
+
+void GlState::BindVertexArray(const GLuint vertex_array)
+{
+	++g_counters.vertex_array_requests;
+	if (vertex_array == g_vertex_array)
+		return;
+	glBindVertexArray(vertex_array);
+	g_vertex_array = vertex_array;
+	++g_counters.vertex_arrays;
+}
+
+void GlState::Uniform(const GLint location, const int value)
+{
+	if (location < 0)
+		return;
+	++g_counters.uniform_requests;
+	if (!UniformChanged(location, &value, sizeof(value)))
+		return;
+	glUniform1i(location, value);
+	++g_counters.uniforms;
+}
+
+void GlState::Uniform(const GLint location, const float value)
+{
+	if (location < 0)
+		return;
+	++g_counters.uniform_requests;
+	if (!UniformChanged(location, &value, sizeof(value)))
+		return;
+	glUniform1f(location, value);
+	++g_counters.uniforms;
+}
+
+void GlState::Uniform(const GLint location, const glm::vec3& value)
+{
+	if (location < 0)
+		return;
+	++g_counters.uniform_requests;
+	if (!UniformChanged(location, glm::value_ptr(value), sizeof(value)))
+		return;
+	glUniform3fv(location, 1, glm::value_ptr(value));
+	++g_counters.uniforms;
+}
+
+void GlState::CountDraw()
+{
+	++g_counters.draws;
+}
+
+const GlState::Counters& GlState::GetCounters()
+{
+	return g_counters;
+}
+
+void GlState::ResetCounters()
+{
+	g_counters = {};
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "../precompiled.h"
+
+// Thin cache in front of the GL calls the render queue makes per draw. Each
+// call compares against what this cache last issued and skips the GL call if
+// nothing would change. Anything outside the cache may touch the same state, so
+// whoever drives it calls Invalidate() before relying on it.
+class GlState final
+{
+public:
+	GlState() = delete;
+
+	// Issued vs. requested (the difference is what the cache saved)
+	struct Counters
+	{
+		uint32_t programs = 0, program_requests = 0;
+		uint32_t textures = 0, texture_requests = 0;
+		uint32_t vertex_arrays = 0, vertex_array_requests = 0;
+		uint32_t uniforms = 0, uniform_requests = 0;
+		uint32_t draws = 0;
+	};
+
+	// Forget everything: the next request of each kind goes to GL
+	static void Invalidate();
+
+	static void UseProgram(GLuint program);
+	static void BindTexture(int unit, GLenum target, GLuint texture);
+	static void BindVertexArray(GLuint vertex_array);
+
+	// Uniforms of the program in use; location -1 is ignored (not counted)
+	static void Uniform(GLint location, int value);
+	static void Uniform(GLint location, float value);
+	static void Uniform(GLint location, const glm::vec3& value);
+
+	static void CountDraw();
+
+	[[nodiscard]] static const Counters& GetCounters();
+	static void ResetCounters();
+};
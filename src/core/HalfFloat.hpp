@@ -0,0 +1,39 @@
+#pragma once
+#include "../precompiled.h"
+
+#include <glm/gtc/packing.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BILLIARDS_HALF_SSE2 1
+#endif
+
+// Half float conversions for non-negative finite data (HDR pixels), four lanes
+// at a time with plain SSE2 (no F16C requirement). Scalar code uses glm's
+// packHalf1x16 / unpackHalf1x16.
+namespace HalfFloat
+{
+#ifdef BILLIARDS_HALF_SSE2
+	// Four floats >= 0 -> four halves in the low 16 bits of each 32-bit lane, rounded
+	// to nearest; values past the half range clamp to the largest finite half
+	inline __m128i FromFloat(const __m128 f)
+	{
+		const __m128i mask_round = _mm_set1_epi32(~0xfff);
+		const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(15 << 23));            // 2^-112: rebias 127 -> 15
+		const __m128 clamp = _mm_castsi128_ps(_mm_set1_epi32((0x7bff << 13) - 0x1000)); // rounds to 65504, not infinity
+
+		const __m128 truncated = _mm_and_ps(f, _mm_castsi128_ps(mask_round));
+		const __m128 scaled = _mm_min_ps(_mm_mul_ps(truncated, magic), clamp);
+		// subtracting ~0xfff adds 0x1000: round half up at the 13 dropped bits
+		const __m128i biased = _mm_sub_epi32(_mm_castps_si128(scaled), mask_round);
+		return _mm_srli_epi32(biased, 13);
+	}
+
+	// Four halves (low 16 bits of each lane, sign clear) -> floats
+	inline __m128 ToFloat(const __m128i h)
+	{
+		const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));   // 2^112: rebias 15 -> 127
+		return _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(h, 13)), magic);
+	}
+#endif
+}
@@ -0,0 +1,196 @@
+#include "../precompiled.h"
+#include "HdrDecoder.hpp"
+#include "HalfFloat.hpp"
+#include "ThreadPool.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+	constexpr float kHalfMax = 65504.0f;   // brighter texels clamp here instead of becoming infinity
+
+	// Reads one '\n'-terminated header line; false at the end of the data
+	bool ReadLine(const uint8_t* data, const size_t size, size_t& pos, std::string_view& line)
+	{
+		const auto* begin = reinterpret_cast<const char*>(data + pos);
+		const auto* newline = static_cast<const char*>(std::memchr(begin, '\n', size - pos));
+		if (!newline)
+			return false;
+		line = std::string_view(begin, static_cast<size_t>(newline - begin));
+		pos += line.size() + 1;
+		return true;
+	}
+
+	bool IsRle(const uint8_t* scanline, const size_t remaining, const int width)
+	{
+		return width >= 8 && width < 0x8000 && remaining >= 4 &&
+			scanline[0] == 2 && scanline[1] == 2 && !(scanline[2] & 0x80) &&
+			((scanline[2] << 8) | scanline[3]) == width;
+	}
+
+	// Offset just past the scanline at 'pos', or 0 when it is malformed
+	size_t SkipScanline(const uint8_t* data, const size_t size, size_t pos, const int width)
+	{
+		if (!IsRle(data + pos, size - pos, width))
+		{
+			const size_t end = pos + static_cast<size_t>(width) * 4;
+			return end <= size ? end : 0;
+		}
+
+		pos += 4;
+		for (int channel = 0; channel < 4; ++channel)
+		{
+			for (int x = 0; x < width;)
+			{
+				if (pos >= size)
+					return 0;
+				const int count = data[pos++];
+				if (count > 128) {
+					x += count - 128;
+					pos += 1;
+				}
+				else {
+					x += count;
+					pos += count;
+				}
+				if (count == 0 || x > width)
+					return 0;
+			}
+		}
+		return pos <= size ? pos : 0;
+	}
+
+	// Expands one scanline into four planes (R, G, B, E) of 'width' bytes each
+	void ExpandScanline(const uint8_t* src, const int width, uint8_t* planes)
+	{
+		if (!IsRle(src, 4, width))
+		{
+			for (int x = 0; x < width; ++x)
+				for (int channel = 0; channel < 4; ++channel)
+					planes[channel * width + x] = src[x * 4 + channel];
+			return;
+		}
+
+		src += 4;
+		for (int channel = 0; channel < 4; ++channel)
+		{
+			uint8_t* plane = planes + channel * width;
+			for (int x = 0; x < width;)
+			{
+				const int count = *src++;
+				if (count > 128) {
+					std::memset(plane + x, *src++, static_cast<size_t>(count - 128));
+					x += count - 128;
+				}
+				else {
+					std::memcpy(plane + x, src, static_cast<size_t>(count));
+					src += count;
+					x += count;
+				}
+			}
+		}
+	}
+
+	// RGBE planes -> interleaved RGB halves: value = mantissa * 2^(e - 136), as stb_image
+	void ConvertScanline(const uint8_t* planes, const int width, uint16_t* rgb)
+	{
+		const uint8_t* r = planes;
+		const uint8_t* g = planes + width;
+		const uint8_t* b = planes + width * 2;
+		const uint8_t* e = planes + width * 3;
+
+		int x = 0;
+#ifdef BILLIARDS_HALF_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		auto widen = [&](const uint8_t* p) {
+			int32_t bytes;
+			std::memcpy(&bytes, p, 4);
+			return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+		};
+
+		for (; x + 4 <= width; x += 4)
+		{
+			// 2^(e - 136) built as float bits; e <= 9 is zero (or denormal, below any half)
+			const __m128i exponent = widen(e + x);
+			const __m128i valid = _mm_cmpgt_epi32(exponent, _mm_set1_epi32(9));
+			const __m128 scale = _mm_and_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(exponent, _mm_set1_epi32(9)), 23)),
+				_mm_castsi128_ps(valid));
+
+			alignas(16) uint32_t halves[3][4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(halves[0]), HalfFloat::FromFloat(_mm_mul_ps(_mm_cvtepi32_ps(widen(r + x)), scale)));
+			_mm_store_si128(reinterpret_cast<__m128i*>(halves[1]), HalfFloat::FromFloat(_mm_mul_ps(_mm_cvtepi32_ps(widen(g + x)), scale)));
+			_mm_store_si128(reinterpret_cast<__m128i*>(halves[2]), HalfFloat::FromFloat(_mm_mul_ps(_mm_cvtepi32_ps(widen(b + x)), scale)));
+
+			uint16_t* out = rgb + x * 3;
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				out[lane * 3 + 0] = static_cast<uint16_t>(halves[0][lane]);
+				out[lane * 3 + 1] = static_cast<uint16_t>(halves[1][lane]);
+				out[lane * 3 + 2] = static_cast<uint16_t>(halves[2][lane]);
+			}
+		}
+#endif
+		for (; x < width; ++x)
+		{
+			const float scale = e[x] ? std::ldexp(1.0f, e[x] - 136) : 0.0f;
+			rgb[x * 3 + 0] = glm::packHalf1x16(std::min(r[x] * scale, kHalfMax));
+			rgb[x * 3 + 1] = glm::packHalf1x16(std::min(g[x] * scale, kHalfMax));
+			rgb[x * 3 + 2] = glm::packHalf1x16(std::min(b[x] * scale, kHalfMax));
+		}
+	}
+}
+
+std::optional<HdrImage> HdrDecoder::Decode(const uint8_t* data, const size_t size, ThreadPool& pool)
+{
+	size_t pos = 0;
+	std::string_view line;
+	if (!ReadLine(data, size, pos, line) || (line != "#?RADIANCE" && line != "#?RGBE"))
+		return std::nullopt;
+
+	// Header: key=value lines up to an empty one
+	bool rgbe = false;
+	while (ReadLine(data, size, pos, line) && !line.empty())
+		rgbe |= line == "FORMAT=32-bit_rle_rgbe";
+	if (!rgbe)
+		return std::nullopt;
+
+	// Resolution: only the standard top-to-bottom, left-to-right orientation
+	int width = 0, height = 0;
+	if (!ReadLine(data, size, pos, line) || !line.starts_with("-Y "))
+		return std::nullopt;
+	const char* cursor = line.data() + 3;
+	const char* end = line.data() + line.size();
+	auto parsed = std::from_chars(cursor, end, height);
+	if (parsed.ec != std::errc() || std::string_view(parsed.ptr, end).substr(0, 4) != " +X ")
+		return std::nullopt;
+	parsed = std::from_chars(parsed.ptr + 4, end, width);
+	if (parsed.ec != std::errc() || width <= 0 || height <= 0)
+		return std::nullopt;
+
+	// Serial: where each scanline starts
+	std::vector<size_t> offsets(static_cast<size_t>(height));
+	for (int y = 0; y < height; ++y)
+	{
+		offsets[y] = pos;
+		pos = SkipScanline(data, size, pos, width);
+		if (pos == 0)
+			return std::nullopt;
+	}
+
+	HdrImage image;
+	image.width = width;
+	image.height = height;
+	image.rgb.resize(static_cast<size_t>(width) * height * 3);
+
+	// Parallel: expand + convert; file rows run top to bottom, the texture bottom to top
+	pool.ParallelFor(static_cast<size_t>(height), 8, [&](const size_t begin, const size_t stop) {
+		std::vector<uint8_t> planes(static_cast<size_t>(width) * 4);
+		for (size_t y = begin; y < stop; ++y)
+		{
+			ExpandScanline(data + offsets[y], width, planes.data());
+			ConvertScanline(planes.data(), width, image.rgb.data() + (height - 1 - y) * static_cast<size_t>(width) * 3);
+		}
+	});
+	return image;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "../precompiled.h"
+
+#include <optional>
+
+class ThreadPool;
+
+// Decoded equirectangular HDR: RGB half floats, rows bottom to top (as OpenGL expects)
+struct HdrImage
+{
+	int width = 0;
+	int height = 0;
+	std::vector<uint16_t> rgb{};
+};
+
+// Radiance .hdr (RGBE) decoder. A quick serial pass finds where each scanline
+// starts (they are RLE-compressed, so the offsets are not known up front); the
+// scanlines are then expanded and converted to half floats on the pool.
+// Handles the common "-Y h +X w" 32-bit_rle_rgbe layout with new-style RLE or
+// flat scanlines; anything else returns nullopt so the caller can fall back.
+class HdrDecoder final
+{
+public:
+	HdrDecoder() = delete;
+
+	[[nodiscard]] static std::optional<HdrImage> Decode(const uint8_t* data, size_t size, ThreadPool& pool);
+};
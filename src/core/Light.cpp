@@ -47,4 +47,12 @@ void Light::SetScale(const glm::vec3& scale) {
 
 glm::vec3 Light::GetScale() const {
     return scale_;
+}
+
+void Light::SetRadius(float radius) {
+    radius_ = radius;
+}
+
+float Light::GetRadius() const {
+    return radius_;
 }
\ No newline at end of file
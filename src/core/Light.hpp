@@ -11,11 +11,13 @@ public:
     void SetPosition(const glm::vec3& position);
     void SetColor(const glm::vec3& color);
     void SetScale(const glm::vec3& scale); 
+    void SetRadius(float radius);
 
     // Getters
     const glm::vec3& GetPosition() const;
     const glm::vec3& GetColor() const;
     glm::vec3 GetScale() const;
+    float GetRadius() const;
 
     void Toggle();
 
@@ -25,5 +27,6 @@ private:
     glm::vec3 position_;
     glm::vec3 color_;
     glm::vec3 scale_ = glm::vec3(1.0f); // Default scale (no scaling)
+    float radius_ = Config::light_radius; // Attenuation reaches zero here; bounds the clusters it is binned into
     bool is_on_;
 };
\ No newline at end of file
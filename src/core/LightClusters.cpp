@@ -0,0 +1,118 @@
+#include "../precompiled.h"
+#include "LightClusters.hpp"
+
+namespace
+{
+	constexpr int kClustersX = Config::cluster_x;
+	constexpr int kClustersY = Config::cluster_y;
+	constexpr int kClustersZ = Config::cluster_z;
+	constexpr int kClusterCount = kClustersX * kClustersY * kClustersZ;
+
+	int Slice(const float depth)
+	{
+		static const float log_ratio = std::log(Config::cluster_far / Config::cluster_near);
+		const float z = std::log(std::max(depth, Config::cluster_near) / Config::cluster_near) / log_ratio;
+		return std::clamp(static_cast<int>(z * kClustersZ), 0, kClustersZ - 1);
+	}
+
+	int Tile(const float ndc, const int tiles)
+	{
+		return std::clamp(static_cast<int>((ndc * 0.5f + 0.5f) * static_cast<float>(tiles)), 0, tiles - 1);
+	}
+}
+
+LightClusters::~LightClusters()
+{
+	for (const Buffer* buffer : { &light_buffer_, &cluster_buffer_, &index_buffer_ })
+		if (buffer->ssbo) glDeleteBuffers(1, &buffer->ssbo);
+}
+
+void LightClusters::Build(const std::span<const PointLight> lights, const glm::mat4& view, const glm::mat4& projection)
+{
+	gpu_lights_.clear();
+	boxes_.clear();
+	ranges_.assign(kClusterCount, glm::uvec2(0));
+
+	// 1) froxel box of every light that can be seen; count per froxel
+	for (const PointLight& light : lights)
+	{
+		const glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+		const float depth = -center.z;
+		const float r = light.radius;
+		if (depth + r < Config::cluster_near)
+			continue;   // entirely behind the camera
+
+		Box box{ 0, 0, Slice(depth - r), kClustersX - 1, kClustersY - 1, Slice(depth + r) };
+
+		// Sphere fully in front: project its view-space AABB for a conservative tile rectangle.
+		// Otherwise it straddles the camera plane and may cover any tile.
+		if (depth - r > Config::cluster_near)
+		{
+			glm::vec2 lo(std::numeric_limits<float>::max()), hi(std::numeric_limits<float>::lowest());
+			for (int corner = 0; corner < 8; ++corner)
+			{
+				const glm::vec3 p = center + glm::vec3(corner & 1 ? r : -r, corner & 2 ? r : -r, corner & 4 ? r : -r);
+				const glm::vec4 clip = projection * glm::vec4(p, 1.0f);
+				const glm::vec2 ndc = glm::vec2(clip.x, clip.y) / clip.w;
+				lo = glm::min(lo, ndc);
+				hi = glm::max(hi, ndc);
+			}
+			if (hi.x < -1.0f || hi.y < -1.0f || lo.x > 1.0f || lo.y > 1.0f)
+				continue;   // off screen
+			box.x0 = Tile(lo.x, kClustersX); box.x1 = Tile(hi.x, kClustersX);
+			box.y0 = Tile(lo.y, kClustersY); box.y1 = Tile(hi.y, kClustersY);
+		}
+
+		for (int z = box.z0; z <= box.z1; ++z)
+			for (int y = box.y0; y <= box.y1; ++y)
+				for (int x = box.x0; x <= box.x1; ++x)
+					++ranges_[x + kClustersX * (y + kClustersY * z)].y;
+
+		boxes_.push_back(box);
+		gpu_lights_.push_back({ glm::vec4(light.position, r), glm::vec4(light.color, static_cast<float>(light.shadow_layer)) });
+	}
+
+	// 2) offsets, then 3) scatter the light indices
+	uint32_t total = 0;
+	for (glm::uvec2& range : ranges_)
+	{
+		range.x = total;
+		total += range.y;
+		range.y = 0;
+	}
+	indices_.resize(total);
+
+	for (uint32_t light = 0; light < static_cast<uint32_t>(boxes_.size()); ++light)
+	{
+		const Box& box = boxes_[light];
+		for (int z = box.z0; z <= box.z1; ++z)
+			for (int y = box.y0; y <= box.y1; ++y)
+				for (int x = box.x0; x <= box.x1; ++x)
+				{
+					glm::uvec2& range = ranges_[x + kClustersX * (y + kClustersY * z)];
+					indices_[range.x + range.y++] = light;
+				}
+	}
+
+	Upload(light_buffer_, gpu_lights_.data(), gpu_lights_.size() * sizeof(GpuLight), Config::light_buffer_binding);
+	Upload(cluster_buffer_, ranges_.data(), ranges_.size() * sizeof(glm::uvec2), Config::cluster_buffer_binding);
+	Upload(index_buffer_, indices_.data(), indices_.size() * sizeof(uint32_t), Config::light_index_binding);
+}
+
+void LightClusters::Upload(Buffer& buffer, const void* data, const size_t bytes, const unsigned binding)
+{
+	if (!buffer.ssbo)
+		glGenBuffers(1, &buffer.ssbo);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer.ssbo);
+
+	// Grow when needed (never zero-sized: an empty list still has to be a valid binding);
+	// otherwise orphan last frame's storage as TransformBuffer does
+	buffer.capacity = std::max({ buffer.capacity, bytes, size_t{ 64 } });
+	glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(buffer.capacity), nullptr, GL_DYNAMIC_DRAW);
+	if (bytes > 0)
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(bytes), data);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer.ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
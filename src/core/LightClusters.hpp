@@ -0,0 +1,60 @@
+#pragma once
+#include "../precompiled.h"
+
+#include <span>
+
+// A light as the main shader sees it
+struct PointLight
+{
+	glm::vec3 position{ 0.0f };
+	float radius = 1.0f;       // contribution fades to exactly zero here
+	glm::vec3 color{ 0.0f };
+	int shadow_layer = -1;     // layer in Environment's shadow map array, -1 = unshadowed
+};
+
+// Clustered forward lighting. Each frame the view frustum is cut into a froxel
+// grid (Config::cluster_x/y screen tiles, Config::cluster_z exponential depth
+// slices) and every light is binned into the froxels its sphere overlaps. The
+// lights, the per-froxel (offset, count) ranges and the flat index list go to
+// three SSBOs; a fragment then shades only the lights of its own froxel.
+class LightClusters final
+{
+public:
+	LightClusters() = default;
+	~LightClusters();
+
+	LightClusters(const LightClusters&) = delete;
+	LightClusters& operator= (const LightClusters&) = delete;
+
+	// Bins 'lights' for this view and uploads everything at the Config bindings
+	void Build(std::span<const PointLight> lights, const glm::mat4& view, const glm::mat4& projection);
+
+	[[nodiscard]] size_t LightCount() const { return gpu_lights_.size(); }
+	[[nodiscard]] size_t IndexCount() const { return indices_.size(); }
+
+private:
+	struct GpuLight
+	{
+		glm::vec4 position_radius;
+		glm::vec4 color_shadow;    // w = shadow layer (float), -1 = none
+	};
+
+	struct Box { int x0, y0, z0, x1, y1, z1; };
+
+	struct Buffer
+	{
+		GLuint ssbo = 0;
+		size_t capacity = 0;   // bytes
+	};
+
+	static void Upload(Buffer& buffer, const void* data, size_t bytes, unsigned binding);
+
+	std::vector<GpuLight> gpu_lights_{};
+	std::vector<Box> boxes_{};
+	std::vector<glm::uvec2> ranges_{};   // per froxel: offset into indices_, count
+	std::vector<uint32_t> indices_{};
+
+	Buffer light_buffer_{};
+	Buffer cluster_buffer_{};
+	Buffer index_buffer_{};
+};
@@ -0,0 +1,175 @@
+#include "../precompiled.h"
+#include "LineBatch.hpp"
+#include "GlState.hpp"
+
+namespace
+{
+	constexpr GLbitfield kMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	constexpr GLsizei kRegionVertices = Config::overlay_vertices_per_frame;
+
+	uint32_t PackColor(const glm::vec3& color)
+	{
+		const glm::vec3 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+		return static_cast<uint32_t>(c.x) | static_cast<uint32_t>(c.y) << 8 | static_cast<uint32_t>(c.z) << 16 | 0xFF000000u;
+	}
+
+	// Point on the XZ circle around 'center' at 'angle'
+	glm::vec3 OnCircle(const glm::vec3& center, const float radius, const float angle)
+	{
+		return glm::vec3(center.x + radius * std::cos(angle), center.y, center.z + radius * std::sin(angle));
+	}
+}
+
+LineBatch::~LineBatch()
+{
+	for (GLsync& fence : fences_)
+		if (fence) glDeleteSync(fence);
+	if (vbo_)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDeleteBuffers(1, &vbo_);
+	}
+	if (vao_) glDeleteVertexArrays(1, &vao_);
+}
+
+void LineBatch::Init()
+{
+	const auto bytes = static_cast<GLsizeiptr>(sizeof(Vertex)) * kRegionVertices * regions;
+
+	glGenVertexArrays(1, &vao_);
+	glGenBuffers(1, &vbo_);
+	glBindVertexArray(vao_);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+	glBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, kMapFlags);
+	mapped_ = static_cast<Vertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, kMapFlags));
+	if (!mapped_)
+		throw std::runtime_error("LineBatch: cannot map the vertex ring");
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+	glEnableVertexAttribArray(1);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	shader_ = std::make_shared<Shader>(Config::line_vertex_path, Config::line_fragment_path);
+}
+
+LineBatch::Vertex* LineBatch::Reserve(const GLsizei count, const float width)
+{
+	if (!region_ready_)
+	{
+		if (!vao_)
+			Init();
+
+		// The GPU may still be drawing this region from 'regions' flushes ago
+		if (GLsync& fence = fences_[region_])
+		{
+			while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED) {}
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+		region_ready_ = true;
+	}
+
+	if (used_ + count > kRegionVertices)
+	{
+		dropped_ += static_cast<size_t>(count);
+		return nullptr;
+	}
+
+	auto batch = std::find_if(batches_.begin(), batches_.end(), [width](const Batch& b) { return b.width == width; });
+	if (batch == batches_.end())
+		batch = batches_.insert(batches_.end(), Batch{ .width = width });
+
+	const GLint first = region_ * kRegionVertices + used_;
+	if (!batch->counts.empty() && batch->firsts.back() + batch->counts.back() == first)
+		batch->counts.back() += count;
+	else
+	{
+		batch->firsts.push_back(first);
+		batch->counts.push_back(count);
+	}
+
+	Vertex* out = mapped_ + first;
+	used_ += count;
+	return out;
+}
+
+void LineBatch::Line(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color, const float width)
+{
+	Vertex* out = Reserve(2, width);
+	if (!out)
+		return;
+	const uint32_t packed = PackColor(color);
+	out[0] = { a, packed };
+	out[1] = { b, packed };
+}
+
+void LineBatch::Polyline(const std::span<const glm::vec3> points, const glm::vec3& color, const float width)
+{
+	if (points.size() < 2)
+		return;
+	Vertex* out = Reserve(static_cast<GLsizei>(2 * (points.size() - 1)), width);
+	if (!out)
+		return;
+	const uint32_t packed = PackColor(color);
+	for (size_t i = 1; i < points.size(); ++i)
+	{
+		*out++ = { points[i - 1], packed };
+		*out++ = { points[i], packed };
+	}
+}
+
+void LineBatch::Circle(const glm::vec3& center, const float radius, const glm::vec3& color, const float width, const int segments)
+{
+	Arc(center, radius, 0.0f, glm::two_pi<float>(), color, width, segments);
+}
+
+void LineBatch::Arc(const glm::vec3& center, const float radius, const float from_radians, const float to_radians,
+	const glm::vec3& color, const float width, int segments)
+{
+	segments = std::max(segments, 1);
+	Vertex* out = Reserve(2 * segments, width);
+	if (!out)
+		return;
+	const uint32_t packed = PackColor(color);
+	const float step = (to_radians - from_radians) / static_cast<float>(segments);
+	glm::vec3 previous = OnCircle(center, radius, from_radians);
+	for (int i = 1; i <= segments; ++i)
+	{
+		const glm::vec3 next = OnCircle(center, radius, from_radians + step * static_cast<float>(i));
+		*out++ = { previous, packed };
+		*out++ = { next, packed };
+		previous = next;
+	}
+}
+
+void LineBatch::Flush(const glm::mat4& view_projection)
+{
+	if (used_ == 0)
+		return;
+
+	shader_->Bind();
+	shader_->SetMat4(view_projection, "uMVP");
+	glBindVertexArray(vao_);
+	for (Batch& batch : batches_)
+	{
+		if (batch.counts.empty())
+			continue;
+		glLineWidth(batch.width);
+		glMultiDrawArrays(GL_LINES, batch.firsts.data(), batch.counts.data(), static_cast<GLsizei>(batch.counts.size()));
+		GlState::CountDraw();
+		batch.firsts.clear();
+		batch.counts.clear();
+	}
+	glBindVertexArray(0);
+	glLineWidth(1.0f);
+
+	fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	region_ = (region_ + 1) % regions;
+	region_ready_ = false;
+	used_ = 0;
+}
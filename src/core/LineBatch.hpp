@@ -0,0 +1,70 @@
+#pragma once
+#include "../precompiled.h"
+#include "Shader.hpp"
+
+#include <span>
+
+// Immediate-mode overlay lines (aiming guide, debug views): lines, circles, arcs
+// and polylines are written straight into a persistently mapped ring buffer as
+// they come in, and Flush draws them all with one call per line width. Colour is
+// per vertex, so it never splits a draw. The ring holds a few frames' worth of
+// regions, each fenced until the GPU is done with it; nothing allocates once the
+// batches have seen their first frame.
+class LineBatch
+{
+public:
+	LineBatch() = default;
+	~LineBatch();
+
+	LineBatch(const LineBatch&) = delete;
+	LineBatch& operator= (const LineBatch&) = delete;
+
+	// All in world space; 'width' in pixels
+	void Line(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color, float width = 1.0f);
+	// Connected segments through 'points' (nothing for fewer than two)
+	void Polyline(std::span<const glm::vec3> points, const glm::vec3& color, float width = 1.0f);
+	// In the XZ plane at center.y; angles from +x towards +z
+	void Circle(const glm::vec3& center, float radius, const glm::vec3& color, float width = 1.0f, int segments = 48);
+	void Arc(const glm::vec3& center, float radius, float from_radians, float to_radians,
+		const glm::vec3& color, float width = 1.0f, int segments = 24);
+
+	// Draws what was collected since the last Flush, then starts over. Leaves the
+	// depth test and blending as the caller set them
+	void Flush(const glm::mat4& view_projection);
+
+	// Vertices that did not fit in their frame's region (not drawn), since the start
+	[[nodiscard]] size_t Dropped() const { return dropped_; }
+
+private:
+	static constexpr int regions = 3;   // frames the GPU may still be reading
+
+	struct Vertex
+	{
+		glm::vec3 position;
+		uint32_t color;   // RGBA8
+	};
+
+	// Ranges of one line width in the current region, merged when contiguous
+	struct Batch
+	{
+		float width = 1.0f;
+		std::vector<GLint> firsts{};
+		std::vector<GLsizei> counts{};
+	};
+
+	void Init();
+	// Room for 'count' GL_LINES vertices of 'width' in the current region, or null if it is full
+	[[nodiscard]] Vertex* Reserve(GLsizei count, float width);
+
+	GLuint vao_ = 0;
+	GLuint vbo_ = 0;
+	Vertex* mapped_ = nullptr;                    // the whole ring, mapped for good
+	std::array<GLsync, regions> fences_{};
+	std::shared_ptr<Shader> shader_ = nullptr;
+
+	int region_ = 0;
+	bool region_ready_ = false;                   // fence of 'region_' waited on this frame
+	GLsizei used_ = 0;                            // vertices written to 'region_'
+	std::vector<Batch> batches_{};                // kept across frames for their capacity
+	size_t dropped_ = 0;
+};
@@ -2,6 +2,8 @@
 #include "Loader.hpp"
 
 #include "stb_image.h"
+#include "ThreadPool.hpp"
+#include <glm/gtc/packing.hpp>
 
 
 // -----------------------------
@@ -20,36 +22,77 @@ namespace {
 
 
 // ============================================================================
-// Model loading (OBJ via tinyobj)
+// Model loading (binary *.mesh cache, OBJ via tinyobj as fallback)
 // ============================================================================
 
 void Loader::LoadModel(const std::string& path, std::vector<std::shared_ptr<Mesh>>& meshes, std::vector<std::shared_ptr<Material>>& materials)
 {
-	tinyobj::ObjReaderConfig reader_config;
-	reader_config.vertex_color = false;
-	reader_config.triangulation_method = "earcut";
+	const auto virtual_path = "assets/models/" + path;
+	const auto cache_name = std::filesystem::path(virtual_path).replace_extension(MeshCache::extension).generic_string();
 
-	const auto model_path = std::filesystem::current_path() / "assets/models" / path;
+	meshes.clear();
+	materials.clear();
 
-	tinyobj::ObjReader reader;
+	// Packed builds ship the baked mesh inside the archive
+	if (FileSystem::IsPacked(cache_name))
+	{
+		const auto file = FileSystem::Open(cache_name);
+		const MeshCache::View view(file.Bytes());
+		if (!view.IsValid()) {
+			throwf("Invalid packed mesh", cache_name);
+		}
 
-	if (!reader.ParseFromFile(model_path.string(), reader_config)) {
-		throwf("Failed to load model", path);
+		LoadMaterials(materials, view);
+		LoadMeshes(meshes, view);
+		return;
 	}
 
-	auto& temp_materials = reader.GetMaterials();
-	auto& temp_attrib = reader.GetAttrib();
-	auto& temp_shapes = reader.GetShapes();
+	const auto model_path = FileSystem::Resolve(virtual_path);
+	auto cache_path = model_path;
+	cache_path.replace_extension(MeshCache::extension);
 
-	meshes.clear();
-	materials.clear();
+	if (!MeshCache::IsFresh(cache_path, model_path))
+	{
+		if (!std::filesystem::exists(model_path)) {
+			throwf("Failed to load model", path);
+		}
 
-	LoadMaterials(materials, temp_materials);
-	LoadMeshes(meshes, temp_shapes, temp_attrib);
+		const auto model = MeshCache::BakeObj(model_path);
+		if (!MeshCache::Write(cache_path, model))
+		{
+			// Read-only install dir etc.: use the freshly baked data directly
+			LOG_WARNING(Assets, "Could not write mesh cache for " + path);
+			LoadMaterials(materials, model.materials);
+			LoadMeshes(meshes, model);
+			return;
+		}
+	}
+
+	{
+		const MeshCache::View view(cache_path);
+		if (view.IsValid())
+		{
+			LoadMaterials(materials, view);
+			LoadMeshes(meshes, view);
+			return;
+		}
+	}
+
+	// Stale format or corrupt file: rebuild from source if we have it. The view is
+	// unmapped by now, as Windows will not replace a file that is still mapped
+	if (!std::filesystem::exists(model_path)) {
+		throwf("Invalid mesh cache", cache_path.string());
+	}
+
+	const auto model = MeshCache::BakeObj(model_path);
+	if (!MeshCache::Write(cache_path, model))
+		LOG_WARNING(Assets, "Could not rewrite mesh cache for " + path);
+	LoadMaterials(materials, model.materials);
+	LoadMeshes(meshes, model);
 }
 
 // ============================================================================
-// Textures (8-bit + HDR)
+// Textures (8-bit + HDR), decoded straight from the archive/mapped file
 // ============================================================================
 std::shared_ptr<Texture> Loader::LoadTexture(const std::string& path)
 {
@@ -59,14 +102,20 @@ std::shared_ptr<Texture> Loader::LoadTexture(const std::string& path)
 	if (unique_textures_.contains(path))
 		return unique_textures_[path];
 
-	int channels, width, height;
-	const auto image_path = std::filesystem::current_path() / "assets/textures" / path;
+	const auto file = FileSystem::Open("assets/textures/" + path);
+	if (!file) {
+		throwf("Image cannot be found", path);
+	}
 
-	if (!stbi_info(image_path.string().c_str(), &width, &height, &channels)) {
-		throwf("Image cannot be found or decoded", path);
+	const auto* bytes = file.Data();
+	const auto size = static_cast<int>(file.Size());
+
+	int channels, width, height;
+	if (!stbi_info_from_memory(bytes, size, &width, &height, &channels)) {
+		throwf("Image cannot be decoded", path);
 	}
 
-	unsigned char* image_data = stbi_load(image_path.string().c_str(), &width, &height, &channels, 0);
+	unsigned char* image_data = stbi_load_from_memory(bytes, size, &width, &height, &channels, 0);
 	if (!image_data) {
 		throwf("stbi_load failed for image", path);
 	}
@@ -79,115 +128,142 @@ std::shared_ptr<Texture> Loader::LoadTexture(const std::string& path)
 	return texture;
 }
 
-std::shared_ptr<Texture> Loader::LoadEnvironment(const std::string& path)
+HdrImage Loader::LoadEnvironment(const std::string& path)
 {
-	int channels, width, height;
-	const auto image_path = std::filesystem::current_path() / "assets/hdr" / path;
+	const auto file = FileSystem::Open("assets/hdr/" + path);
+	if (!file) {
+		throwf("HDR cannot be found", path);
+	}
 
-	stbi_set_flip_vertically_on_load(true);
+	// Parallel RGBE decoder for the usual layout
+	if (auto image = HdrDecoder::Decode(file.Data(), file.Size(), ThreadPool::Shared()))
+		return std::move(*image);
 
-	if (!stbi_info(image_path.string().c_str(), &width, &height, &channels)) {
-		throwf("HDR cannot be found or decoded", path);
-	}
+	LOG_WARNING(Assets, "HDR layout not handled by HdrDecoder, using stb_image: " + path);
 
-	float* hdr_data = stbi_loadf(image_path.string().c_str(), &width, &height, &channels, 3);
+	const auto* bytes = file.Data();
+	const auto size = static_cast<int>(file.Size());
 
-	stbi_set_flip_vertically_on_load(false);
+	int channels, width, height;
+
+	// No stbi_set_flip_vertically_on_load: it is global and this may run beside LoadTexture
+	if (!stbi_info_from_memory(bytes, size, &width, &height, &channels)) {
+		throwf("HDR cannot be decoded", path);
+	}
+
+	float* hdr_data = stbi_loadf_from_memory(bytes, size, &width, &height, &channels, 3);
 	if (!hdr_data) {
 		throwf("stbi_loadf failed for HDR image", path);
 	}
 
-	const auto texture = std::make_shared<Texture>(hdr_data, width, height);
+	HdrImage image;
+	image.width = width;
+	image.height = height;
+	image.rgb.resize(static_cast<size_t>(width) * height * 3);
+	const size_t row_size = static_cast<size_t>(width) * 3;
+	for (int y = 0; y < height; ++y)
+	{
+		const float* src = hdr_data + static_cast<size_t>(height - 1 - y) * row_size;
+		for (size_t i = 0; i < row_size; ++i)
+			image.rgb[y * row_size + i] = glm::packHalf1x16(std::min(src[i], 65504.0f));
+	}
 
 	stbi_image_free(hdr_data);
 
-	return texture;
+	return image;
 }
 
 // ============================================================================
 // Materials & Meshes (private helpers)
 // ============================================================================
-void Loader::LoadMaterials(std::vector<std::shared_ptr<Material>>& materials, const std::vector<tinyobj::material_t>& temp_materials)
+void Loader::LoadMaterials(std::vector<std::shared_ptr<Material>>& materials, const std::vector<MeshCache::MaterialData>& temp_materials)
 {
+	materials.reserve(temp_materials.size());
+
 	for (const auto& material : temp_materials)
 	{
 		materials.push_back(std::make_shared<Material>
 			(
 				material.name,
+				material.diffuse,
+				material.ambient,
+				material.roughness,
+				material.metallic,
+				material.dissolve,
+				LoadTexture(material.textures[MeshCache::DIFFUSE]),
+				LoadTexture(material.textures[MeshCache::AMBIENT]),
+				LoadTexture(material.textures[MeshCache::ROUGHNESS]),
+				LoadTexture(material.textures[MeshCache::METALLIC]),
+				LoadTexture(material.textures[MeshCache::ALPHA]),
+				LoadTexture(material.textures[MeshCache::NORMAL])
+			));
+	}
+}
+
+void Loader::LoadMaterials(std::vector<std::shared_ptr<Material>>& materials, const MeshCache::View& view)
+{
+	const auto count = view.Header().material_count;
+	const auto* entries = view.Materials();
+	materials.reserve(count);
+
+	const auto texture = [&](const MeshCache::MaterialEntry& e, const MeshCache::TextureSlot slot) {
+		return LoadTexture(std::string(view.String(e.textures[slot])));
+	};
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const auto& material = entries[i];
+		materials.push_back(std::make_shared<Material>
+			(
+				std::string(view.String(material.name)),
 				glm::vec3{ material.diffuse[0], material.diffuse[1], material.diffuse[2] },
 				glm::vec3{ material.ambient[0], material.ambient[1], material.ambient[2] },
 				material.roughness,
 				material.metallic,
 				material.dissolve,
-				LoadTexture(material.diffuse_texname),
-				LoadTexture(material.ambient_texname),
-				LoadTexture(material.roughness_texname),
-				LoadTexture(material.metallic_texname),
-				LoadTexture(material.alpha_texname),
-				LoadTexture(material.normal_texname)
+				texture(material, MeshCache::DIFFUSE),
+				texture(material, MeshCache::AMBIENT),
+				texture(material, MeshCache::ROUGHNESS),
+				texture(material, MeshCache::METALLIC),
+				texture(material, MeshCache::ALPHA),
+				texture(material, MeshCache::NORMAL)
 			));
 	}
 }
 
-void Loader::LoadMeshes(std::vector<std::shared_ptr<Mesh>>& meshes, const std::vector<tinyobj::shape_t>& temp_shapes, const tinyobj::attrib_t& temp_attrib)
+void Loader::LoadMeshes(std::vector<std::shared_ptr<Mesh>>& meshes, const MeshCache::ModelData& model)
 {
-	meshes.reserve(temp_shapes.size());
-	
-	for (const auto& shape : temp_shapes)
+	meshes.reserve(model.meshes.size());
+
+	for (const auto& entry : model.meshes)
 	{
-		std::unordered_map<Vertex, uint32_t> unique_vertices;
-		unique_vertices.reserve(shape.mesh.indices.size());
+		meshes.push_back(std::make_shared<Mesh>(
+			model.vertices.data() + entry.vertex_offset, entry.vertex_count,
+			model.indices.data() + entry.index_offset, entry.index_count, entry.index_size,
+			MeshCache::Quantization(entry), entry.material_id));
+	}
+}
 
-		std::vector<Vertex> vertices{};
-		std::vector<unsigned> indices{};
-		vertices.reserve(shape.mesh.indices.size());
-		indices.reserve(shape.mesh.indices.size());
+void Loader::LoadMeshes(std::vector<std::shared_ptr<Mesh>>& meshes, const MeshCache::View& view)
+{
+	const auto count = view.Header().mesh_count;
+	const auto* entries = view.Meshes();
+	meshes.reserve(count);
 
-		size_t index_offset = 0;
-		for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++)
-		{
-			for (size_t v = 0; v < 3; v++)
-			{
-				Vertex vertex{};
-				const auto index = shape.mesh.indices[index_offset + v];
-
-				vertex.position =
-				{
-					temp_attrib.vertices[3 * index.vertex_index + 0],
-					temp_attrib.vertices[3 * index.vertex_index + 1],
-					temp_attrib.vertices[3 * index.vertex_index + 2],
-				};
-
-				if (index.normal_index >= 0)
-				{
-					vertex.normal =
-					{
-						temp_attrib.normals[3 * index.normal_index + 0],
-						temp_attrib.normals[3 * index.normal_index + 1],
-						temp_attrib.normals[3 * index.normal_index + 2],
-					};
-				}
-
-				if (index.texcoord_index >= 0)
-				{
-					vertex.uv =
-					{
-						temp_attrib.texcoords[2 * index.texcoord_index + 0],
-						temp_attrib.texcoords[2 * index.texcoord_index + 1],
-					};
-				}
-
-				if (!unique_vertices.contains(vertex))
-				{
-					unique_vertices[vertex] = static_cast<unsigned>(vertices.size());
-					vertices.push_back(vertex);
-				}
-				indices.push_back(unique_vertices[vertex]);
-			}
-			index_offset += 3;
+	// Upload straight from the mapped pages - no intermediate copies
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const auto& entry = entries[i];
+		if ((entry.index_size != 2 && entry.index_size != 4)
+			|| uint64_t(entry.vertex_offset) + entry.vertex_count > view.Header().vertex_count
+			|| uint64_t(entry.index_offset) + uint64_t(entry.index_count) * entry.index_size > view.Header().index_bytes) {
+			throwf("Mesh range out of bounds in cache", std::to_string(i));
 		}
 
-		meshes.push_back(std::make_shared<Mesh>(vertices, indices, shape.mesh.material_ids[0]));
+		meshes.push_back(std::make_shared<Mesh>(
+			view.Vertices() + entry.vertex_offset, entry.vertex_count,
+			view.Indices() + entry.index_offset, entry.index_count, entry.index_size,
+			MeshCache::Quantization(entry), entry.material_id));
 	}
 }
 
@@ -221,9 +297,9 @@ void Loader::UpdateMaterialDiffuseColor(const std::string& materialName, const g
 	auto material = GetMaterialByName(materialName, materials);
 	if (material) {
 		material->diffuse = newColor;
-		Logger::Log("Updated material " + materialName + " diffuse color to: " + glm::to_string(newColor));
+		LOG_INFO(Assets, "Updated material " + materialName + " diffuse color to: " + glm::to_string(newColor));
 	}
 	else {
-		Logger::Log("Material " + materialName + " not found!");
+		LOG_WARNING(Assets, "Material " + materialName + " not found!");
 	}
 }
@@ -3,13 +3,17 @@
 #include "Material.hpp"
 #include "Mesh.hpp"
 #include "Logger.hpp"
-
-#include <tiny_obj_loader.h>
+#include "MeshCache.hpp"
+#include "FileSystem.hpp"
+#include "HdrDecoder.hpp"
 
 class Loader
 {
 public:
-	// Load meshes + materials from an OBJ path relative to assets/models
+	// Load meshes + materials from an OBJ path relative to assets/models.
+	// A baked *.mesh in the asset archive wins; otherwise a *.mesh cache next
+	// to the OBJ is memory-mapped when fresh, else the OBJ is parsed once and
+	// the cache (re)written.
 	static void LoadModel(const std::string& path, 
 		std::vector<std::shared_ptr<Mesh>>& meshes, 
 		std::vector<std::shared_ptr<Material>>& materials);
@@ -17,8 +21,9 @@ public:
 	// Load standard 8-bit texture (png/jpg/etc) from assets/textures
 	static std::shared_ptr<Texture> LoadTexture(const std::string& path);
 
-	// Load HDR environment map from assets/hdr
-	static std::shared_ptr<Texture> LoadEnvironment(const std::string& path);
+	// Load HDR environment map from assets/hdr as half floats (pixels stay on the CPU for
+	// the SH projection). Thread-safe: Environment::LoadAsync calls it from the pool
+	static HdrImage LoadEnvironment(const std::string& path);
 
 	// Convenience utilities kept for compatibility with your version
 	static std::shared_ptr<Material> GetMaterialByName(const std::string& name, 
@@ -33,9 +38,13 @@ public:
 private:
 	// Helpers (implementation details hidden in the .cpp)
 	static void LoadMaterials(std::vector<std::shared_ptr<Material>>& materials, 
-		const std::vector<tinyobj::material_t>& temp_materials);
+		const std::vector<MeshCache::MaterialData>& temp_materials);
+	static void LoadMaterials(std::vector<std::shared_ptr<Material>>& materials, 
+		const MeshCache::View& view);
+	static void LoadMeshes(std::vector<std::shared_ptr<Mesh>>& meshes, 
+		const MeshCache::ModelData& model);
 	static void LoadMeshes(std::vector<std::shared_ptr<Mesh>>& meshes, 
-		const std::vector<tinyobj::shape_t>& temp_shapes, const tinyobj::attrib_t& temp_attrib);
+		const MeshCache::View& view);
 
 	// Cache of textures by relative path (assets/*)
 	inline static std::unordered_map<std::string, std::shared_ptr<Texture>> unique_textures_{};
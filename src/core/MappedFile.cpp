@@ -0,0 +1,99 @@
+#include "../headless.h"
+#include "MappedFile.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+	file_ = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+		Close();
+		return;
+	}
+
+	mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping_) {
+		Close();
+		return;
+	}
+
+	data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	size_ = data_ ? static_cast<size_t>(size.QuadPart) : 0;
+	if (!data_)
+		Close();
+#else
+	fd_ = ::open(path.c_str(), O_RDONLY);
+	if (fd_ < 0)
+		return;
+
+	struct stat st {};
+	if (::fstat(fd_, &st) != 0 || st.st_size == 0) {
+		Close();
+		return;
+	}
+
+	void* view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+	if (view == MAP_FAILED) {
+		Close();
+		return;
+	}
+
+	data_ = static_cast<const unsigned char*>(view);
+	size_ = static_cast<size_t>(st.st_size);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator= (MappedFile&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	Close();
+	data_ = std::exchange(other.data_, nullptr);
+	size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+	file_ = std::exchange(other.file_, INVALID_HANDLE_VALUE);
+	mapping_ = std::exchange(other.mapping_, nullptr);
+#else
+	fd_ = std::exchange(other.fd_, -1);
+#endif
+	return *this;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (data_) UnmapViewOfFile(data_);
+	if (mapping_) CloseHandle(mapping_);
+	if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+	mapping_ = nullptr;
+	file_ = INVALID_HANDLE_VALUE;
+#else
+	if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+	if (fd_ >= 0) ::close(fd_);
+	fd_ = -1;
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "../headless.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Read-only memory mapping of a whole file. The view stays valid for the
+// lifetime of the object; copying is disabled, moving transfers ownership.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator= (const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator= (MappedFile&& other) noexcept;
+
+	[[nodiscard]] bool IsOpen() const { return data_ != nullptr; }
+	[[nodiscard]] const unsigned char* Data() const { return data_; }
+	[[nodiscard]] size_t Size() const { return size_; }
+
+	void Close();
+
+private:
+	const unsigned char* data_ = nullptr;
+	size_t size_ = 0;
+
+#ifdef _WIN32
+	HANDLE file_ = INVALID_HANDLE_VALUE;
+	HANDLE mapping_ = nullptr;
+#else
+	int fd_ = -1;
+#endif
+};
@@ -6,10 +6,51 @@
 static_assert(offsetof(Vertex, position) == 0, "Vertex.position must be at offset 0");
 
 
-Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned>& indices, const int material_id) : vao_{}, ebo_{}, vbo_{},
+Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned>& indices, const int material_id) : vao_{}, vbo_{}, ebo_{},
 	vertex_count_(static_cast<GLsizei>(vertices.size())), 
 	index_count_(static_cast<GLsizei>(indices.size())),
 	material_id_(material_id)
+{
+	createBuffers(vertices.data(), vertices.size() * sizeof(Vertex), indices.data(), indices.size() * sizeof(GLuint));
+
+	if (!vertices.empty())
+	{
+		bounds_min_ = bounds_max_ = vertices.front().position;
+		for (const Vertex& vertex : vertices)
+		{
+			bounds_min_ = glm::min(bounds_min_, vertex.position);
+			bounds_max_ = glm::max(bounds_max_, vertex.position);
+		}
+	}
+
+	// Describe the vertex layout once per VAO
+	setupVertexFormat();
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+Mesh::Mesh(const PackedVertex* vertices, const size_t vertex_count, const void* indices, const size_t index_count,
+	const size_t index_size, const VertexQuantization& quantization, const int material_id) : vao_{}, vbo_{}, ebo_{},
+	vertex_count_(static_cast<GLsizei>(vertex_count)),
+	index_count_(static_cast<GLsizei>(index_count)),
+	index_type_(index_size == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT),
+	material_id_(material_id),
+	quantization_(quantization)
+{
+	createBuffers(vertices, vertex_count * sizeof(PackedVertex), indices, index_count * index_size);
+
+	// snorm16 spans [-1, 1] of the quantization box
+	bounds_min_ = quantization.offset - glm::abs(quantization.scale);
+	bounds_max_ = quantization.offset + glm::abs(quantization.scale);
+
+	setupPackedVertexFormat();
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Mesh::createBuffers(const void* vertices, const size_t vertex_bytes, const void* indices, const size_t index_bytes)
 {
 	// Create VAO first: it will capture VBO/EBO bindings & attrib setup.
 	glGenVertexArrays(1, &vao_);
@@ -18,21 +59,15 @@ Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned>& ind
 	// Vertex buffer
 	glGenBuffers(1, &vbo_);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-	glBufferData(GL_ARRAY_BUFFER, vertex_count_ * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertex_bytes), vertices, GL_STATIC_DRAW);
 
 	// Optional index buffer (keep it bound while VAO is bound)
 	if (index_count_ > 0)
 	{
 		glGenBuffers(1, &ebo_);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count_ * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(index_bytes), indices, GL_STATIC_DRAW);
 	}
-
-	// Describe the vertex layout once per VAO
-	setupVertexFormat();
-
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 Mesh::~Mesh()
@@ -64,6 +99,30 @@ void Mesh::setupVertexFormat() const
 		reinterpret_cast<const void*>(offsetof(Vertex, uv)));
 }
 
+void Mesh::setupPackedVertexFormat() const
+{
+	// Position (location = 0): snorm16, dequantized in the vertex shader
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(
+		0, 3, GL_SHORT, GL_TRUE,
+		sizeof(PackedVertex),
+		reinterpret_cast<const void*>(offsetof(PackedVertex, position)));
+
+	// Normal (location = 1): octahedral snorm16x2, decoded in the vertex shader
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(
+		1, 2, GL_SHORT, GL_TRUE,
+		sizeof(PackedVertex),
+		reinterpret_cast<const void*>(offsetof(PackedVertex, normal)));
+
+	// UV (location = 2): half floats
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(
+		2, 2, GL_HALF_FLOAT, GL_FALSE,
+		sizeof(PackedVertex),
+		reinterpret_cast<const void*>(offsetof(PackedVertex, uv)));
+}
+
 void Mesh::Bind() const
 {
     glBindVertexArray(vao_);
@@ -77,7 +136,7 @@ void Mesh::Unbind() const
 void Mesh::Draw() const
 {
 	if (index_count_ > 0) {
-		glDrawElements(GL_TRIANGLES, index_count_, GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, index_count_, index_type_, nullptr);
 	}
 	else {
 		glDrawArrays(GL_TRIANGLES, 0, vertex_count_);
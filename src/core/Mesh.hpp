@@ -6,6 +6,9 @@ class Mesh
 {
 public:
 	explicit Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned>& indices = {}, int material_id = 0);
+	// Baked model data (e.g. straight from a memory-mapped mesh cache); index_size is 2 or 4
+	Mesh(const PackedVertex* vertices, size_t vertex_count, const void* indices, size_t index_count, size_t index_size,
+		const VertexQuantization& quantization, int material_id = 0);
 	~Mesh();
 
 	Mesh(const Mesh&) = delete;
@@ -18,6 +21,11 @@ public:
 	void Draw() const;
 	void Clear();
 	[[nodiscard]] int GetMaterialId() const { return material_id_; }
+	[[nodiscard]] GLuint GetVertexArray() const { return vao_; }
+	[[nodiscard]] const VertexQuantization& GetQuantization() const { return quantization_; }
+	// Model-space bounding box of the vertex positions
+	[[nodiscard]] const glm::vec3& GetBoundsMin() const { return bounds_min_; }
+	[[nodiscard]] const glm::vec3& GetBoundsMax() const { return bounds_max_; }
 
 private:
     // GL objects
@@ -28,10 +36,16 @@ private:
     // counts
     GLsizei vertex_count_  = 0;   // number of vertices
     GLsizei index_count_   = 0;   // number of indices
+    GLenum  index_type_    = GL_UNSIGNED_INT;
 
     // meta
     int material_id_ = 0;
+    VertexQuantization quantization_{};   // identity for float vertices
+    glm::vec3 bounds_min_{ 0.0f };
+    glm::vec3 bounds_max_{ 0.0f };
 
     // helpers
+    void createBuffers(const void* vertices, size_t vertex_bytes, const void* indices, size_t index_bytes);
     void setupVertexFormat() const;
+    void setupPackedVertexFormat() const;
 };
@@ -0,0 +1,345 @@
+#include "../headless.h"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <tiny_obj_loader.h>
+#include <cstring>
+
+namespace {
+	constexpr uint64_t kAlignment = 16;
+
+	uint64_t alignUp(const uint64_t value) {
+		return (value + kAlignment - 1) & ~(kAlignment - 1);
+	}
+
+	// String table: offset 0 is the empty string, every entry is NUL-terminated
+	class StringTable {
+	public:
+		StringTable() { bytes_.push_back('\0'); }
+
+		uint32_t Add(const std::string& s) {
+			if (s.empty()) return 0;
+			if (const auto it = offsets_.find(s); it != offsets_.end()) return it->second;
+			const auto offset = static_cast<uint32_t>(bytes_.size());
+			bytes_.insert(bytes_.end(), s.begin(), s.end());
+			bytes_.push_back('\0');
+			offsets_.emplace(s, offset);
+			return offset;
+		}
+
+		const std::vector<char>& Bytes() const { return bytes_; }
+
+	private:
+		std::vector<char> bytes_;
+		std::unordered_map<std::string, uint32_t> offsets_;
+	};
+
+	std::filesystem::file_time_type lastWrite(const std::filesystem::path& p) {
+		std::error_code ec;
+		const auto t = std::filesystem::last_write_time(p, ec);
+		return ec ? std::filesystem::file_time_type::min() : t;
+	}
+}
+
+namespace MeshCache
+{
+
+ModelData BakeObj(const std::filesystem::path& obj_path)
+{
+	tinyobj::ObjReaderConfig reader_config;
+	reader_config.vertex_color = false;
+	reader_config.triangulation_method = "earcut";
+
+	tinyobj::ObjReader reader;
+	if (!reader.ParseFromFile(obj_path.string(), reader_config))
+		throw std::runtime_error("Failed to load model: " + obj_path.string());
+
+	const auto& temp_materials = reader.GetMaterials();
+	const auto& temp_attrib = reader.GetAttrib();
+	const auto& temp_shapes = reader.GetShapes();
+
+	ModelData model;
+
+	model.materials.reserve(temp_materials.size());
+	for (const auto& material : temp_materials)
+	{
+		MaterialData m;
+		m.name = material.name;
+		m.diffuse = { material.diffuse[0], material.diffuse[1], material.diffuse[2] };
+		m.ambient = { material.ambient[0], material.ambient[1], material.ambient[2] };
+		m.roughness = material.roughness;
+		m.metallic = material.metallic;
+		m.dissolve = material.dissolve;
+		m.textures[DIFFUSE] = material.diffuse_texname;
+		m.textures[AMBIENT] = material.ambient_texname;
+		m.textures[ROUGHNESS] = material.roughness_texname;
+		m.textures[METALLIC] = material.metallic_texname;
+		m.textures[ALPHA] = material.alpha_texname;
+		m.textures[NORMAL] = material.normal_texname;
+		model.materials.push_back(std::move(m));
+	}
+
+	model.meshes.reserve(temp_shapes.size());
+
+	std::unordered_map<Vertex, uint32_t> unique_vertices;
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	for (const auto& shape : temp_shapes)
+	{
+		unique_vertices.clear();
+		unique_vertices.reserve(shape.mesh.indices.size());
+		vertices.clear();
+		indices.clear();
+
+		MeshEntry entry{};
+		entry.material_id = shape.mesh.material_ids.empty() ? 0 : shape.mesh.material_ids[0];
+
+		for (size_t f = 0, index_offset = 0; f < shape.mesh.num_face_vertices.size(); f++, index_offset += 3)
+		{
+			for (size_t v = 0; v < 3; v++)
+			{
+				Vertex vertex{};
+				const auto index = shape.mesh.indices[index_offset + v];
+
+				vertex.position =
+				{
+					temp_attrib.vertices[3 * index.vertex_index + 0],
+					temp_attrib.vertices[3 * index.vertex_index + 1],
+					temp_attrib.vertices[3 * index.vertex_index + 2],
+				};
+
+				if (index.normal_index >= 0)
+				{
+					vertex.normal =
+					{
+						temp_attrib.normals[3 * index.normal_index + 0],
+						temp_attrib.normals[3 * index.normal_index + 1],
+						temp_attrib.normals[3 * index.normal_index + 2],
+					};
+				}
+
+				if (index.texcoord_index >= 0)
+				{
+					vertex.uv =
+					{
+						temp_attrib.texcoords[2 * index.texcoord_index + 0],
+						temp_attrib.texcoords[2 * index.texcoord_index + 1],
+					};
+				}
+
+				const auto [it, inserted] = unique_vertices.try_emplace(vertex, static_cast<uint32_t>(vertices.size()));
+				if (inserted)
+					vertices.push_back(vertex);
+				indices.push_back(it->second);
+			}
+		}
+
+		// Post-transform cache first, then overdraw within its ACMR budget, then fetch order.
+		// The new triangle order is kept only if it misses the cache no more often than the
+		// source did (an exporter may already have ordered the mesh well)
+		const std::vector<uint32_t> source_indices = indices;
+		const float source_acmr = MeshOptimizer::ComputeAcmr(indices, vertices.size());
+		MeshOptimizer::OptimizeVertexCache(indices, vertices.size());
+		MeshOptimizer::OptimizeOverdraw(indices, vertices);
+		if (MeshOptimizer::ComputeAcmr(indices, vertices.size()) > source_acmr)
+			indices = source_indices;
+		MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+
+		entry.vertex_offset = static_cast<uint32_t>(model.vertices.size());
+		entry.vertex_count = static_cast<uint32_t>(vertices.size());
+		const auto quantization = MeshOptimizer::Compress(vertices, model.vertices);
+		for (int i = 0; i < 3; ++i)
+		{
+			entry.position_scale[i] = quantization.scale[i];
+			entry.position_offset[i] = quantization.offset[i];
+		}
+
+		// 16-bit indices whenever the mesh fits; every range starts 4-byte aligned
+		model.indices.resize((model.indices.size() + 3) & ~size_t(3));
+		entry.index_offset = static_cast<uint32_t>(model.indices.size());
+		entry.index_count = static_cast<uint32_t>(indices.size());
+		entry.index_size = vertices.size() <= std::numeric_limits<uint16_t>::max() ? 2 : 4;
+
+		model.indices.resize(model.indices.size() + indices.size() * entry.index_size);
+		auto* dst = model.indices.data() + entry.index_offset;
+		if (entry.index_size == 2)
+		{
+			for (const auto index : indices)
+			{
+				const auto narrow = static_cast<uint16_t>(index);
+				std::memcpy(dst, &narrow, sizeof(narrow));
+				dst += sizeof(narrow);
+			}
+		}
+		else
+		{
+			std::memcpy(dst, indices.data(), indices.size() * sizeof(uint32_t));
+		}
+
+		model.meshes.push_back(entry);
+	}
+
+	return model;
+}
+
+std::vector<uint8_t> Serialize(const ModelData& model)
+{
+	StringTable strings;
+
+	std::vector<MaterialEntry> materials;
+	materials.reserve(model.materials.size());
+	for (const auto& m : model.materials)
+	{
+		MaterialEntry e{};
+		e.diffuse[0] = m.diffuse.x; e.diffuse[1] = m.diffuse.y; e.diffuse[2] = m.diffuse.z;
+		e.ambient[0] = m.ambient.x; e.ambient[1] = m.ambient.y; e.ambient[2] = m.ambient.z;
+		e.roughness = m.roughness;
+		e.metallic = m.metallic;
+		e.dissolve = m.dissolve;
+		e.name = strings.Add(m.name);
+		for (uint32_t slot = 0; slot < TEXTURE_SLOT_COUNT; ++slot)
+			e.textures[slot] = strings.Add(m.textures[slot]);
+		materials.push_back(e);
+	}
+
+	FileHeader header{};
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.vertex_stride = sizeof(PackedVertex);
+	header.material_count = static_cast<uint32_t>(materials.size());
+	header.mesh_count = static_cast<uint32_t>(model.meshes.size());
+	header.vertex_count = static_cast<uint32_t>(model.vertices.size());
+	header.index_bytes = static_cast<uint32_t>(model.indices.size());
+	header.string_bytes = static_cast<uint32_t>(strings.Bytes().size());
+
+	header.materials_offset = alignUp(sizeof(FileHeader));
+	header.meshes_offset = alignUp(header.materials_offset + materials.size() * sizeof(MaterialEntry));
+	header.vertices_offset = alignUp(header.meshes_offset + model.meshes.size() * sizeof(MeshEntry));
+	header.indices_offset = alignUp(header.vertices_offset + model.vertices.size() * sizeof(PackedVertex));
+	header.strings_offset = alignUp(header.indices_offset + model.indices.size());
+
+	std::vector<uint8_t> bytes(header.strings_offset + strings.Bytes().size(), 0);
+	auto put = [&](uint64_t offset, const void* data, size_t size) {
+		if (size) std::memcpy(bytes.data() + offset, data, size);
+	};
+
+	put(0, &header, sizeof(header));
+	put(header.materials_offset, materials.data(), materials.size() * sizeof(MaterialEntry));
+	put(header.meshes_offset, model.meshes.data(), model.meshes.size() * sizeof(MeshEntry));
+	put(header.vertices_offset, model.vertices.data(), model.vertices.size() * sizeof(PackedVertex));
+	put(header.indices_offset, model.indices.data(), model.indices.size());
+	put(header.strings_offset, strings.Bytes().data(), strings.Bytes().size());
+
+	return bytes;
+}
+
+bool Write(const std::filesystem::path& cache_path, const ModelData& model)
+{
+	const auto bytes = Serialize(model);
+
+	// Write to a temp file first so a crash never leaves a truncated cache behind
+	auto tmp_path = cache_path;
+	tmp_path += ".tmp";
+
+	{
+		std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out)
+			return false;
+
+		out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		if (!out)
+			return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmp_path, cache_path, ec);
+	if (ec) {
+		std::filesystem::remove(tmp_path, ec);
+		return false;
+	}
+	return true;
+}
+
+bool IsFresh(const std::filesystem::path& cache_path, const std::filesystem::path& obj_path)
+{
+	if (!std::filesystem::exists(cache_path))
+		return false;
+
+	// Shipped without sources: the cache is authoritative
+	if (!std::filesystem::exists(obj_path))
+		return true;
+
+	const auto cache_time = lastWrite(cache_path);
+	auto mtl_path = obj_path;
+	mtl_path.replace_extension(".mtl");
+
+	return cache_time >= lastWrite(obj_path)
+		&& (!std::filesystem::exists(mtl_path) || cache_time >= lastWrite(mtl_path));
+}
+
+// ============================================================================
+// View
+// ============================================================================
+View::View(const std::filesystem::path& cache_path) : file_(cache_path), bytes_(file_.Data(), file_.Size())
+{
+	Validate();
+}
+
+View::View(const std::span<const unsigned char> bytes) : bytes_(bytes)
+{
+	Validate();
+}
+
+void View::Validate()
+{
+	if (!bytes_.data() || bytes_.size() < sizeof(FileHeader))
+		return;
+
+	const auto* header = reinterpret_cast<const FileHeader*>(bytes_.data());
+	if (std::memcmp(header->magic, magic, sizeof(magic)) != 0
+		|| header->version != version
+		|| header->vertex_stride != sizeof(PackedVertex))
+		return;
+
+	// Bounds-check every blob against the mapped size
+	const auto fits = [&](uint64_t offset, uint64_t bytes) { return offset + bytes <= bytes_.size(); };
+	if (!fits(header->materials_offset, uint64_t(header->material_count) * sizeof(MaterialEntry))
+		|| !fits(header->meshes_offset, uint64_t(header->mesh_count) * sizeof(MeshEntry))
+		|| !fits(header->vertices_offset, uint64_t(header->vertex_count) * sizeof(PackedVertex))
+		|| !fits(header->indices_offset, header->index_bytes)
+		|| !fits(header->strings_offset, header->string_bytes)
+		|| header->string_bytes == 0)
+		return;
+
+	header_ = header;
+}
+
+const MaterialEntry* View::Materials() const
+{
+	return reinterpret_cast<const MaterialEntry*>(bytes_.data() + header_->materials_offset);
+}
+
+const MeshEntry* View::Meshes() const
+{
+	return reinterpret_cast<const MeshEntry*>(bytes_.data() + header_->meshes_offset);
+}
+
+const PackedVertex* View::Vertices() const
+{
+	return reinterpret_cast<const PackedVertex*>(bytes_.data() + header_->vertices_offset);
+}
+
+const uint8_t* View::Indices() const
+{
+	return bytes_.data() + header_->indices_offset;
+}
+
+std::string_view View::String(const uint32_t offset) const
+{
+	if (offset >= header_->string_bytes)
+		return {};
+	const char* base = reinterpret_cast<const char*>(bytes_.data() + header_->strings_offset);
+	return std::string_view(base + offset);
+}
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include "../headless.h"
+#include "Vertex.hpp"
+#include "MappedFile.hpp"
+
+#include <span>
+
+// Binary mesh cache (*.mesh) written next to an OBJ on first load.
+//
+// Layout (little-endian, every blob 16-byte aligned):
+//   FileHeader | MaterialEntry[] | MeshEntry[] | vertex blob | index blob | string table
+// Vertices are deduplicated, cache/overdraw-optimized and compressed to the
+// PackedVertex layout the GPU consumes; indices are local to each mesh's
+// vertex range and 16-bit wherever the mesh allows. Loading is a memory map
+// plus one glBufferData per mesh - no parsing, no hashing.
+namespace MeshCache
+{
+	inline constexpr char magic[4] = { 'B', 'M', 'S', 'H' };
+	inline constexpr uint32_t version = 2;
+	inline constexpr const char* const extension = ".mesh";
+
+	enum TextureSlot : uint32_t
+	{
+		DIFFUSE,
+		AMBIENT,
+		ROUGHNESS,
+		METALLIC,
+		ALPHA,
+		NORMAL,
+		TEXTURE_SLOT_COUNT
+	};
+
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t vertex_stride;
+		uint32_t material_count;
+		uint32_t mesh_count;
+		uint32_t vertex_count;
+		uint32_t index_bytes;
+		uint32_t string_bytes;
+		uint64_t materials_offset;
+		uint64_t meshes_offset;
+		uint64_t vertices_offset;
+		uint64_t indices_offset;
+		uint64_t strings_offset;
+	};
+
+	struct MaterialEntry
+	{
+		float diffuse[3];
+		float ambient[3];
+		float roughness;
+		float metallic;
+		float dissolve;
+		uint32_t name;                              // offset into the string table
+		uint32_t textures[TEXTURE_SLOT_COUNT];      // offsets into the string table (0 = none)
+	};
+
+	struct MeshEntry
+	{
+		uint32_t vertex_offset;                     // in vertices
+		uint32_t vertex_count;
+		uint32_t index_offset;                      // in bytes, 4-byte aligned
+		uint32_t index_count;
+		uint32_t index_size;                        // 2 or 4
+		int32_t material_id;
+		float position_scale[3];                    // PackedVertex dequantization
+		float position_offset[3];
+	};
+
+	static_assert(std::is_trivially_copyable_v<FileHeader>);
+	static_assert(std::is_trivially_copyable_v<MaterialEntry>);
+	static_assert(std::is_trivially_copyable_v<MeshEntry>);
+
+	[[nodiscard]] inline VertexQuantization Quantization(const MeshEntry& e)
+	{
+		return {
+			{ e.position_scale[0], e.position_scale[1], e.position_scale[2] },
+			{ e.position_offset[0], e.position_offset[1], e.position_offset[2] }
+		};
+	}
+
+	// CPU-side model produced by the OBJ baker and consumed by the writer
+	struct MaterialData
+	{
+		std::string name;
+		glm::vec3 diffuse{ 0.0f };
+		glm::vec3 ambient{ 0.0f };
+		float roughness{ 0.0f };
+		float metallic{ 0.0f };
+		float dissolve{ 1.0f };
+		std::array<std::string, TEXTURE_SLOT_COUNT> textures{};
+	};
+
+	struct ModelData
+	{
+		std::vector<MaterialData> materials;
+		std::vector<MeshEntry> meshes;
+		std::vector<PackedVertex> vertices;
+		std::vector<uint8_t> indices;               // mixed 16/32-bit, see MeshEntry
+	};
+
+	// Parse, triangulate, deduplicate, optimize and compress an OBJ (the slow path, run once)
+	[[nodiscard]] ModelData BakeObj(const std::filesystem::path& obj_path);
+
+	// Serialize a baked model into the *.mesh byte layout
+	[[nodiscard]] std::vector<uint8_t> Serialize(const ModelData& model);
+
+	// Serialize a baked model to disk; returns false if the file cannot be written
+	bool Write(const std::filesystem::path& cache_path, const ModelData& model);
+
+	// True if 'cache_path' exists and is at least as new as the OBJ and its MTL
+	[[nodiscard]] bool IsFresh(const std::filesystem::path& cache_path, const std::filesystem::path& obj_path);
+
+	// Zero-copy view over a mapped *.mesh file
+	class View
+	{
+	public:
+		// Maps 'cache_path'; IsValid() is false if missing, truncated or a different version
+		explicit View(const std::filesystem::path& cache_path);
+		// Views bytes owned elsewhere (e.g. an asset archive); they must outlive the view
+		explicit View(std::span<const unsigned char> bytes);
+
+		[[nodiscard]] bool IsValid() const { return header_ != nullptr; }
+
+		[[nodiscard]] const FileHeader& Header() const { return *header_; }
+		[[nodiscard]] const MaterialEntry* Materials() const;
+		[[nodiscard]] const MeshEntry* Meshes() const;
+		[[nodiscard]] const PackedVertex* Vertices() const;
+		[[nodiscard]] const uint8_t* Indices() const;
+		[[nodiscard]] std::string_view String(uint32_t offset) const;
+
+	private:
+		void Validate();
+
+		MappedFile file_;
+		std::span<const unsigned char> bytes_;
+		const FileHeader* header_ = nullptr;
+	};
+}
@@ -0,0 +1,359 @@
+#include "../headless.h"
+#include "MeshOptimizer.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+namespace {
+	// Forsyth scoring constants (as published)
+	constexpr int kCacheSize = 32;
+	constexpr float kCacheDecayPower = 1.5f;
+	constexpr float kLastTriScore = 0.75f;
+	constexpr float kValenceBoostScale = 2.0f;
+	constexpr float kValenceBoostPower = 0.5f;
+
+	float vertexScore(const int cache_position, const uint32_t remaining) {
+		if (remaining == 0)
+			return -1.0f; // no triangles left, never pick
+
+		float score = 0.0f;
+		if (cache_position >= 0)
+		{
+			if (cache_position < 3)
+				score = kLastTriScore; // fixed score for the last triangle's vertices
+			else
+			{
+				const float scaler = 1.0f / (kCacheSize - 3);
+				score = std::pow(1.0f - (cache_position - 3) * scaler, kCacheDecayPower);
+			}
+		}
+
+		// Boost vertices with few triangles left so lone triangles don't get stranded
+		score += kValenceBoostScale * std::pow(static_cast<float>(remaining), -kValenceBoostPower);
+		return score;
+	}
+
+	// FIFO cache simulator using timestamps, resettable in O(1)
+	class FifoCache {
+	public:
+		FifoCache(const size_t vertex_count, const size_t cache_size)
+			: stamps_(vertex_count, 0), size_(static_cast<uint32_t>(cache_size)), time_(size_ + 1) {}
+
+		// Returns 1 on a miss (and inserts), 0 on a hit
+		uint32_t Touch(const uint32_t v) {
+			if (time_ - stamps_[v] <= size_) return 0;
+			stamps_[v] = time_++;
+			return 1;
+		}
+
+		void Reset() { time_ += size_ + 1; }
+
+	private:
+		std::vector<uint32_t> stamps_;
+		uint32_t size_;
+		uint32_t time_;
+	};
+
+	int16_t toSnorm16(const float x) {
+		return static_cast<int16_t>(std::round(glm::clamp(x, -1.0f, 1.0f) * 32767.0f));
+	}
+}
+
+namespace MeshOptimizer
+{
+
+void OptimizeVertexCache(std::vector<uint32_t>& indices, const size_t vertex_count)
+{
+	const size_t tri_count = indices.size() / 3;
+	if (tri_count == 0 || vertex_count == 0)
+		return;
+
+	// Vertex -> triangle adjacency (CSR layout)
+	std::vector<uint32_t> remaining(vertex_count, 0);
+	for (const auto v : indices) remaining[v]++;
+
+	std::vector<uint32_t> offsets(vertex_count + 1, 0);
+	for (size_t v = 0; v < vertex_count; ++v) offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t t = 0; t < tri_count; ++t)
+			for (size_t k = 0; k < 3; ++k)
+				adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+	}
+
+	std::vector<int> cache_position(vertex_count, -1);
+	std::vector<float> vertex_score(vertex_count);
+	for (size_t v = 0; v < vertex_count; ++v)
+		vertex_score[v] = vertexScore(-1, remaining[v]);
+
+	std::vector<uint8_t> emitted(tri_count, 0);
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+
+	std::array<uint32_t, kCacheSize + 3> cache{};
+	std::array<uint32_t, kCacheSize + 3> next_cache{};
+	size_t cache_count = 0;
+
+	size_t cursor = 0;
+	int64_t best = 0;
+
+	while (output.size() < indices.size())
+	{
+		if (best < 0)
+		{
+			// Nothing adjacent to the cache: resume from the first unemitted triangle
+			while (emitted[cursor]) ++cursor;
+			best = static_cast<int64_t>(cursor);
+		}
+
+		const auto t = static_cast<size_t>(best);
+		const uint32_t tri[3] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+		output.insert(output.end(), tri, tri + 3);
+		emitted[t] = 1;
+
+		// Detach the triangle from its vertices' active adjacency
+		for (const auto v : tri)
+		{
+			const auto begin = adjacency.begin() + offsets[v];
+			const auto end = begin + remaining[v];
+			const auto it = std::find(begin, end, static_cast<uint32_t>(t));
+			if (it != end)
+			{
+				std::iter_swap(it, end - 1);
+				remaining[v]--;
+			}
+		}
+
+		// New LRU order: this triangle's vertices, then the previous cache
+		size_t next_count = 0;
+		for (const auto v : tri)
+			if (std::find(next_cache.begin(), next_cache.begin() + next_count, v) == next_cache.begin() + next_count)
+				next_cache[next_count++] = v;
+		for (size_t i = 0; i < cache_count; ++i)
+			if (cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2])
+				next_cache[next_count++] = cache[i];
+
+		for (size_t i = 0; i < next_count; ++i)
+		{
+			const auto v = next_cache[i];
+			cache_position[v] = i < kCacheSize ? static_cast<int>(i) : -1;
+			vertex_score[v] = vertexScore(cache_position[v], remaining[v]);
+		}
+
+		cache_count = std::min<size_t>(next_count, kCacheSize);
+		std::copy_n(next_cache.begin(), cache_count, cache.begin());
+
+		// Rescore triangles touching the cache and pick the best one
+		best = -1;
+		float best_score = -std::numeric_limits<float>::max();
+		for (size_t i = 0; i < next_count; ++i)
+		{
+			const auto v = next_cache[i];
+			for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+			{
+				const auto nt = adjacency[a];
+				const float score = vertex_score[indices[nt * 3]] + vertex_score[indices[nt * 3 + 1]] + vertex_score[indices[nt * 3 + 2]];
+				if (score > best_score)
+				{
+					best_score = score;
+					best = nt;
+				}
+			}
+		}
+	}
+
+	indices.swap(output);
+}
+
+void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, const float threshold)
+{
+	const size_t tri_count = indices.size() / 3;
+	if (tri_count < 2)
+		return;
+
+	constexpr size_t cache_size = 16;
+	FifoCache cache(vertices.size(), cache_size);
+
+	// Hard boundaries: triangles that miss on all three vertices already restart the cache
+	std::vector<size_t> hard;
+	for (size_t t = 0; t < tri_count; ++t)
+	{
+		uint32_t misses = 0;
+		for (size_t k = 0; k < 3; ++k) misses += cache.Touch(indices[t * 3 + k]);
+		if (t == 0 || misses == 3) hard.push_back(t);
+	}
+	hard.push_back(tri_count);
+
+	// Soft boundaries: split further while each piece stays within 'threshold' of its parent's ACMR
+	std::vector<size_t> clusters;
+	for (size_t h = 0; h + 1 < hard.size(); ++h)
+	{
+		const size_t start = hard[h], end = hard[h + 1];
+
+		cache.Reset();
+		uint32_t cluster_misses = 0;
+		for (size_t t = start; t < end; ++t)
+			for (size_t k = 0; k < 3; ++k) cluster_misses += cache.Touch(indices[t * 3 + k]);
+		const float limit = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - start);
+
+		cache.Reset();
+		clusters.push_back(start);
+		uint32_t misses = 0;
+		size_t count = 0;
+		for (size_t t = start; t < end; ++t)
+		{
+			for (size_t k = 0; k < 3; ++k) misses += cache.Touch(indices[t * 3 + k]);
+			++count;
+
+			if (t + 1 < end && static_cast<float>(misses) / static_cast<float>(count) <= limit)
+			{
+				clusters.push_back(t + 1);
+				cache.Reset();
+				misses = 0;
+				count = 0;
+			}
+		}
+	}
+	clusters.push_back(tri_count);
+
+	// Area-weighted mesh centroid
+	glm::vec3 mesh_centroid{ 0.0f };
+	float mesh_area = 0.0f;
+	for (size_t t = 0; t < tri_count; ++t)
+	{
+		const auto& a = vertices[indices[t * 3]].position;
+		const auto& b = vertices[indices[t * 3 + 1]].position;
+		const auto& c = vertices[indices[t * 3 + 2]].position;
+		const float area = glm::length(glm::cross(b - a, c - a));
+		mesh_centroid += (a + b + c) * (area / 3.0f);
+		mesh_area += area;
+	}
+	mesh_centroid /= std::max(mesh_area, std::numeric_limits<float>::min());
+
+	// Sort key: how far the cluster faces away from the centre (outer shells first)
+	struct Cluster { size_t start, end; float key; };
+	std::vector<Cluster> sorted;
+	sorted.reserve(clusters.size() - 1);
+	for (size_t i = 0; i + 1 < clusters.size(); ++i)
+	{
+		glm::vec3 centroid{ 0.0f }, normal{ 0.0f };
+		float area_sum = 0.0f;
+		for (size_t t = clusters[i]; t < clusters[i + 1]; ++t)
+		{
+			const auto& a = vertices[indices[t * 3]].position;
+			const auto& b = vertices[indices[t * 3 + 1]].position;
+			const auto& c = vertices[indices[t * 3 + 2]].position;
+			const auto n = glm::cross(b - a, c - a);
+			const float area = glm::length(n);
+			centroid += (a + b + c) * (area / 3.0f);
+			normal += n;
+			area_sum += area;
+		}
+
+		float key = 0.0f;
+		const float normal_length = glm::length(normal);
+		if (area_sum > 0.0f && normal_length > 0.0f)
+			key = glm::dot(centroid / area_sum - mesh_centroid, normal / normal_length);
+
+		sorted.push_back({ clusters[i], clusters[i + 1], key });
+	}
+
+	std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+	for (const auto& cluster : sorted)
+		output.insert(output.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3);
+
+	indices.swap(output);
+}
+
+void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+	constexpr auto unused = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> remap(vertices.size(), unused);
+
+	std::vector<Vertex> reordered;
+	reordered.reserve(vertices.size());
+
+	for (auto& index : indices)
+	{
+		if (remap[index] == unused)
+		{
+			remap[index] = static_cast<uint32_t>(reordered.size());
+			reordered.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	vertices.swap(reordered);
+}
+
+float ComputeAcmr(const std::vector<uint32_t>& indices, const size_t vertex_count, const size_t cache_size)
+{
+	if (indices.size() < 3)
+		return 0.0f;
+
+	FifoCache cache(vertex_count, cache_size);
+	uint32_t misses = 0;
+	for (const auto v : indices) misses += cache.Touch(v);
+	return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+glm::vec2 OctahedralEncode(const glm::vec3& n)
+{
+	const glm::vec3 p = n / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+	if (p.z >= 0.0f)
+		return { p.x, p.y };
+
+	// Fold the lower hemisphere over the diagonals
+	return {
+		(1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+		(1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f)
+	};
+}
+
+VertexQuantization Compress(const std::vector<Vertex>& vertices, std::vector<PackedVertex>& out)
+{
+	VertexQuantization quantization{};
+	if (vertices.empty())
+		return quantization;
+
+	glm::vec3 lo{ std::numeric_limits<float>::max() };
+	glm::vec3 hi{ -std::numeric_limits<float>::max() };
+	for (const auto& v : vertices)
+	{
+		lo = glm::min(lo, v.position);
+		hi = glm::max(hi, v.position);
+	}
+
+	quantization.offset = (lo + hi) * 0.5f;
+	quantization.scale = glm::max((hi - lo) * 0.5f, glm::vec3(1e-6f));
+
+	out.reserve(out.size() + vertices.size());
+	for (const auto& v : vertices)
+	{
+		PackedVertex packed{};
+
+		const glm::vec3 p = (v.position - quantization.offset) / quantization.scale;
+		packed.position[0] = toSnorm16(p.x);
+		packed.position[1] = toSnorm16(p.y);
+		packed.position[2] = toSnorm16(p.z);
+
+		// OBJs without normals leave them zero; point those up the local Z axis
+		const float length = glm::length(v.normal);
+		const glm::vec2 oct = OctahedralEncode(length > 0.0f ? v.normal / length : glm::vec3(0.0f, 0.0f, 1.0f));
+		packed.normal[0] = toSnorm16(oct.x);
+		packed.normal[1] = toSnorm16(oct.y);
+
+		packed.uv[0] = glm::packHalf1x16(v.uv.x);
+		packed.uv[1] = glm::packHalf1x16(v.uv.y);
+
+		out.push_back(packed);
+	}
+
+	return quantization;
+}
+
+}
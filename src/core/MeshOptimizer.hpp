@@ -0,0 +1,28 @@
+#pragma once
+#include "../headless.h"
+#include "Vertex.hpp"
+
+// Offline (bake-time) mesh processing: index reordering for the post-transform
+// vertex cache and overdraw, vertex reordering for fetch locality, and vertex
+// compression to the 16-byte PackedVertex layout. GL-free.
+namespace MeshOptimizer
+{
+	// Forsyth's linear-speed vertex cache optimization (in place)
+	void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count);
+
+	// Reorders cache-friendly clusters so outward-facing ones draw first.
+	// 'threshold' bounds how much ACMR may degrade to gain more clusters.
+	void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, float threshold = 1.05f);
+
+	// Renumbers vertices in first-use order; drops unreferenced vertices
+	void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+	// Average cache miss ratio (misses per triangle) for a FIFO cache
+	[[nodiscard]] float ComputeAcmr(const std::vector<uint32_t>& indices, size_t vertex_count, size_t cache_size = 16);
+
+	// Quantizes positions into the mesh bounds, octahedral-encodes normals and
+	// converts UVs to half floats. Returns the dequantization for the shader.
+	VertexQuantization Compress(const std::vector<Vertex>& vertices, std::vector<PackedVertex>& out);
+
+	[[nodiscard]] glm::vec2 OctahedralEncode(const glm::vec3& n);
+}
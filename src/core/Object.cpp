@@ -1,6 +1,7 @@
 #include "../precompiled.h"
 #include "Object.hpp"
 #include "../core/Loader.hpp"
+#include "../core/RenderQueue.hpp"
 
 Object::Object(const std::string& path)
 {
@@ -12,58 +13,115 @@ void Object::Draw(const std::shared_ptr<Shader>& shader)
 
 	shader->Bind();
 
-	shader->SetMat4(GetModelMatrix(), "modelMatrix");
+	// World objects read their matrix from the shared per-frame transform buffer
+	if (transform_index_ >= 0)
+		shader->SetInt(transform_index_, "objectIndex");
+	else
+		shader->SetMat4(GetModelMatrix(), "modelMatrix");
 
+	DrawMeshes(shader);
+
+	shader->Unbind();
+}
+
+void Object::Submit(RenderQueue& queue, const Shader& shader) const
+{
+	// Only world objects have a transform slot; the matrix is the fallback for everything else
+	const glm::mat4 model = transform_index_ >= 0 ? glm::mat4(1.0f) : GetModelMatrix();
+	for (const auto& mesh : meshes_)
+		queue.Submit(shader, *materials_[mesh->GetMaterialId()], *mesh, transform_index_, model);
+}
+
+void Object::DrawMeshes(const std::shared_ptr<Shader>& shader) const
+{
 	for (const auto& mesh : meshes_)
 	{
 		const auto material = materials_[mesh->GetMaterialId()];
 
+		// Baked meshes carry quantized positions; float meshes report identity
+		const auto& quantization = mesh->GetQuantization();
+		shader->SetVec3(quantization.scale, "positionScale");
+		shader->SetVec3(quantization.offset, "positionOffset");
+
 		material->Bind(shader);
 		mesh->Bind();
 		mesh->Draw();
 		mesh->Unbind();
 		material->Unbind(shader);
 	}
-
-	shader->Unbind();
 }
 
 void Object::Translate(const glm::vec3& translation)
 {
 	translation_ += translation;
+	dirty_ = true;
 }
 
 void Object::Scale(const glm::vec3& scale)
 {
 	scale_ *= scale;
+	dirty_ = true;
 }
 
 void Object::Rotate(const glm::vec3& rotation_axis, const float angle)
 {
-	if (glm::length(rotation_axis) != 0)
+	if (glm::length(rotation_axis) != 0 && angle != 0.0f)
 	{
-		rotation_axis_ = rotation_axis;
-		angle_ = glm::mod(angle_, glm::two_pi<float>());
-		angle_ += angle;
+		// Pre-multiply: the axis is in world space (e.g. a ball rolling across the cloth)
+		orientation_ = glm::normalize(glm::angleAxis(angle, glm::normalize(rotation_axis)) * orientation_);
+		dirty_ = true;
 	}
 }
 
-glm::mat4 Object::GetModelMatrix() const
+void Object::SetTranslation(const glm::vec3& translation)
 {
-	auto model_matrix = glm::mat4(1.0f);
+	translation_ = translation;
+	dirty_ = true;
+}
 
-	if (glm::length(translation_) > Config::min_change)
-		model_matrix = glm::translate(model_matrix, translation_);
+void Object::SetScaling(const glm::vec3& scale)
+{
+	scale_ = scale;
+	dirty_ = true;
+}
 
-	if (glm::length(scale_) > Config::min_change)
-		model_matrix = glm::scale(model_matrix, scale_);
+void Object::SetOrientation(const glm::quat& orientation)
+{
+	orientation_ = orientation;
+	dirty_ = true;
+}
 
-	if (angle_ > Config::min_change)
-		model_matrix = glm::rotate(model_matrix, angle_, rotation_axis_);
+const glm::mat4& Object::GetModelMatrix() const
+{
+	if (dirty_)
+	{
+		model_matrix_ = BuildModelMatrix();
+		dirty_ = false;
+	}
+	return model_matrix_;
+}
 
-	return model_matrix;
+glm::mat4 Object::BuildModelMatrix() const
+{
+	auto model_matrix = glm::translate(glm::mat4(1.0f), translation_);
+	model_matrix = glm::scale(model_matrix, scale_);
+	return model_matrix * glm::mat4_cast(orientation_);
 }
 
+BoundingSphere Object::GetBounds(const glm::mat4& model) const
+{
+	if (meshes_.empty())
+		return { glm::vec3(model[3]), 0.0f };
+
+	glm::vec3 lo = meshes_.front()->GetBoundsMin();
+	glm::vec3 hi = meshes_.front()->GetBoundsMax();
+	for (const auto& mesh : meshes_)
+	{
+		lo = glm::min(lo, mesh->GetBoundsMin());
+		hi = glm::max(hi, mesh->GetBoundsMax());
+	}
+	return BoundingSphere::FromBox(lo, hi, model);
+}
 
 bool Object::HasValidMesh() const {
 	return !meshes_.empty();
@@ -3,8 +3,11 @@
 #include "../core/Material.hpp"
 #include "../core/Mesh.hpp"
 #include "../core/Shader.hpp"
+#include "../core/Bounds.hpp"
 #include "Logger.hpp"
 
+class RenderQueue;
+
 class Object
 {
 public:
@@ -13,16 +16,30 @@ public:
 	explicit Object(const std::string& path);
 
 	virtual void Draw(const std::shared_ptr<Shader>& shader);
+	// Queues one item per mesh instead of drawing now (see RenderQueue)
+	void Submit(RenderQueue& queue, const Shader& shader) const;
 	void Translate(const glm::vec3& translation);
 	void Scale(const glm::vec3& scale);
+	// Accumulates a world-space rotation onto the current orientation
 	void Rotate(const glm::vec3& rotation_axis, float angle);
 
-	glm::vec3 translation_{ 0.0f, 0.0f, 0.0f };
-	glm::vec3 scale_{ 1.0f, 1.0f, 1.0f };
-	glm::vec3 rotation_axis_{ 0.0f, 0.0f, 0.0f };
-	float angle_{ 0.0f };
+	// Transform (model = T * S * R); every setter invalidates the cached matrix
+	void SetTranslation(const glm::vec3& translation);
+	void SetScaling(const glm::vec3& scale);
+	void SetOrientation(const glm::quat& orientation);
+	[[nodiscard]] const glm::vec3& GetTranslation() const { return translation_; }
+	[[nodiscard]] const glm::vec3& GetScaling() const { return scale_; }
+	[[nodiscard]] const glm::quat& GetOrientation() const { return orientation_; }
+
+	// Cached; rebuilt only after the transform changed
+	[[nodiscard]] const glm::mat4& GetModelMatrix() const;
+
+	// World-space sphere around all meshes under 'model' (e.g. a snapshot matrix)
+	[[nodiscard]] BoundingSphere GetBounds(const glm::mat4& model) const;
 
-	[[nodiscard]] glm::mat4 GetModelMatrix() const;
+	// Slot in the per-frame transform buffer (set by World), -1 = use modelMatrix uniform
+	void SetTransformIndex(const int index) { transform_index_ = index; }
+	[[nodiscard]] int GetTransformIndex() const { return transform_index_; }
 
 	// Add public setter methods
 	void SetMeshes(const std::vector<std::shared_ptr<Mesh>>& meshes) { meshes_ = meshes; }
@@ -40,7 +57,22 @@ public:
 	bool HasValidMesh() const;
 
 protected:
+	// Binds each mesh's material and dequantization, then draws it (shader must be bound)
+	void DrawMeshes(const std::shared_ptr<Shader>& shader) const;
+
+	// Subclasses with extra model-space terms override this and call MarkDirty() when they change
+	[[nodiscard]] virtual glm::mat4 BuildModelMatrix() const;
+	void MarkDirty() { dirty_ = true; }
 
 	std::vector<std::shared_ptr<Material>> materials_{};
 	std::vector<std::shared_ptr<Mesh>> meshes_{}; 
+
+private:
+	glm::vec3 translation_{ 0.0f, 0.0f, 0.0f };
+	glm::vec3 scale_{ 1.0f, 1.0f, 1.0f };
+	glm::quat orientation_{ 1.0f, 0.0f, 0.0f, 0.0f };
+
+	mutable glm::mat4 model_matrix_{ 1.0f };
+	mutable bool dirty_{ true };
+	int transform_index_{ -1 };
 };
@@ -0,0 +1,194 @@
+#include "../precompiled.h"
+#include "Quality.hpp"
+#include "../Logger.hpp"
+
+#include <charconv>
+
+namespace
+{
+	constexpr size_t kTierCount = static_cast<size_t>(QualityTier::Count);
+
+	constexpr std::array<const char*, kTierCount> kTierNames = { "low", "medium", "high", "ultra" };
+
+	// Ultra is what used to be hard-coded in Config (plus a wider PCF kernel)
+	constexpr std::array<QualitySettings, kTierCount> kDefaults = { {
+		//  shadow  lights  pcf  cube  irr  prefilter  pause  menu
+		{    512,     3,    0,   512,  32,    128,       2,    2 },   // low
+		{   1024,     6,    1,  1024,  64,    256,       4,    2 },   // medium
+		{   2048,    14,    1,  2048, 128,    512,       6,    4 },   // high
+		{   2048,    14,    2,  4096, 128,   1024,       6,    4 },   // ultra
+	} };
+
+	struct Field { const char* key; int QualitySettings::* member; int min_value; int max_value; };
+
+	constexpr Field kFields[] = {
+		{ "shadow_size",       &QualitySettings::shadow_size,       128, 8192 },
+		{ "shadowed_lights",   &QualitySettings::shadowed_lights,   0,   Config::max_shadow_maps },
+		{ "pcf_radius",        &QualitySettings::pcf_radius,        0,   3 },
+		{ "cube_map_size",     &QualitySettings::cube_map_size,     128, 8192 },
+		{ "irradiance_size",   &QualitySettings::irradiance_size,   16,  512 },
+		// the prefilter map needs Config::max_mip_levels levels of at least 1 texel
+		{ "prefilter_size",    &QualitySettings::prefilter_size,    1 << (Config::max_mip_levels - 1), 4096 },
+		{ "pause_blur_passes", &QualitySettings::pause_blur_passes, 0,   16 },
+		{ "menu_blur_passes",  &QualitySettings::menu_blur_passes,  0,   16 },
+	};
+
+	struct QualityState
+	{
+		std::array<QualitySettings, kTierCount> presets = kDefaults;
+		QualityTier tier = QualityTier::High;
+		unsigned revision = 0;
+		std::string calibrated_for;
+	};
+
+	QualityState& State()
+	{
+		static QualityState state;
+		return state;
+	}
+
+	std::string_view Trim(std::string_view s)
+	{
+		const size_t first = s.find_first_not_of(" \t\r");
+		if (first == std::string_view::npos)
+			return {};
+		const size_t last = s.find_last_not_of(" \t\r");
+		return s.substr(first, last - first + 1);
+	}
+}
+
+void Quality::Load(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		LOG_INFO(Render, std::string("No ") + path + ", using " + Name(Tier()) + " quality");
+		return;
+	}
+
+	QualityState& s = State();
+	std::string line;
+	int line_number = 0;
+	while (std::getline(file, line))
+	{
+		++line_number;
+		const std::string_view text = Trim(std::string_view(line).substr(0, line.find('#')));
+		if (text.empty())
+			continue;
+
+		const size_t eq = text.find('=');
+		const std::string_view key = eq == std::string_view::npos ? std::string_view{} : Trim(text.substr(0, eq));
+		const std::string_view value = eq == std::string_view::npos ? std::string_view{} : Trim(text.substr(eq + 1));
+		const std::string where = path + ":" + std::to_string(line_number);
+
+		if (key == "tier")
+		{
+			if (const auto tier = FromName(value))
+				s.tier = *tier;
+			else
+				LOG_WARNING(Render, where + ": unknown quality tier '" + std::string(value) + "'");
+			continue;
+		}
+		if (key == "calibrated_for")
+		{
+			s.calibrated_for = value;
+			continue;
+		}
+
+		// <tier>.<field> = <int>
+		const size_t dot = key.find('.');
+		const auto tier = dot == std::string_view::npos ? std::nullopt : FromName(key.substr(0, dot));
+		const std::string_view field_name = dot == std::string_view::npos ? std::string_view{} : key.substr(dot + 1);
+		const Field* field = nullptr;
+		for (const Field& f : kFields)
+			if (field_name == f.key)
+				field = &f;
+
+		int number = 0;
+		const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+		if (!tier || !field || ec != std::errc{} || end != value.data() + value.size())
+		{
+			LOG_WARNING(Render, where + ": ignoring '" + std::string(text) + "'");
+			continue;
+		}
+
+		s.presets[static_cast<size_t>(*tier)].*(field->member) = std::clamp(number, field->min_value, field->max_value);
+	}
+
+	++s.revision;
+	LOG_INFO(Render, std::string("Quality: ") + Name(s.tier));
+}
+
+void Quality::Save(const std::string& path)
+{
+	const QualityState& s = State();
+	std::ofstream file(path, std::ios::trunc);
+	if (!file)
+	{
+		LOG_WARNING(Render, "Could not write " + path);
+		return;
+	}
+
+	file << "# Rendering quality: low, medium, high or ultra\n";
+	file << "tier = " << Name(s.tier) << "\n";
+	if (!s.calibrated_for.empty())
+		file << "calibrated_for = " << s.calibrated_for << "\n";
+
+	// Only overrides are written back, so a preset change in a later version still applies
+	for (size_t t = 0; t < kTierCount; ++t)
+		for (const Field& f : kFields)
+			if (s.presets[t].*(f.member) != kDefaults[t].*(f.member))
+				file << kTierNames[t] << "." << f.key << " = " << s.presets[t].*(f.member) << "\n";
+}
+
+void Quality::SetTier(const QualityTier tier)
+{
+	QualityState& s = State();
+	if (tier == s.tier || tier == QualityTier::Count)
+		return;
+	s.tier = tier;
+	++s.revision;
+}
+
+QualityTier Quality::Tier()
+{
+	return State().tier;
+}
+
+const QualitySettings& Quality::Current()
+{
+	return Preset(State().tier);
+}
+
+const QualitySettings& Quality::Preset(const QualityTier tier)
+{
+	return State().presets[static_cast<size_t>(tier)];
+}
+
+unsigned Quality::Revision()
+{
+	return State().revision;
+}
+
+const std::string& Quality::CalibratedDevice()
+{
+	return State().calibrated_for;
+}
+
+void Quality::SetCalibratedDevice(std::string device)
+{
+	State().calibrated_for = std::move(device);
+}
+
+const char* Quality::Name(const QualityTier tier)
+{
+	return tier == QualityTier::Count ? "unknown" : kTierNames[static_cast<size_t>(tier)];
+}
+
+std::optional<QualityTier> Quality::FromName(const std::string_view name)
+{
+	for (size_t t = 0; t < kTierCount; ++t)
+		if (name == kTierNames[t])
+			return static_cast<QualityTier>(t);
+	return std::nullopt;
+}
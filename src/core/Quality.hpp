@@ -0,0 +1,57 @@
+#pragma once
+#include "../precompiled.h"
+
+#include <optional>
+
+enum class QualityTier
+{
+	Low,
+	Medium,
+	High,
+	Ultra,
+	Count
+};
+
+// Everything the GPU cost scales with; the shadow map array keeps Config::max_shadow_maps
+// layers, shadowed_lights only decides how many of them are rendered and sampled
+struct QualitySettings
+{
+	int shadow_size;        // square depth map per light
+	int shadowed_lights;    // lights past this count are lit without a shadow map
+	int pcf_radius;         // 0 = single tap, 1 = 3x3, 2 = 5x5
+	int cube_map_size;      // environment cube map (and BRDF LUT)
+	int irradiance_size;
+	int prefilter_size;     // mip 0 of the specular prefilter map
+	int pause_blur_passes;  // blur behind the pause menu
+	int menu_blur_passes;   // blur behind the main menu
+};
+
+// Named presets read from / written to Config::quality_config_path:
+//
+//   tier = medium
+//   medium.shadow_size = 1024     (optional per-tier overrides, same keys as QualitySettings)
+//   calibrated_for = <GPU | driver> (written by Calibration)
+//
+// Render code reads Current() every frame and compares Revision() to notice a switch.
+class Quality final
+{
+public:
+	Quality() = delete;
+
+	// Unknown keys and malformed lines are logged and skipped; a missing file keeps the defaults
+	static void Load(const std::string& path);
+	static void Save(const std::string& path);
+
+	static void SetTier(QualityTier tier);
+	[[nodiscard]] static QualityTier Tier();
+	[[nodiscard]] static const QualitySettings& Current();
+	[[nodiscard]] static const QualitySettings& Preset(QualityTier tier);
+	[[nodiscard]] static unsigned Revision();
+
+	// Device the tier was picked on by Calibration; empty when never calibrated
+	[[nodiscard]] static const std::string& CalibratedDevice();
+	static void SetCalibratedDevice(std::string device);
+
+	[[nodiscard]] static const char* Name(QualityTier tier);
+	[[nodiscard]] static std::optional<QualityTier> FromName(std::string_view name);
+};
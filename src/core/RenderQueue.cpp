@@ -0,0 +1,136 @@
+#include "../precompiled.h"
+#include "RenderQueue.hpp"
+#include "GlState.hpp"
+
+namespace
+{
+	constexpr int kPassShift = 60;
+	constexpr int kProgramShift = 48;
+	constexpr int kMaterialShift = 24;
+	constexpr uint64_t kProgramMask = (1ull << 12) - 1;
+	constexpr uint64_t kIdMask = (1ull << 24) - 1;
+
+	// Fixed texture units of the material maps (set once in App::Load)
+	constexpr int kDiffuseUnit = 4;
+	constexpr int kRoughnessUnit = 5;
+	constexpr int kNormalUnit = 6;
+	constexpr int kAoUnit = 7;
+	constexpr int kMetallicUnit = 8;
+}
+
+void RenderQueue::Submit(const Shader& shader, const Material& material, const Mesh& mesh, const int transform_index, const glm::mat4& model)
+{
+	const bool transparent = material.dissolve < 1.0f || material.dissolve_texture;
+
+	uint64_t key = static_cast<uint64_t>(transparent ? RenderPass::Transparent : RenderPass::Opaque) << kPassShift;
+	if (transparent)
+		key |= transparent_sequence_++;
+	else
+		key |= (shader.GetID() & kProgramMask) << kProgramShift
+			| (MaterialId(material) & kIdMask) << kMaterialShift
+			| (mesh.GetVertexArray() & kIdMask);
+
+	items_.push_back({ key, &shader, &material, &mesh, transform_index, model });
+}
+
+void RenderQueue::Flush()
+{
+	if (items_.empty())
+		return;
+
+	// Stable: equal keys (same mesh, different transforms) keep submission order
+	std::stable_sort(items_.begin(), items_.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+
+	// Whatever ran since the last flush may have changed any of it
+	GlState::Invalidate();
+
+	const Shader* shader = nullptr;
+	const Locations* locations = nullptr;
+	for (const Item& item : items_)
+	{
+		if (item.shader != shader)
+		{
+			shader = item.shader;
+			locations = &LocationsOf(*shader);
+		}
+		GlState::UseProgram(shader->GetID());
+
+		if (item.transform_index >= 0)
+			GlState::Uniform(locations->object_index, item.transform_index);
+		else if (locations->model_matrix >= 0)
+			glUniformMatrix4fv(locations->model_matrix, 1, GL_FALSE, glm::value_ptr(item.model));
+
+		// Baked meshes carry quantized positions; float meshes report identity
+		const VertexQuantization& quantization = item.mesh->GetQuantization();
+		GlState::Uniform(locations->position_scale, quantization.scale);
+		GlState::Uniform(locations->position_offset, quantization.offset);
+
+		BindMaterial(*item.material, *locations);
+
+		GlState::BindVertexArray(item.mesh->GetVertexArray());
+		item.mesh->Draw();
+		GlState::CountDraw();
+	}
+
+	// Leave GL as the per-object path did
+	glBindVertexArray(0);
+	glUseProgram(0);
+	glActiveTexture(GL_TEXTURE0);
+	GlState::Invalidate();
+
+	items_.clear();
+	transparent_sequence_ = 0;
+}
+
+const RenderQueue::Locations& RenderQueue::LocationsOf(const Shader& shader)
+{
+	const auto it = locations_.find(&shader);
+	if (it != locations_.end())
+		return it->second;
+
+	Locations locations{};
+	locations.object_index = shader.GetLocation("objectIndex");
+	locations.model_matrix = shader.GetLocation("modelMatrix");
+	locations.position_scale = shader.GetLocation("positionScale");
+	locations.position_offset = shader.GetLocation("positionOffset");
+	locations.diffuse = shader.GetLocation("material.diffuse");
+	locations.ao = shader.GetLocation("material.ao");
+	locations.metallic = shader.GetLocation("material.metallic");
+	locations.roughness = shader.GetLocation("material.roughness");
+	locations.dissolve = shader.GetLocation("material.dissolve");
+	locations.has_diffuse = shader.GetLocation("material.hasDiffuseMap");
+	locations.has_roughness = shader.GetLocation("material.hasRoughnessMap");
+	locations.has_normal = shader.GetLocation("material.hasNormalMap");
+	locations.has_ao = shader.GetLocation("material.hasAoMap");
+	locations.has_metallic = shader.GetLocation("material.hasMetallicMap");
+	return locations_.emplace(&shader, locations).first->second;
+}
+
+uint32_t RenderQueue::MaterialId(const Material& material)
+{
+	// Ids follow first submission, so the order is stable from frame to frame
+	const auto [it, inserted] = material_ids_.try_emplace(&material, static_cast<uint32_t>(material_ids_.size()));
+	return it->second;
+}
+
+void RenderQueue::BindMaterial(const Material& material, const Locations& locations)
+{
+	GlState::Uniform(locations.diffuse, material.diffuse);
+	GlState::Uniform(locations.ao, material.ambient);
+	GlState::Uniform(locations.metallic, material.metallic);
+	GlState::Uniform(locations.roughness, material.roughness);
+	GlState::Uniform(locations.dissolve, material.dissolve);
+
+	// Flags are written as values (the cache drops repeats); a map is only bound
+	// when the program reads it, so e.g. the depth pass binds none
+	auto map = [](const std::shared_ptr<Texture>& texture, const GLint has_location, const int unit) {
+		GlState::Uniform(has_location, texture ? 1 : 0);
+		if (texture && has_location >= 0)
+			GlState::BindTexture(unit, texture->GetType(), static_cast<GLuint>(texture->GetId()));
+	};
+	map(material.diffuse_texture, locations.has_diffuse, kDiffuseUnit);
+	map(material.roughness_texture, locations.has_roughness, kRoughnessUnit);
+	map(material.normal_texture, locations.has_normal, kNormalUnit);
+	map(material.ao_texture, locations.has_ao, kAoUnit);
+	map(material.metallic_texture, locations.has_metallic, kMetallicUnit);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "../precompiled.h"
+#include "Shader.hpp"
+#include "Material.hpp"
+#include "Mesh.hpp"
+
+// Opaque items are sorted for fewest state changes; transparent ones (dissolve < 1)
+// are drawn after them in submission order so blending still composes as before
+enum class RenderPass : uint8_t
+{
+	Opaque,
+	Transparent
+};
+
+// Collects one draw item per mesh, sorts them by a 64-bit key
+//
+//   pass (4) | shader program (12) | material (24) | mesh vertex array (24)
+//
+// and replays them through GlState, so consecutive items only pay for the state
+// that actually differs. Objects stay alive until Flush (items hold raw pointers).
+class RenderQueue final
+{
+public:
+	RenderQueue() = default;
+
+	RenderQueue(const RenderQueue&) = delete;
+	RenderQueue& operator= (const RenderQueue&) = delete;
+
+	// 'transform_index' is the object's slot in the frame's TransformBuffer (-1 = use 'model')
+	void Submit(const Shader& shader, const Material& material, const Mesh& mesh, int transform_index, const glm::mat4& model);
+
+	// Sorts and draws everything submitted since the last Flush, then leaves no program / VAO bound
+	void Flush();
+
+	[[nodiscard]] size_t Size() const { return items_.size(); }
+
+private:
+	struct Item
+	{
+		uint64_t key;
+		const Shader* shader;
+		const Material* material;
+		const Mesh* mesh;
+		int transform_index;
+		glm::mat4 model;
+	};
+
+	// Per program, resolved once
+	struct Locations
+	{
+		GLint object_index, model_matrix, position_scale, position_offset;
+		GLint diffuse, ao, metallic, roughness, dissolve;
+		GLint has_diffuse, has_roughness, has_normal, has_ao, has_metallic;
+	};
+
+	const Locations& LocationsOf(const Shader& shader);
+	uint32_t MaterialId(const Material& material);
+	static void BindMaterial(const Material& material, const Locations& locations);
+
+	std::vector<Item> items_{};
+	uint32_t transparent_sequence_ = 0;
+
+	std::unordered_map<const Shader*, Locations> locations_{};
+	std::unordered_map<const Material*, uint32_t> material_ids_{};
+};
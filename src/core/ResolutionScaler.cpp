@@ -0,0 +1,87 @@
+#include "../precompiled.h"
+#include "ResolutionScaler.hpp"
+#include "../Logger.hpp"
+
+ResolutionScaler::ResolutionScaler()
+{
+	glGenQueries(query_count, queries_.data());
+}
+
+ResolutionScaler::~ResolutionScaler()
+{
+	glDeleteQueries(query_count, queries_.data());
+}
+
+void ResolutionScaler::BeginFrame()
+{
+	// Collect whatever finished since last time (typically the frame before last)
+	for (int i = 0; i < query_count; ++i)
+	{
+		if (!in_flight_[i])
+			continue;
+		GLint available = 0;
+		glGetQueryObjectiv(queries_[i], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			continue;
+		GLuint64 ns = 0;
+		glGetQueryObjectui64v(queries_[i], GL_QUERY_RESULT, &ns);
+		in_flight_[i] = false;
+		Feed(static_cast<double>(ns) * 1e-6);
+	}
+
+	// All queries still pending: the GPU is far behind, skip timing this frame
+	timing_ = Config::dynamic_resolution && !in_flight_[next_];
+	if (timing_)
+		glBeginQuery(GL_TIME_ELAPSED, queries_[next_]);
+}
+
+void ResolutionScaler::EndFrame()
+{
+	if (!timing_)
+		return;
+	glEndQuery(GL_TIME_ELAPSED);
+	in_flight_[next_] = true;
+	next_ = (next_ + 1) % query_count;
+	timing_ = false;
+}
+
+void ResolutionScaler::Feed(const double ms)
+{
+	gpu_ms_ = gpu_ms_ <= 0.0 ? ms : gpu_ms_ + (ms - gpu_ms_) * Config::dynamic_resolution_smoothing;
+
+	// Let the smoothed time settle at the new resolution before judging it
+	if (cooldown_ > 0)
+	{
+		--cooldown_;
+		return;
+	}
+
+	const double target = Config::dynamic_resolution_target_ms;
+	if (gpu_ms_ > target) {
+		++over_frames_;
+		under_frames_ = 0;
+	}
+	else if (gpu_ms_ < target * Config::dynamic_resolution_low_water) {
+		++under_frames_;
+		over_frames_ = 0;
+	}
+	else {
+		// inside the band: hold
+		over_frames_ = under_frames_ = 0;
+	}
+
+	float scale = scale_;
+	if (over_frames_ >= Config::dynamic_resolution_down_frames)
+		scale = std::max(Config::min_render_scale, scale_ - Config::render_scale_step_down);
+	else if (under_frames_ >= Config::dynamic_resolution_up_frames)
+		scale = std::min(1.0f, scale_ + Config::render_scale_step_up);
+
+	if (scale != scale_)
+	{
+		LOG_DEBUG(Render, std::format("Render scale {:.2f} -> {:.2f} (GPU {:.2f} ms)", scale_, scale, gpu_ms_));
+		scale_ = scale;
+		cooldown_ = Config::dynamic_resolution_cooldown_frames;
+	}
+	if (over_frames_ >= Config::dynamic_resolution_down_frames || under_frames_ >= Config::dynamic_resolution_up_frames)
+		over_frames_ = under_frames_ = 0;
+}
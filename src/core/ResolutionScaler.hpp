@@ -0,0 +1,42 @@
+#pragma once
+#include "../precompiled.h"
+
+// Dynamic resolution controller. Brackets each frame's GPU work with a timer
+// query, smooths the measured time and steps the scene render scale down when
+// it stays over Config::dynamic_resolution_target_ms, and back up (more slowly)
+// once it has stayed well under. Results are read a few frames late so the CPU
+// never waits on the GPU.
+class ResolutionScaler final
+{
+public:
+	ResolutionScaler();
+	~ResolutionScaler();
+
+	ResolutionScaler(const ResolutionScaler&) = delete;
+	ResolutionScaler(ResolutionScaler&&) = delete;
+	ResolutionScaler& operator= (const ResolutionScaler&) = delete;
+	ResolutionScaler& operator= (ResolutionScaler&&) = delete;
+
+	void BeginFrame();
+	void EndFrame();
+
+	// Fraction of the window resolution the scene is rendered at, in [Config::min_render_scale, 1]
+	[[nodiscard]] float Scale() const { return scale_; }
+	[[nodiscard]] double GpuMs() const { return gpu_ms_; }
+
+private:
+	void Feed(double ms);
+
+	static constexpr int query_count = 4;
+
+	std::array<GLuint, query_count> queries_{};
+	std::array<bool, query_count> in_flight_{};
+	int next_ = 0;
+	bool timing_ = false;
+
+	float scale_ = 1.0f;
+	double gpu_ms_ = 0.0;
+	int over_frames_ = 0;
+	int under_frames_ = 0;
+	int cooldown_ = 0;
+};
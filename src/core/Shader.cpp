@@ -1,20 +1,38 @@
 #include "../precompiled.h"
 #include "Shader.hpp"
+#include "FileSystem.hpp"
 
-Shader::Shader(const std::string& vertex_path, const std::string& fragment_path, const std::string& geometry_path) : id_{}
+namespace
 {
-	const auto vertex = std::filesystem::current_path() / "src/shaders" / vertex_path;
-	const auto fragment = std::filesystem::current_path() / "src/shaders" / fragment_path;
+	// Config values the shaders share with the C++ side, defined right after #version
+	// so a shader never carries its own copy (the light binning depends on them)
+	std::string ConfigDefines()
+	{
+		return std::format(
+			"#define TRANSFORM_BUFFER_BINDING {}\n"
+			"#define LIGHT_BUFFER_BINDING {}\n"
+			"#define CLUSTER_BUFFER_BINDING {}\n"
+			"#define LIGHT_INDEX_BINDING {}\n"
+			"#define CLUSTER_GRID uvec3({}, {}, {})\n"
+			"#define CLUSTER_NEAR {:#}\n"
+			"#define CLUSTER_FAR {:#}\n"
+			"#define MAX_SHADOW_MAPS {}\n",
+			Config::transform_buffer_binding, Config::light_buffer_binding, Config::cluster_buffer_binding,
+			Config::light_index_binding, Config::cluster_x, Config::cluster_y, Config::cluster_z,
+			Config::cluster_near, Config::cluster_far, Config::max_shadow_maps);
+	}
+}
 
-	const auto vertex_shader = LoadShader(GL_VERTEX_SHADER, vertex.string());
-	const auto fragment_shader = LoadShader(GL_FRAGMENT_SHADER, fragment.string());
+Shader::Shader(const std::string& vertex_path, const std::string& fragment_path, const std::string& geometry_path) : id_{}
+{
+	const auto vertex_shader = LoadShader(GL_VERTEX_SHADER, vertex_path);
+	const auto fragment_shader = LoadShader(GL_FRAGMENT_SHADER, fragment_path);
 
 	unsigned geometry_shader = 0;
 
 	if (!geometry_path.empty())
 	{
-		const auto geometry = std::filesystem::current_path() / "src/shaders" / geometry_path;
-		geometry_shader = LoadShader(GL_GEOMETRY_SHADER, geometry.string());
+		geometry_shader = LoadShader(GL_GEOMETRY_SHADER, geometry_path);
 	}
 
 	LinkProgram(vertex_shader, fragment_shader, geometry_shader);
@@ -25,13 +43,18 @@ Shader::Shader(const std::string& vertex_path, const std::string& fragment_path,
 
 std::string Shader::LoadShaderSource(const std::string& path) const
 {
-	std::ifstream file(path, std::ios::in | std::ios::binary);
-    const size_t size = std::filesystem::file_size(path);
-    std::string source(size, '\0');
-
-    file.read(source.data(), static_cast<long long>(size));
-	file.close();
-	
+	// Shader names are relative to src/shaders (packed or loose)
+	const auto file = FileSystem::Open("src/shaders/" + path);
+	if (!file)
+		throw std::exception(("Shader source not found: " + path).c_str());
+
+	std::string source(file.Text());
+
+	// After the #version line; #line keeps compile errors on the file's own line numbers
+	const size_t version = source.find("#version");
+	const size_t line_end = version == std::string::npos ? std::string::npos : source.find('\n', version);
+	const size_t insert_at = line_end == std::string::npos ? 0 : line_end + 1;
+	source.insert(insert_at, ConfigDefines() + (insert_at ? "#line 2\n" : "#line 1\n"));
 	return source;
 }
 
@@ -95,49 +118,57 @@ void Shader::Unbind() const
 
 void Shader::SetMat4(const glm::mat4& m, const std::string& name) const
 {
-	const auto my_loc = glGetUniformLocation(id_, name.c_str());
+	const auto my_loc = GetLocation(name);
 	glUniformMatrix4fv(my_loc, 1, GL_FALSE, glm::value_ptr(m));
 }
 
 void Shader::SetVec2(const glm::vec2& v, const std::string& name) const
 {
-	const GLint loc = glGetUniformLocation(id_, name.c_str());
+	const GLint loc = GetLocation(name);
 	glUniform2fv(loc, 1, glm::value_ptr(v));
 }
 
 void Shader::SetVec3(const glm::vec3& v, const std::string& name) const
 {
-	const auto my_loc = glGetUniformLocation(id_, name.c_str());
+	const auto my_loc = GetLocation(name);
 	glProgramUniform3fv(id_, my_loc, 1, glm::value_ptr(v));
 }
 
 void Shader::SetVec4(const glm::vec4& v, const std::string& name) const
 {
-	const GLint loc = glGetUniformLocation(id_, name.c_str());
+	const GLint loc = GetLocation(name);
 	glUniform4fv(loc, 1, glm::value_ptr(v));
 }
 
 void Shader::SetFloat(const float s, const std::string& name) const
 {
-	const auto my_loc = glGetUniformLocation(id_, name.c_str());
+	const auto my_loc = GetLocation(name);
 	glUniform1f(my_loc, s);
 }
 
 void Shader::SetInt(const int n, const std::string& name) const
 {
-	const auto my_loc = glGetUniformLocation(id_, name.c_str());
+	const auto my_loc = GetLocation(name);
 	glUniform1i(my_loc, n);
 }
 
 void Shader::SetIntArray(const char* name, const int* values, int count)
 {
-	GLint loc = glGetUniformLocation(id_, name);
+	const GLint loc = GetLocation(name);
 	if (loc != -1)
 		glUniform1iv(loc, count, values);
 }
 
 void Shader::SetBool(const bool c, const std::string& name) const
 {
-	const auto my_loc = glGetUniformLocation(id_, name.c_str());
+	const auto my_loc = GetLocation(name);
 	glUniform1i(my_loc, c);
 }
+
+GLint Shader::GetLocation(const std::string& name) const
+{
+	const auto it = locations_.find(name);
+	if (it != locations_.end())
+		return it->second;
+	return locations_[name] = glGetUniformLocation(id_, name.c_str());
+}
@@ -17,6 +17,9 @@ public:
 	void SetIntArray(const char* name, const int* values, int count);
 	void SetBool(bool c, const std::string& name) const;
 
+	// Looked up once per name, then cached (-1 = not an active uniform)
+	[[nodiscard]] GLint GetLocation(const std::string& name) const;
+
 	// Add a public getter for id_
 	unsigned GetID() const {
 		return id_;
@@ -28,4 +31,5 @@ private:
 	void LinkProgram(unsigned vertex, unsigned fragment, unsigned geometry = 0);
 
 	unsigned id_;
+	mutable std::unordered_map<std::string, GLint> locations_{};
 };
\ No newline at end of file
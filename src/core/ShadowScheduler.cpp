@@ -0,0 +1,58 @@
+#include "../precompiled.h"
+#include "ShadowScheduler.hpp"
+
+#include <numeric>
+
+const std::vector<size_t>& ShadowScheduler::Schedule(const std::span<const Request> requests)
+{
+	++frame_;
+	picked_.clear();
+	due_.clear();
+
+	by_importance_.resize(requests.size());
+	std::iota(by_importance_.begin(), by_importance_.end(), size_t{ 0 });
+	std::stable_sort(by_importance_.begin(), by_importance_.end(), [&](const size_t a, const size_t b) {
+		return requests[a].importance > requests[b].importance;
+	});
+
+	for (size_t rank = 0; rank < by_importance_.size(); ++rank)
+	{
+		const size_t index = by_importance_[rank];
+		const Request& request = requests[index];
+		const Layer& layer = layers_[request.layer];
+
+		// Missing or wrong content: not subject to the budget
+		if (!layer.valid || layer.light_space != request.light_space)
+		{
+			picked_.push_back(index);
+			continue;
+		}
+
+		const uint64_t interval = rank < static_cast<size_t>(Config::shadow_realtime_lights) ? 1 : Config::shadow_refresh_interval;
+		const uint64_t age = frame_ - layer.drawn_frame;
+		if (age >= interval)
+			due_.emplace_back(age - interval, index);
+	}
+
+	// Longest overdue first (round-robin among the slow lights); ties keep importance order
+	std::stable_sort(due_.begin(), due_.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+	const size_t budget = static_cast<size_t>(Config::shadow_updates_per_frame);
+	for (size_t i = 0; i < due_.size() && picked_.size() < budget; ++i)
+		picked_.push_back(due_[i].second);
+
+	for (const size_t index : picked_)
+	{
+		Layer& layer = layers_[requests[index].layer];
+		layer.light_space = requests[index].light_space;
+		layer.drawn_frame = frame_;
+		layer.valid = true;
+	}
+	return picked_;
+}
+
+void ShadowScheduler::Invalidate()
+{
+	for (Layer& layer : layers_)
+		layer.valid = false;
+}
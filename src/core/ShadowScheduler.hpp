@@ -0,0 +1,43 @@
+#pragma once
+#include "../precompiled.h"
+
+#include <span>
+
+// Decides which shadow map layers are redrawn this frame. The most important
+// lights (Config::shadow_realtime_lights) are due every frame, the rest every
+// Config::shadow_refresh_interval frames; due layers are served oldest first
+// up to Config::shadow_updates_per_frame. A layer that was never drawn, or
+// whose light matrix changed (light toggled, moved or reassigned), is always
+// drawn: its old contents would be wrong rather than just stale.
+class ShadowScheduler final
+{
+public:
+	struct Request
+	{
+		int layer = 0;
+		float importance = 0.0f;   // larger = more visible to the camera
+		glm::vec3 light_position{ 0.0f };
+		glm::mat4 light_space{ 1.0f };
+	};
+
+	// Indices into 'requests' to render this frame
+	const std::vector<size_t>& Schedule(std::span<const Request> requests);
+
+	// Every layer is redrawn on the next Schedule (e.g. shadow maps reallocated)
+	void Invalidate();
+
+private:
+	struct Layer
+	{
+		glm::mat4 light_space{ 1.0f };
+		uint64_t drawn_frame = 0;
+		bool valid = false;
+	};
+
+	std::array<Layer, Config::max_shadow_maps> layers_{};
+	uint64_t frame_ = 0;
+
+	std::vector<size_t> by_importance_{};
+	std::vector<std::pair<uint64_t, size_t>> due_{};   // (overdue frames, request)
+	std::vector<size_t> picked_{};
+};
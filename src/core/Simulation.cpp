@@ -0,0 +1,158 @@
+#include "../precompiled.h"
+#include "Simulation.hpp"
+#include "World.hpp"
+
+#include <chrono>
+
+namespace
+{
+	// GLFW key / mouse button -> SimulationInput field
+	constexpr std::pair<int, bool SimulationInput::*> kKeyBindings[] = {
+		{ GLFW_KEY_LEFT, &SimulationInput::rotate_left },
+		{ GLFW_KEY_RIGHT, &SimulationInput::rotate_right },
+		{ GLFW_KEY_UP, &SimulationInput::pull },
+		{ GLFW_KEY_DOWN, &SimulationInput::push },
+		{ GLFW_KEY_SPACE, &SimulationInput::shoot },
+		{ GLFW_KEY_R, &SimulationInput::raise },
+		{ GLFW_KEY_F, &SimulationInput::lower },
+	};
+	constexpr std::pair<int, bool SimulationInput::*> kMouseBindings[] = {
+		{ GLFW_MOUSE_BUTTON_RIGHT, &SimulationInput::place_button },
+	};
+
+	template <size_t N>
+	bool SimulationInput::* Find(const std::pair<int, bool SimulationInput::*> (&bindings)[N], const int code)
+	{
+		for (const auto& [bound, field] : bindings)
+			if (bound == code) return field;
+		return nullptr;
+	}
+}
+
+Simulation::Simulation(World& world) : world_(world)
+{
+}
+
+Simulation::~Simulation()
+{
+	Stop();
+}
+
+void Simulation::Start()
+{
+	if (running_.exchange(true))
+		return;
+
+	// The render thread must never see an empty snapshot
+	PublishSnapshot();
+	snapshots_.Update();
+
+	thread_ = std::thread([this] { Run(); });
+}
+
+void Simulation::Stop()
+{
+	if (!running_.exchange(false))
+		return;
+	if (thread_.joinable())
+		thread_.join();
+}
+
+void Simulation::SubmitInput(const SimulationInput& input)
+{
+	input_.Back() = input;
+	input_.Publish();
+}
+
+void Simulation::Post(std::function<void(World&)> command)
+{
+	std::lock_guard lock(command_mutex_);
+	commands_.push_back(std::move(command));
+}
+
+const WorldSnapshot& Simulation::LatestSnapshot()
+{
+	snapshots_.Update();
+	return snapshots_.Front();
+}
+
+void Simulation::Run()
+{
+	using Clock = std::chrono::steady_clock;
+
+	const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / Config::simulation_rate));
+	const float dt = 1.0f / static_cast<float>(Config::simulation_rate);
+
+	auto next_tick = Clock::now();
+	while (running_.load(std::memory_order_acquire))
+	{
+		// Catch up on missed ticks (coarse OS sleep), but drop the backlog after a long stall
+		int steps = 0;
+		while (Clock::now() >= next_tick && steps < Config::simulation_max_catch_up)
+		{
+			// Same clock as Input::Now(): events are applied on the tick they happened in
+			Tick(dt, std::chrono::duration<double>(next_tick.time_since_epoch()).count());
+			next_tick += step;
+			++steps;
+		}
+		if (steps == Config::simulation_max_catch_up)
+			next_tick = Clock::now() + step;
+
+		std::this_thread::sleep_until(next_tick);
+	}
+}
+
+void Simulation::Tick(const float dt, const double tick_time)
+{
+	input_.Update();
+	ApplyEvents(tick_time);
+
+	{
+		std::lock_guard lock(command_mutex_);
+		pending_commands_.swap(commands_);
+	}
+	for (auto& command : pending_commands_)
+		command(world_);
+	pending_commands_.clear();
+
+	SimulationInput input = input_.Front();
+	for (const auto& [code, field] : kKeyBindings)
+		input.*field = buttons_held_.*field || buttons_pressed_.*field;
+	for (const auto& [code, field] : kMouseBindings)
+		input.*field = buttons_held_.*field || buttons_pressed_.*field;
+	buttons_pressed_ = {};
+
+	world_.Update(dt, input);
+	PublishSnapshot();
+}
+
+void Simulation::ApplyEvents(const double tick_time)
+{
+	events_.clear();
+	Input::DrainEvents(tick_time, events_);
+
+	for (const InputEvent& event : events_)
+	{
+		bool SimulationInput::* field = event.type == InputEvent::Type::Key ? Find(kKeyBindings, event.code) : Find(kMouseBindings, event.code);
+		if (!field)
+			continue;
+
+		if (event.action == GLFW_PRESS)
+		{
+			buttons_held_.*field = true;
+			buttons_pressed_.*field = true;   // a tap shorter than a tick still counts
+		}
+		else if (event.action == GLFW_RELEASE)
+		{
+			buttons_held_.*field = false;
+		}
+	}
+}
+
+void Simulation::PublishSnapshot()
+{
+	WorldSnapshot& snapshot = snapshots_.Back();
+	world_.WriteSnapshot(snapshot);
+	snapshot.tick = tick_++;
+	snapshots_.Publish();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "../precompiled.h"
+#include "Snapshot.hpp"
+#include "TripleBuffer.hpp"
+#include "../interface/Input.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class World;
+
+// Runs World::Update (physics, rules, cue aiming) on its own thread at a fixed
+// tick. The render thread only exchanges data with it through triple buffers
+// (input in, snapshots out) and a command queue for menu actions, so a slow
+// frame never stalls the simulation and a physics spike never drops a frame.
+class Simulation
+{
+public:
+	explicit Simulation(World& world);
+	~Simulation();
+
+	Simulation(const Simulation&) = delete;
+	Simulation& operator= (const Simulation&) = delete;
+
+	// Publishes the initial snapshot, then starts ticking
+	void Start();
+	void Stop();
+
+	// --- render thread ---
+	void SubmitInput(const SimulationInput& input);
+
+	// Runs 'command' on the simulation thread before the next tick (menu actions)
+	void Post(std::function<void(World&)> command);
+
+	// Newest published state; stays valid until the next call
+	[[nodiscard]] const WorldSnapshot& LatestSnapshot();
+
+private:
+	void Run();
+	void Tick(float dt, double tick_time);
+	void ApplyEvents(double tick_time);
+	void PublishSnapshot();
+
+	World& world_;
+
+	TripleBuffer<SimulationInput> input_{};
+	SimulationInput buttons_held_{};                // button fields only, from Input events
+	SimulationInput buttons_pressed_{};             // pressed within the current tick
+	std::vector<InputEvent> events_{};
+	TripleBuffer<WorldSnapshot> snapshots_{};
+
+	std::mutex command_mutex_;
+	std::vector<std::function<void(World&)>> commands_{};
+	std::vector<std::function<void(World&)>> pending_commands_{};   // simulation thread only
+
+	std::atomic<bool> running_{ false };
+	std::thread thread_;
+	uint64_t tick_ = 0;
+};
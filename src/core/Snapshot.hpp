@@ -0,0 +1,55 @@
+#pragma once
+#include "../precompiled.h"
+#include "../gameplay/Player.hpp"
+#include "../physics/TrajectoryPreview.hpp"
+
+// Input seen by one simulation tick. The render thread publishes the continuous
+// part (in_game, spin, mouse ray) once per frame; the buttons are rebuilt on the
+// simulation thread from the timestamped event queue (see Input).
+struct SimulationInput
+{
+	bool in_game = false;
+
+	// Cue aiming (held during the tick, or pressed at any point within it)
+	bool rotate_left = false;
+	bool rotate_right = false;
+	bool pull = false;
+	bool push = false;
+	bool shoot = false;
+	bool raise = false;
+	bool lower = false;
+	glm::vec2 spin{ 0.0f };
+	float strike_force = 0.0f;   // Config::power_coeff as the menu has it (the menu edits it on the render thread)
+	bool guideline = false;   // the aiming guide is shown: keep its prediction up to date
+
+	// Ball in hand
+	glm::vec3 mouse_ray_origin{ 0.0f };
+	glm::vec3 mouse_ray_dir{ 0.0f };
+	bool place_button = false;
+};
+
+// Simulation -> render thread: immutable copy of everything drawn or shown for one tick
+struct WorldSnapshot
+{
+	static constexpr int ball_count = 16;
+
+	uint64_t tick = 0;
+
+	std::array<int, ball_count> ball_numbers{};     // per slot; the rack can change with a new match
+	std::array<glm::mat4, ball_count> ball_matrices{};
+	std::array<glm::vec3, ball_count> ball_positions{};
+	std::array<bool, ball_count> ball_drawn{};
+	std::array<bool, ball_count> legal_targets{};   // first contact allowed (aiming guideline)
+	bool balls_in_motion = false;
+
+	glm::mat4 cue_matrix{ 1.0f };
+	glm::vec3 aim_dir{ 1.0f, 0.0f, 0.0f };
+	PredictedPaths trajectory{};   // aiming guide; empty while it is off or balls roll
+
+	// HUD
+	std::vector<Player> players{};
+	int current_player = 0;
+	float shot_clock = 0.0f;
+	bool game_over = false;
+	std::string message{};
+};
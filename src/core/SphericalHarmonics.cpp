@@ -0,0 +1,151 @@
+#include "../precompiled.h"
+#include "SphericalHarmonics.hpp"
+#include "ThreadPool.hpp"
+#include "HalfFloat.hpp"
+
+#include <mutex>
+
+namespace
+{
+	// Real SH basis constants for bands 0..2
+	constexpr float kY0 = 0.282095f;
+	constexpr float kY1 = 0.488603f;
+	constexpr float kY2 = 1.092548f;
+	constexpr float kY20 = 0.315392f;
+	constexpr float kY22 = 0.546274f;
+
+	// Clamped cosine convolution per band (pi, 2pi/3, pi/4), divided by pi
+	constexpr std::array<float, 9> kBandScale = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+
+	void Basis(const float x, const float y, const float z, float out[9])
+	{
+		out[0] = kY0;
+		out[1] = kY1 * y;
+		out[2] = kY1 * z;
+		out[3] = kY1 * x;
+		out[4] = kY2 * x * y;
+		out[5] = kY2 * y * z;
+		out[6] = kY20 * (3.0f * z * z - 1.0f);
+		out[7] = kY2 * x * z;
+		out[8] = kY22 * (x * x - y * y);
+	}
+
+	// Sum over one row of basis(dir) * rgb; sums[k * 3 + c]
+	void ProjectRow(const uint16_t* rgb, const float* cos_phi, const float* sin_phi, const int width,
+		const float cos_lat, const float sin_lat, float sums[27])
+	{
+		int i = 0;
+#ifdef BILLIARDS_HALF_SSE2
+		const __m128 c = _mm_set1_ps(cos_lat);
+		const __m128 y = _mm_set1_ps(sin_lat);
+		const __m128 yy = _mm_mul_ps(y, y);
+
+		__m128 acc[27];
+		for (__m128& a : acc)
+			a = _mm_setzero_ps();
+
+		for (; i + 4 <= width; i += 4)
+		{
+			const __m128 x = _mm_mul_ps(c, _mm_loadu_ps(cos_phi + i));
+			const __m128 z = _mm_mul_ps(c, _mm_loadu_ps(sin_phi + i));
+
+			const uint16_t* p = rgb + 3 * i;
+			const __m128 color[3] = {
+				HalfFloat::ToFloat(_mm_setr_epi32(p[0], p[3], p[6], p[9])),
+				HalfFloat::ToFloat(_mm_setr_epi32(p[1], p[4], p[7], p[10])),
+				HalfFloat::ToFloat(_mm_setr_epi32(p[2], p[5], p[8], p[11])) };
+
+			const __m128 basis[9] = {
+				_mm_set1_ps(kY0),
+				_mm_mul_ps(_mm_set1_ps(kY1), y),
+				_mm_mul_ps(_mm_set1_ps(kY1), z),
+				_mm_mul_ps(_mm_set1_ps(kY1), x),
+				_mm_mul_ps(_mm_set1_ps(kY2), _mm_mul_ps(x, y)),
+				_mm_mul_ps(_mm_set1_ps(kY2), _mm_mul_ps(y, z)),
+				_mm_mul_ps(_mm_set1_ps(kY20), _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(z, z)), _mm_set1_ps(1.0f))),
+				_mm_mul_ps(_mm_set1_ps(kY2), _mm_mul_ps(x, z)),
+				_mm_mul_ps(_mm_set1_ps(kY22), _mm_sub_ps(_mm_mul_ps(x, x), yy)) };
+
+			for (int k = 0; k < 9; ++k)
+				for (int ch = 0; ch < 3; ++ch)
+					acc[k * 3 + ch] = _mm_add_ps(acc[k * 3 + ch], _mm_mul_ps(basis[k], color[ch]));
+		}
+
+		for (int n = 0; n < 27; ++n)
+		{
+			alignas(16) float lanes[4];
+			_mm_store_ps(lanes, acc[n]);
+			sums[n] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		}
+#else
+		std::fill_n(sums, 27, 0.0f);
+#endif
+		// Scalar tail (or the whole row without SSE)
+		for (; i < width; ++i)
+		{
+			float basis[9];
+			Basis(cos_lat * cos_phi[i], sin_lat, cos_lat * sin_phi[i], basis);
+			const uint16_t* p = rgb + 3 * i;
+			for (int ch = 0; ch < 3; ++ch)
+			{
+				const float color = glm::unpackHalf1x16(p[ch]);
+				for (int k = 0; k < 9; ++k)
+					sums[k * 3 + ch] += basis[k] * color;
+			}
+		}
+	}
+}
+
+IrradianceSH IrradianceSH::FromEquirect(const uint16_t* rgb, const int width, const int height, ThreadPool& pool)
+{
+	// Same mapping as cubemap.fragmentshader: u = atan(z, x) / 2pi + 0.5, v = asin(y) / pi + 0.5
+	std::vector<float> cos_phi(width), sin_phi(width);
+	for (int i = 0; i < width; ++i)
+	{
+		const float phi = ((static_cast<float>(i) + 0.5f) / static_cast<float>(width) - 0.5f) * glm::two_pi<float>();
+		cos_phi[i] = std::cos(phi);
+		sin_phi[i] = std::sin(phi);
+	}
+	const double pixel_area = (glm::two_pi<double>() / width) * (glm::pi<double>() / height);
+
+	std::array<double, 27> total{};
+	std::mutex total_mutex;
+
+	pool.ParallelFor(static_cast<size_t>(height), 16, [&](const size_t begin, const size_t end) {
+		// Doubles across rows: thousands of rows of float sums would lose the small bands
+		std::array<double, 27> local{};
+		for (size_t row = begin; row < end; ++row)
+		{
+			const float lat = ((static_cast<float>(row) + 0.5f) / static_cast<float>(height) - 0.5f) * glm::pi<float>();
+			const float cos_lat = std::cos(lat);
+
+			float sums[27];
+			ProjectRow(rgb + row * static_cast<size_t>(width) * 3, cos_phi.data(), sin_phi.data(), width,
+				cos_lat, std::sin(lat), sums);
+
+			const double weight = pixel_area * cos_lat;   // solid angle of a pixel in this row
+			for (int n = 0; n < 27; ++n)
+				local[n] += weight * sums[n];
+		}
+
+		std::lock_guard lock(total_mutex);
+		for (int n = 0; n < 27; ++n)
+			total[n] += local[n];
+	});
+
+	IrradianceSH sh;
+	for (int k = 0; k < 9; ++k)
+		sh.coefficients[k] = kBandScale[k] * glm::vec3(total[k * 3], total[k * 3 + 1], total[k * 3 + 2]);
+	return sh;
+}
+
+glm::vec3 IrradianceSH::Evaluate(const glm::vec3& normal) const
+{
+	float basis[9];
+	Basis(normal.x, normal.y, normal.z, basis);
+
+	glm::vec3 result(0.0f);
+	for (int k = 0; k < 9; ++k)
+		result += basis[k] * coefficients[k];
+	return glm::max(result, glm::vec3(0.0f));
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "../precompiled.h"
+
+class ThreadPool;
+
+// Order-2 (9 coefficient) spherical harmonics of RGB radiance, already convolved
+// with the clamped cosine lobe and divided by pi: evaluating them at a normal
+// gives what the irradiance cube map stores there (see shader.fragmentshader).
+struct IrradianceSH
+{
+	std::array<glm::vec3, 9> coefficients{};
+
+	// Projects an equirectangular RGB half float image (rows bottom to top, as uploaded
+	// for the cube map capture) over all pixels, in parallel rows with SSE lanes
+	static IrradianceSH FromEquirect(const uint16_t* rgb, int width, int height, ThreadPool& pool);
+
+	// CPU reference of the shader's evaluation
+	[[nodiscard]] glm::vec3 Evaluate(const glm::vec3& normal) const;
+};
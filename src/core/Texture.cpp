@@ -68,6 +68,29 @@ Texture::Texture(float* image_data, const int width, const int height) :
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, width, height, 0, GL_RG, GL_FLOAT, nullptr);
 }
 
+Texture::Texture(const uint16_t* half_rgb, const int width, const int height) :
+	texture_{}, type_(GL_TEXTURE_2D)
+{
+	glGenTextures(1, &texture_);
+	glBindTexture(GL_TEXTURE_2D, texture_);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// Rows of 3 halves are not 4-byte aligned for odd widths; TextRenderer relies on its own setting
+	GLint alignment = 4; glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_HALF_FLOAT, half_rgb);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+Texture::~Texture()
+{
+	glDeleteTextures(1, &texture_);
+}
+
 void Texture::Bind() const
 {
 	glBindTexture(type_, texture_);
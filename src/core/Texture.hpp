@@ -6,7 +6,9 @@ public:
 	Texture(int size, bool mipmap);
 	Texture(unsigned char* image_data, int width, int height, int channels);
 	Texture(float* image_data, int width, int height);
-	~Texture() = default;
+	// RGB half floats (GL_RGB16F without a conversion on upload)
+	Texture(const uint16_t* half_rgb, int width, int height);
+	~Texture();
 
 	Texture(const Texture&) = delete;
 	Texture(Texture&&) = delete;
@@ -15,6 +17,7 @@ public:
 
 	void Bind() const;
 	[[nodiscard]] int GetId() const { return static_cast<int>(texture_); }
+	[[nodiscard]] GLenum GetType() const { return static_cast<GLenum>(type_); }
 
 private:
 	unsigned texture_;
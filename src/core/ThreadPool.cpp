@@ -0,0 +1,120 @@
+#include "../headless.h"
+#include "ThreadPool.hpp"
+
+#include <atomic>
+
+ThreadPool::ThreadPool(size_t workers)
+{
+	if (workers == 0)
+		workers = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+	threads_.reserve(workers);
+	for (size_t i = 0; i < workers; ++i)
+		threads_.emplace_back([this] { WorkerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(mutex_);
+		stopping_ = true;
+	}
+	wake_.notify_all();
+	for (std::thread& thread : threads_)
+		thread.join();
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	if (threads_.empty())
+	{
+		task();   // single-core machine: the caller does the work
+		return;
+	}
+	{
+		std::lock_guard lock(mutex_);
+		tasks_.push_back(std::move(task));
+	}
+	wake_.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mutex_);
+			wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+			if (tasks_.empty())
+				return;   // stopping, queue drained
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+		task();
+	}
+}
+
+void ThreadPool::ParallelFor(const size_t count, const size_t grain, const std::function<void(size_t, size_t)>& body)
+{
+	if (count == 0)
+		return;
+
+	// A few chunks per thread so an uneven chunk doesn't leave the others idle
+	const size_t threads = threads_.size() + 1;
+	const size_t chunk_size = std::max(std::max<size_t>(grain, 1), (count + threads * 4 - 1) / (threads * 4));
+	const size_t chunks = (count + chunk_size - 1) / chunk_size;
+
+	if (chunks == 1 || threads_.empty())
+	{
+		body(0, count);
+		return;
+	}
+
+	// Shared with helpers that may only start after this call returned (they then find no chunk left)
+	struct Batch
+	{
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> done{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+		std::exception_ptr error;
+	};
+	const auto batch = std::make_shared<Batch>();
+
+	auto run_chunks = [batch, chunks, chunk_size, count, &body] {
+		for (size_t chunk = batch->next++; chunk < chunks; chunk = batch->next++)
+		{
+			const size_t begin = chunk * chunk_size;
+			try {
+				body(begin, std::min(begin + chunk_size, count));
+			}
+			catch (...) {
+				std::lock_guard lock(batch->mutex);
+				if (!batch->error)
+					batch->error = std::current_exception();
+			}
+			if (++batch->done == chunks)
+			{
+				std::lock_guard lock(batch->mutex);
+				batch->finished.notify_all();
+			}
+		}
+	};
+
+	const size_t helpers = std::min(chunks - 1, threads_.size());
+	for (size_t i = 0; i < helpers; ++i)
+		Enqueue(run_chunks);
+	run_chunks();
+
+	std::unique_lock lock(batch->mutex);
+	batch->finished.wait(lock, [&] { return batch->done == chunks; });
+	if (batch->error)
+		std::rethrow_exception(batch->error);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "../headless.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+// Fixed set of worker threads for CPU-heavy loading and batch work. Submit runs
+// one task and returns its future; ParallelFor splits an index range into
+// chunks that the workers and the calling thread take in turn, so a nested
+// ParallelFor (called from inside a task) still finishes instead of deadlocking.
+class ThreadPool final
+{
+public:
+	// 0 = one worker per hardware thread, minus the caller
+	explicit ThreadPool(size_t workers = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator= (const ThreadPool&) = delete;
+
+	// Process-wide pool, created on first use
+	static ThreadPool& Shared();
+
+	[[nodiscard]] size_t WorkerCount() const { return threads_.size(); }
+
+	template<class F>
+	auto Submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+	{
+		using Result = std::invoke_result_t<std::decay_t<F>>;
+		auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+		auto future = packaged->get_future();
+		Enqueue([packaged] { (*packaged)(); });
+		return future;
+	}
+
+	// body(begin, end) over [0, count) in chunks of at least 'grain' indices; returns when all ran.
+	// The first exception thrown by a chunk is rethrown here (the other chunks still complete)
+	void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+private:
+	void Enqueue(std::function<void()> task);
+	void WorkerLoop();
+
+	std::vector<std::thread> threads_{};
+	std::deque<std::function<void()>> tasks_{};
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	bool stopping_ = false;
+};
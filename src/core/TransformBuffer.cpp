@@ -0,0 +1,40 @@
+#include "../precompiled.h"
+#include "TransformBuffer.hpp"
+
+TransformBuffer::~TransformBuffer()
+{
+	if (ssbo_) glDeleteBuffers(1, &ssbo_);
+}
+
+int TransformBuffer::Push(const glm::mat4& matrix)
+{
+	matrices_.push_back(matrix);
+	return static_cast<int>(matrices_.size()) - 1;
+}
+
+void TransformBuffer::Upload(const unsigned binding)
+{
+	if (matrices_.empty())
+		return;
+
+	if (!ssbo_)
+		glGenBuffers(1, &ssbo_);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo_);
+
+	const auto bytes = static_cast<GLsizeiptr>(matrices_.size() * sizeof(glm::mat4));
+	if (matrices_.size() > capacity_)
+	{
+		capacity_ = matrices_.size();
+		glBufferData(GL_SHADER_STORAGE_BUFFER, bytes, matrices_.data(), GL_DYNAMIC_DRAW);
+	}
+	else
+	{
+		// Orphan, then fill: the driver hands us fresh storage instead of stalling on last frame's draws
+		glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(capacity_ * sizeof(glm::mat4)), nullptr, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bytes, matrices_.data());
+	}
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, ssbo_);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
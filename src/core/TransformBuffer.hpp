@@ -0,0 +1,29 @@
+#pragma once
+#include "../precompiled.h"
+
+// Per-frame array of model matrices shared by every pass (main + all shadow
+// maps). Uploaded once per frame into an SSBO; draws only set an index.
+class TransformBuffer
+{
+public:
+	TransformBuffer() = default;
+	~TransformBuffer();
+
+	TransformBuffer(const TransformBuffer&) = delete;
+	TransformBuffer& operator= (const TransformBuffer&) = delete;
+
+	// Starts a new frame; returns the slot of each pushed matrix in order
+	void Clear() { matrices_.clear(); }
+	int Push(const glm::mat4& matrix);
+
+	// Uploads the frame's matrices and binds them at 'binding'
+	void Upload(unsigned binding);
+
+	[[nodiscard]] const std::vector<glm::mat4>& Matrices() const { return matrices_; }
+
+private:
+	std::vector<glm::mat4> matrices_{};
+
+	GLuint ssbo_ = 0;
+	size_t capacity_ = 0;   // in matrices
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include "../precompiled.h"
+
+#include <atomic>
+
+// Lock-free single-producer / single-consumer triple buffer. The writer fills
+// Back() and publishes it with one atomic exchange; the reader swaps in the
+// newest published slot. Neither side ever waits for the other, and the reader
+// simply keeps its current slot when nothing new was published.
+template <typename T>
+class TripleBuffer
+{
+public:
+	// Writer side: fill every field of Back(), then Publish()
+	[[nodiscard]] T& Back() { return slots_[back_]; }
+	void Publish()
+	{
+		back_ = middle_.exchange(static_cast<uint8_t>(back_ | fresh_bit), std::memory_order_acq_rel) & index_mask;
+	}
+
+	// Reader side: returns true if a newer slot was swapped in
+	bool Update()
+	{
+		if ((middle_.load(std::memory_order_relaxed) & fresh_bit) == 0)
+			return false;
+		front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+		return true;
+	}
+	[[nodiscard]] const T& Front() const { return slots_[front_]; }
+
+private:
+	static constexpr uint8_t index_mask = 0x3;
+	static constexpr uint8_t fresh_bit = 0x4;     // set in middle_ when it holds an unread slot
+
+	std::array<T, 3> slots_{};
+	uint8_t back_ = 0;                              // writer-owned
+	alignas(64) std::atomic<uint8_t> middle_{ 1 };
+	alignas(64) uint8_t front_ = 2;                 // reader-owned
+};
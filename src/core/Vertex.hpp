@@ -1,5 +1,5 @@
 #pragma once
-#include "../precompiled.h"
+#include "../headless.h"
 #include <glm/gtx/hash.hpp>
 
 struct Vertex
@@ -7,7 +7,6 @@ struct Vertex
 	glm::vec3 position;
 	glm::vec3 normal;
 	glm::vec2 uv;
-	int material_id;
 
 	bool operator==(const Vertex& other) const
 	{
@@ -17,13 +16,32 @@ struct Vertex
 	}
 };
 
+// Compact GPU layout used by baked models (16 bytes vs 32 for Vertex)
+struct PackedVertex
+{
+	int16_t position[4];	// snorm16 within the mesh bounds, w is padding
+	int16_t normal[2];		// octahedral-encoded unit normal, snorm16
+	uint16_t uv[2];			// half floats
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+// Maps PackedVertex positions back to model space: p = q * scale + offset
+struct VertexQuantization
+{
+	glm::vec3 scale{ 1.0f };
+	glm::vec3 offset{ 0.0f };
+};
+
 template<>
 struct std::hash<Vertex>
 {
 	size_t operator()(const Vertex& v) const noexcept
 	{
-		return std::hash<glm::vec3>()(v.position)
-			^ std::hash<glm::vec3>()(v.normal)
-			^ std::hash<glm::vec2>()(v.uv);
+		// boost-style combine: plain XOR collapses symmetric inputs (e.g. pos == normal)
+		size_t seed = std::hash<glm::vec3>()(v.position);
+		seed ^= std::hash<glm::vec3>()(v.normal) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+		seed ^= std::hash<glm::vec2>()(v.uv) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+		return seed;
 	}
 };
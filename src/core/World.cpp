@@ -1,12 +1,13 @@
 ﻿#include "../precompiled.h"
 #include "World.hpp"
 #include "../Config.hpp"
-#include "../interface/Camera.hpp"
 #include "../core/Loader.hpp"
 #include "../objects/Ball.hpp"
-#include "../gameplay/GameState.hpp"
 #include "Logger.hpp"
 
+#include <cstring>
+#include <filesystem>
+
 
 /**
  * Intersect the ray with plane y=0, which is the top mesh of your table.
@@ -28,28 +29,77 @@ static std::pair<bool, glm::vec3> RayIntersectTablePlane(const glm::vec3& rayOri
 	return { true, point };
 }
 
-World::World(std::shared_ptr<CueBallMap> cue_ball_map, Camera& camera) :
-	table_(std::make_shared<Table>()),
-	cue_(std::make_shared<Cue>(cue_ball_map)),
-	camera_(camera),
-	ceiling_(std::make_shared<Ceiling>(Config::ceiling_path, glm::vec3(0.0f, 1.48f, 0.04f), glm::vec3(0.4f), glm::vec3(0.0f, 1.0f, 0.0f)))
+namespace
 {
+	// Autosave file: this header, then the snapshot bytes. Only ever read back by
+	// the same build, which the size check stands in for
+	struct AutosaveHeader
+	{
+		uint32_t magic = 0x53504238;   // "8BPS"
+		uint32_t version = 3;
+		uint32_t size = sizeof(TableSimulation::Snapshot);
+
+		bool operator== (const AutosaveHeader&) const = default;
+	};
 
-	for (int n = 0; n < 16; n++)
+	// The file's byte for a bool field is 0 or 1; looked at as a byte, so any other
+	// value is caught before it is ever read as a bool
+	bool IsBool(const bool& flag)
 	{
-		balls_.push_back(std::make_shared<Ball>(n));
-		balls_[n]->Translate(glm::vec3{ 0.0f, Ball::radius_, 0.0f });
+		unsigned char byte;
+		std::memcpy(&byte, &flag, 1);
+		return byte <= 1;
 	}
 
-    // mixing balls
-	balls_[5].swap(balls_[8]);
-	balls_[5].swap(balls_[15]);
+	bool IsFinite(const glm::vec3& v) { return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z); }
+	bool IsFinite(const glm::vec2& v) { return std::isfinite(v.x) && std::isfinite(v.y); }
 
-	auto rd = std::random_device{};
-	auto rng = std::default_random_engine{ rd() };
-	std::shuffle(balls_.begin() + 1, balls_.end() - 1, rng);
+	// Slots hold every ball number once, the cue ball in slot 0
+	bool IsValidRack(const TableSimulation::Snapshot& snapshot)
+	{
+		std::array<bool, TableSimulation::ball_count> seen{};
+		for (const BallBody& ball : snapshot.balls) {
+			if (ball.number < 0 || ball.number >= TableSimulation::ball_count || seen[ball.number])
+				return false;
+			seen[ball.number] = true;
+		}
+		return snapshot.balls[0].number == 0;
+	}
 
-	balls_[5].swap(balls_[15]);
+	// Everything Restore takes as it is: flags, finite motion and the game state's ranges
+	bool IsValidSnapshot(const TableSimulation::Snapshot& snapshot)
+	{
+		if (!IsValidRack(snapshot))
+			return false;
+		for (const BallBody& ball : snapshot.balls) {
+			if (!IsBool(ball.in_hole) || !IsBool(ball.drawn) || !IsFinite(ball.position) || !IsFinite(ball.velocity) ||
+				!IsFinite(ball.spin) || !IsFinite(ball.last_dir) || !IsFinite(ball.hole))
+				return false;
+		}
+		const TickDamping& damping = snapshot.damping;
+		if (!std::isfinite(damping.dt) || !std::isfinite(damping.linear) || !std::isfinite(damping.angular))
+			return false;
+
+		const GameState::Snapshot& state = snapshot.state;
+		const auto is_group = [](const int group) { return group >= -1 && group <= 1; };
+		return IsBool(state.is_game_over) && IsBool(state.is_first_shot) && IsBool(state.is_after_break) &&
+			IsBool(state.check_game_rules) && IsBool(state.ball_in_hand) &&
+			state.current_player_index >= 0 && state.current_player_index <= 1 && state.winner >= -1 && state.winner <= 1 &&
+			is_group(state.player1_ball_type) && is_group(state.player2_ball_type) &&
+			state.shot_clock >= 0.0f && state.shot_clock <= GameState::SHOT_CLOCK_MAX &&
+			state.scores[0] >= 0 && state.scores[1] >= 0;
+	}
+}
+
+World::World() :
+	table_(std::make_shared<Table>()),
+	cue_(std::make_shared<Cue>()),
+	ceiling_(std::make_shared<Ceiling>(Config::ceiling_path, glm::vec3(0.0f, 1.48f, 0.04f), glm::vec3(0.4f), glm::vec3(0.0f, 1.0f, 0.0f)))
+{
+
+	for (int number = 0; number < TableSimulation::ball_count; ++number)
+		balls_.push_back(std::make_shared<Ball>(number));
+	FollowBodies();
 
 	// Initialize lights
 	InitializeLights();
@@ -103,414 +153,443 @@ void World::ToggleLight(int index) {
 	}
 }
 
-void World::Draw(const std::shared_ptr<Shader>& shader) const
+void World::Draw(const std::shared_ptr<Shader>& shader, const WorldSnapshot& snapshot)
 {
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	table_->Draw(shader);
+	table_->Submit(queue_, *shader);
 
-	if (AreBallsInMotion())
-		cue_->PlaceAtBall(balls_[0]);
-	else
-		cue_->Draw(shader);
+	if (!snapshot.balls_in_motion)
+		cue_->Submit(queue_, *shader);
 
-	for (const auto& ball : balls_)
-		if (ball->IsDrawn())
-			ball->Draw(shader);
+	for (int i = 0; i < WorldSnapshot::ball_count; ++i)
+		if (snapshot.ball_drawn[i])
+			balls_[snapshot.ball_numbers[i]]->Submit(queue_, *shader);
 
 	// Draw Ceiling
-	ceiling_->Draw(shader);
+	ceiling_->Submit(queue_, *shader);
 
 	// Draw lights
 	for (const auto& light : lights_) {
-		light->Draw(shader);
+		light->Submit(queue_, *shader);
 	}
 
+	queue_.Flush();
 	glDisable(GL_BLEND);
 }
 
-
-void World::Update(float dt, bool in_game)
+void World::DrawShadowCasters(const std::shared_ptr<Shader>& shader, const WorldSnapshot& snapshot,
+	const Frustum& light_frustum, const glm::vec3& light_position)
 {
-	state_.TickMessage(dt);
-	if (state_.IsGameOver()) return;
-
-
-	if (in_game) {
-		if (state_.TickShotClock(dt)) {
-			state_.SetMessage("Foul! Shot clock expired.", 1.2f);
-			state_.SetBallInHand(true);
-			state_.SwitchTurn(balls_[0]->IsDrawn());
-		}
-
-
-		if (state_.BallInHand()) {
-			PlaceCueBallWithMouse();
-		}
-		else {
-			cue_->HandleShot(balls_[0], dt);
-		}
-	}
-
-	// NEW — start of shot happens exactly when we first see movement
-	// and we are NOT already in a shot (i.e., rules aren't pending yet).
-	bool movingNow = AreBallsInMotion();
-	if (movingNow && !state_.CheckRulesPending()) {
-		state_.StartNewTurn();              // clears transients ONCE per shot
-		state_.SetCheckRulesPending(true);  // we are now "in a shot"
-	}
-
-
-	for (int i = 0; i < (int)balls_.size(); ++i) {
-		balls_[i]->Roll(dt);
+	auto cast = [&](const Object& object) {
+		if (light_frustum.Intersects(bounds_[object.GetTransformIndex()]))
+			object.Submit(queue_, *shader);
+	};
 
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-		if (balls_[i]->IsInHole(table_->GetHoles(), Table::hole_radius_))
-			HandleHolesFall(i);
-		else
-			HandleBoundsCollision(i);
+	cast(*table_);
 
+	if (!snapshot.balls_in_motion)
+		cast(*cue_);
 
-		if (!balls_[i]->IsInHole(table_->GetHoles(), Table::hole_radius_))
-			balls_[i]->translation_.y = Ball::radius_;
+	for (int i = 0; i < WorldSnapshot::ball_count; ++i)
+		if (snapshot.ball_drawn[i])
+			cast(*balls_[snapshot.ball_numbers[i]]);
 
+	cast(*ceiling_);
 
-		HandleBallsCollision(i);
-	}
+	for (const auto& light : lights_)
+		if (!bounds_[light->GetTransformIndex()].Contains(light_position))
+			cast(*light);
 
-	// --- record pocket events for THIS shot (edge: drawn -> not drawn) ---
-	for (int i = 1; i <= 15; ++i) {
-		bool nowDrawn = balls_[i]->IsDrawn();
-		if (wasDrawn_[i] && !nowDrawn) {
-			state_.NotePocketedThisShot(balls_[i]->GetNumber());
-		}
-		wasDrawn_[i] = nowDrawn;
-	}
+	queue_.Flush();
+	glDisable(GL_BLEND);
+}
 
+void World::UpdateTransforms(const WorldSnapshot& snapshot)
+{
+	transforms_.Clear();
+	bounds_.clear();
 
-	if (!AreBallsInMotion()) {
-		if (state_.CheckRulesPending()) {
-			// pocket list was filled during this shot -> safe to evaluate
-			rules_.EvaluateEndOfShot(balls_, state_);
-			state_.SetCheckRulesPending(false);  // shot closed
-		}
-	}
-}
+	// Balls and cue come from the snapshot; their live state belongs to the simulation thread
+	auto assign = [this](Object& object, const glm::mat4& model) {
+		object.SetTransformIndex(transforms_.Push(model));
+		bounds_.push_back(object.GetBounds(model));
+	};
 
+	assign(*table_, table_->GetModelMatrix());
+	assign(*cue_, snapshot.cue_matrix);
+	for (int i = 0; i < WorldSnapshot::ball_count; ++i)
+		assign(*balls_[snapshot.ball_numbers[i]], snapshot.ball_matrices[i]);
+	assign(*ceiling_, ceiling_->GetModelMatrix());
+	for (const auto& light : lights_)
+		assign(*light, light->GetModelMatrix());
 
-bool World::AreBallsInMotion() const {
-	for (const auto& b : balls_) if (b->IsInMotion()) return true; return false;
+	transforms_.Upload(Config::transform_buffer_binding);
 }
 
-// small local helper : 0 = solids, 1 = stripes, -1 = neither(cue / 8)
-static int BallTypeFromNumber(int num) {
-	if (num >= 1 && num <= 7)  return 0;
-	if (num >= 9 && num <= 15) return 1;
-	return -1; // cue (0) or eight (8)
+void World::WriteSnapshot(WorldSnapshot& snapshot) const
+{
+	for (int i = 0; i < WorldSnapshot::ball_count; ++i)
+	{
+		const BallBody& body = physics_.Balls()[i];
+		snapshot.ball_numbers[i] = body.number;
+		snapshot.ball_matrices[i] = balls_[body.number]->GetModelMatrix();
+		snapshot.ball_positions[i] = body.position;
+		snapshot.ball_drawn[i] = body.drawn;
+		snapshot.legal_targets[i] = IsLegalAimTarget(i);
+	}
+	snapshot.balls_in_motion = AreBallsInMotion();
+
+	snapshot.cue_matrix = cue_->GetModelMatrix();
+	snapshot.aim_dir = cue_->AimDir();
+	snapshot.trajectory = preview_.Paths();
+
+	const GameState& state = physics_.State();
+	snapshot.players = state.Players();
+	snapshot.current_player = state.CurrentPlayerIndex();
+	snapshot.shot_clock = state.ShotClock();
+	snapshot.game_over = state.IsGameOver();
+	snapshot.message = state.Message();
 }
 
-bool World::IsLegalAimTarget(int hitIdx) const
+void World::Update(float dt, const SimulationInput& input)
 {
-	// Defensive: out of range or not actually on table => don't warn
-	if (hitIdx <= 0 || hitIdx >= static_cast<int>(balls_.size())) return true;
-	if (!balls_[hitIdx]->IsDrawn()) return true;
-
-	const GameState& s = state_;           // your game state
-	const bool onBreak = s.IsAfterBreak();
-	const bool tableOpen = s.IsFirstShot(); // “open table” after break until groups assigned
-	const int  curGroup = s.CurrentPlayerGroup(); // -1 when not assigned yet
-
-	// On the break: any first contact is allowed (color = yellow)
-	if (onBreak) return true;
-
-	const int num = balls_[hitIdx]->GetNumber();
-
-	// Open table (post-break before assignment): everything but the 8 is allowed
-	if (tableOpen) return (num != 8);
-
-	// Defensive: groups should be assigned if tableOpen==false, but guard anyway
-	if (curGroup == -1) return true;
-
-	// If aiming at the 8: only legal if your group is completely cleared
-	if (num == 8) {
-		bool cleared = true;
-		for (size_t k = 1; k < balls_.size(); ++k) {
-			if (!balls_[k]->IsDrawn()) continue;           // pocketed
-			const int n = balls_[k]->GetNumber();
-			if (n == 0 || n == 8) continue;                // cue / eight
-			if (BallTypeFromNumber(n) == curGroup) {       // still one of yours left
-				cleared = false; break;
+	GameState& state = physics_.State();
+
+	state.TickMessage(dt);
+	if (session_)
+		PollSession();
+
+	// In a lockstep match only the side whose turn it is aims, places and runs the
+	// clock; the opponent's decisions come in through PollSession
+	const bool in_game = input.in_game && IsLocalTurn();
+	if (!state.IsGameOver()) {
+		if (in_game) {
+			// The clock stops while a shot plays out, so it expires on a table at rest
+			const bool at_rest = !physics_.AreBallsInMotion() && !state.CheckRulesPending();
+			if (at_rest && physics_.TickShotClock(dt))
+				SendToPeer({ .type = LockstepMessage::Type::ClockExpired });
+
+			if (state.BallInHand()) {
+				PlaceCueBallWithMouse(input);
+			}
+			else {
+				// Only kept if this tick strikes the ball
+				TableSimulation::Snapshot before;
+				if (input.shoot)
+					physics_.Save(before);
+
+				if (cue_->HandleShot(physics_.CueBall(), dt, input)) {
+					retake_ = before;
+					has_retake_ = true;
+					SendToPeer({ .type = LockstepMessage::Type::Shot,
+						.velocity = physics_.CueBall().velocity, .spin = physics_.CueBall().spin });
+				}
 			}
 		}
-		return cleared;
+
+		// The quick setup menu tunes the ball model between shots; a match keeps the physics it started with
+		if (!session_ && !physics_.AreBallsInMotion())
+			physics_.SetParams(tuning_);
+
+		const bool shot_open = state.CheckRulesPending();
+		physics_.Step(dt);
+		if (shot_open && !state.CheckRulesPending()) {
+			stats_.Record(physics_.Events(), dt);
+			if (state.IsGameOver())
+				LOG_INFO(General, "Rack over. " + stats_.Summary());
+			ReportShot();
+			WriteAutosave();
+		}
+
+		// The cue follows the white ball while the table is live
+		if (physics_.AreBallsInMotion())
+			cue_->PlaceAtBall(physics_.CueBall());
 	}
 
-	// Normal case: legal iff ball type matches your group
-	return BallTypeFromNumber(num) == curGroup;
-}
+	// Aiming guide: the shot as the cue is lined up now, played out on a copy of the
+	// table a budget of ticks at a time (kept while aim, stroke and table stay put)
+	if (in_game && input.guideline && !state.IsGameOver() && !state.BallInHand() &&
+		!physics_.AreBallsInMotion() && !state.CheckRulesPending()) {
+		preview_.Aim(physics_, cue_->ShotVelocity(physics_.CueBall(), input.strike_force), input.spin);
+		preview_.Advance(dt, Config::trajectory_tick_budget, Config::trajectory_bounces);
+	}
+	else
+		preview_.Reset();
 
-void World::NotePocketedThisShot(int ballNumber) {
-	state_.NotePocketedThisShot(ballNumber);
+	FollowBodies();
 }
 
-GameState& World::State() {
-	return state_;
+void World::FollowBodies()
+{
+	for (const BallBody& body : physics_.Balls())
+		balls_[body.number]->Follow(body);
 }
 
 void World::Init() {
-	balls_[0]->Translate(glm::vec3(0.8f, 0.0f, 0.0f));
-	cue_->translation_ = glm::vec3(0.0f);
-	cue_->angle_ = 0.0f;
-	cue_->Translate(glm::vec3(0.8f + Ball::radius_ + Config::min_change, Ball::radius_, 0.0f));
-	cue_->Rotate(glm::vec3(-0.1f, 1.0f, 0.0f), glm::pi<float>());
-
-
-	balls_[1]->Translate(glm::vec3(-0.8f + 2.0f * glm::root_three<float>() * Ball::radius_, 0.0f, 0.0f));
+	has_retake_ = false;
+	stats_.Reset();
+	physics_.Rack();
+	FollowBodies();
 
-	wasDrawn_.fill(true);
+	cue_->SetTranslation(glm::vec3(0.8f + Ball::radius_ + Config::min_change, Ball::radius_, 0.0f));
+	cue_->SetYaw(glm::pi<float>(), glm::vec3(-0.1f, 1.0f, 0.0f));
+}
 
 
-	glm::vec3 temp = balls_[1]->translation_;
-	int index = 2;
-	for (int i = 0; i < 4; ++i) {
-		temp.x -= glm::root_three<float>() * Ball::radius_;
-		temp.z -= Ball::radius_;
-		for (int j = 0; j < i + 2; ++j) {
-			balls_[index]->Translate(glm::vec3(temp.x, 0.0f, temp.z + j * (Ball::radius_ * 2.0f)));
-			++index;
+void World::Reset() {
+	if (session_ && racks_ > 0) {
+		// Only the host picks racks, so both tables always take the same one. Either side
+		// asks on its own turn (or after the game), when the other one cannot be shooting
+		GameState& state = physics_.State();
+		const bool at_rest = !physics_.AreBallsInMotion() && !state.CheckRulesPending();
+		if (!state.IsGameOver() && !(IsLocalTurn() && at_rest)) {
+			state.SetMessage("Re-rack on your turn.", 1.5f);
+			return;
+		}
+		if (session_->LocalPlayer() == 0) {
+			Rerack();
+			return;
 		}
+		// Nothing is played here until the host's rack comes in
+		SendToPeer({ .type = LockstepMessage::Type::RackRequest });
+		rack_requested_ = true;
+		state.SetMessage("Waiting for the new rack...", 2.0f);
+		return;
 	}
+	Init();
 }
 
-
-void World::Reset() {
-	for (const auto& ball : balls_) { ball->TakeFromHole(); ball->SetDrawn(true); }
-	Init();
-	wasDrawn_.fill(true);
+void World::Rerack() {
+	const LockstepMessage rack{ .type = LockstepMessage::Type::NewRack, .seed = std::random_device{}() };
+	SendToPeer(rack);
+	StartMatch(rack.seed, physics_.Damping());
 }
 
 
 void World::ResetGame() {
-	for (auto& p : state_.Players()) p.ResetScore();
-	state_.SetShotClock(GameState::SHOT_CLOCK_MAX);
-	state_.ResetPlayerIndex();
+	if (session_ && racks_ > 0)
+		return;   // a lockstep rack starts scores and turns over on both sides (StartMatch)
+	GameState& state = physics_.State();
+	for (auto& p : state.Players()) p.ResetScore();
+	state.SetShotClock(GameState::SHOT_CLOCK_MAX);
+	state.ResetPlayerIndex();
 }
 
 
 void World::UpdatePlayerNames(const std::string& p1, const std::string& p2) {
-	auto& ps = state_.Players();            // you already use this in ResetGame()
+	auto& ps = physics_.State().Players();
 	if (ps.size() >= 1) ps[0].SetName(p1);
 	if (ps.size() >= 2) ps[1].SetName(p2);
 }
 
 
-void World::HandleBallsCollision(const int number)
+void World::PlaceCueBallWithMouse(const SimulationInput& input)
 {
-	for (int j = number + 1; j < (int)balls_.size(); ++j) {
-		const auto& a = balls_[number];
-		const auto& b = balls_[j];
-
-
-		bool cueCollisionHappened = false;
-		if (number == 0 || j == 0) {
-			float distance = glm::length(a->translation_ - b->translation_);
-			float collisionDistance = 2.0f * Ball::radius_;
-			if (distance <= (collisionDistance + 1e-4f)) cueCollisionHappened = true;
-		}
+	// Mouse ray is built by the render thread (it owns the camera)
+	auto [hit, intersect] = RayIntersectTablePlane(input.mouse_ray_origin, input.mouse_ray_dir);
+	if (!hit) return;
 
 
-		a->CollideWith(b);
+	const LockstepMessage placement{ .type = LockstepMessage::Type::PlaceCueBall, .position = { intersect.x, intersect.z } };
+	if (!physics_.PlaceCueBall(intersect)) {
+		SendToPeer(placement);   // the foul passes the turn on both tables
+		return;
+	}
+	cue_->PlaceAtBall(physics_.CueBall());
 
 
-		if (cueCollisionHappened && (number == 0 || j == 0)) {
-			int obj = (number == 0 ? j : number);
-			if (obj != 0) state_.MarkCueContact(obj);
-		}
+	if (input.place_button) {
+		place_pressed_ = true;
+	}
+	else if (place_pressed_) {
+		place_pressed_ = false;
+		physics_.ConfirmCueBall();
+
+		// Positions before the release never leave this side: they change nothing lasting
+		LockstepMessage confirmed = placement;
+		confirmed.confirm = true;
+		SendToPeer(confirmed);
 	}
 }
 
-
-void World::HandleHolesFall(const int number) 
+void World::RetakeShot()
 {
-	if (!AreBallsInMotion()) {
-		// about to remove it from the table -> record the pocket ONCE
-		if (balls_[number]->IsDrawn()) {
-			// cue ball (0) is handled as a foul later; we still mark others
-			if (number != 0) {
-				state_.NotePocketedThisShot(balls_[number]->GetNumber());
-			}
-			balls_[number]->SetDrawn(false);
-			if (number >= 1 && number <= 15) {
-				wasDrawn_[number] = false;   // prevent double edge later
-			}
-		}
-
-		if (number == 0) {
-			state_.SetBallInHand(true);
-			state_.SetMessage("Foul! Scratch — ball in hand.", 1.2f);
-		}
+	// Both tables have to agree in a lockstep match
+	if (session_ || !has_retake_)
 		return;
-	}
-
-	// still moving → keep the existing sink animation/physics
-	balls_[number]->HandleGravity(Table::hole_bottom_);
-
-	const auto p2 = glm::vec2(balls_[number]->translation_.x, balls_[number]->translation_.z);
-	const auto h2 = glm::vec2(balls_[number]->GetHole().x, balls_[number]->GetHole().z);
 
-	const glm::vec2 dir = glm::normalize(p2 - h2);
-	const float distance = glm::distance(p2, h2);
-
-	if (distance > Table::hole_radius_ - Ball::radius_)
-		balls_[number]->BounceOffHole(-dir, Table::hole_radius_);
+	physics_.Restore(retake_);
+	has_retake_ = false;
+	place_pressed_ = false;
+	FollowBodies();
+	cue_->PlaceAtBall(physics_.CueBall());
+	physics_.State().SetMessage("Shot retaken.", 1.2f);
 }
 
-
-void World::HandleBoundsCollision(const int number) 
+void World::WriteAutosave() const
 {
-	const auto ball_pos = balls_[number]->translation_;
-	constexpr auto hole_edge_z = 0.7f - Table::hole_radius_ - Ball::radius_;
-	constexpr auto hole_edge_x = 1.35f - Table::hole_radius_ - Ball::radius_;
+	if (session_)
+		return;
 
-	// X-bounds
-	if (ball_pos.x >= Table::bound_x_ && ball_pos.z < hole_edge_z && ball_pos.z > -hole_edge_z)
-	{
-		balls_[number]->BounceOffBound(glm::vec3(-1.0f, 0.0f, 0.0f), Table::bound_x_, Table::bound_z_);
-		state_.MarkRailContact();
-	}
-	else if (ball_pos.x <= -Table::bound_x_ && ball_pos.z < hole_edge_z && ball_pos.z > -hole_edge_z)
-	{
-		balls_[number]->BounceOffBound(glm::vec3(1.0f, 0.0f, 0.0f), Table::bound_x_, Table::bound_z_);
-		state_.MarkRailContact();
-	}
-	// Z-bounds
-	else if (ball_pos.z >= Table::bound_z_ &&
-		((ball_pos.x < hole_edge_x && ball_pos.x > Table::hole_radius_) ||
-			(ball_pos.x > -hole_edge_x && ball_pos.x < -Table::hole_radius_)))
-	{
-		balls_[number]->BounceOffBound(glm::vec3(0.0f, 0.0f, -1.0f), Table::bound_x_, Table::bound_z_);
-		state_.MarkRailContact();
-	}
-	else if (ball_pos.z <= -Table::bound_z_ &&
-		((ball_pos.x < hole_edge_x && ball_pos.x > Table::hole_radius_) ||
-			(ball_pos.x > -hole_edge_x && ball_pos.x < -Table::hole_radius_)))
+	const std::filesystem::path path = Config::autosave_path;
+	auto tmp_path = path;
+	tmp_path += ".tmp";
+
+	const AutosaveHeader header;
+	const TableSimulation::Snapshot snapshot = physics_.Save();
 	{
-		balls_[number]->BounceOffBound(glm::vec3(0.0f, 0.0f, 1.0f), Table::bound_x_, Table::bound_z_);
-		state_.MarkRailContact();
+		std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(&snapshot), sizeof(snapshot));
+		if (!out) {
+			LOG_WARNING(General, "Could not write " + tmp_path.string());
+			return;
+		}
 	}
+
+	// Renamed over the last one, so a crash mid-write never leaves a torn autosave
+	std::error_code ec;
+	std::filesystem::rename(tmp_path, path, ec);
+	if (ec)
+		std::filesystem::remove(tmp_path, ec);
 }
 
-/**
- * If user tries to put ball into hole radius, push it out
- */
-glm::vec3 World::ClampCueBallPosition(const glm::vec3& desiredPos) const
+void World::LoadAutosave()
 {
-	glm::vec3 pos = desiredPos;
-
-	// 1) Check corners/pockets with your existing logic
-	float hole_edge_x = (Table::bound_x_ - Table::hole_radius_ - Ball::radius_);
-	float hole_edge_z = (Table::bound_z_ - Table::hole_radius_ - Ball::radius_);
+	if (session_)
+		return;
 
-	// Right cushion region
-	if (pos.x >= Table::bound_x_ &&
-		(pos.z < hole_edge_z && pos.z > -hole_edge_z))
-	{
-		pos.x = Table::bound_x_;
-	}
-	else if (pos.x <= -Table::bound_x_ &&
-		(pos.z < hole_edge_z && pos.z > -hole_edge_z))
-	{
-		pos.x = -Table::bound_x_;
-	}
-	else if (pos.z >= Table::bound_z_ &&
-		((pos.x < hole_edge_x && pos.x > Table::hole_radius_) ||
-			(pos.x > -hole_edge_x && pos.x < -Table::hole_radius_)))
-	{
-		pos.z = Table::bound_z_;
-	}
-	else if (pos.z <= -Table::bound_z_ &&
-		((pos.x < hole_edge_x && pos.x > Table::hole_radius_) ||
-			(pos.x > -hole_edge_x && pos.x < -Table::hole_radius_)))
-	{
-		pos.z = -Table::bound_z_;
-	}
-	else
-	{
-		// simple clamp if not in corner range
-		pos.x = glm::clamp(pos.x, -Table::bound_x_, Table::bound_x_);
-		pos.z = glm::clamp(pos.z, -Table::bound_z_, Table::bound_z_);
+	AutosaveHeader header{};
+	TableSimulation::Snapshot snapshot;
+	std::ifstream in(Config::autosave_path, std::ios::in | std::ios::binary);
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+	in.read(reinterpret_cast<char*>(&snapshot), sizeof(snapshot));
+	if (!in || header != AutosaveHeader{} || !IsValidSnapshot(snapshot)) {
+		physics_.State().SetMessage("No autosave to restore.", 1.2f);
+		return;
 	}
 
-	// 2) Additionally, block holes. If distance < Table::hole_radius_ + Ball::radius_, push it out
-	for (auto& hCenter : table_->GetHoles())
-	{
-		glm::vec2 p2d(pos.x, pos.z);
-		glm::vec2 h2d(hCenter.x, hCenter.z);
-
-		float dist = glm::distance(p2d, h2d);
-		float minDist = Table::hole_radius_ + Ball::radius_;
-
-		if (dist < minDist)
-		{
-			// push pos out along direction from hole -> pos
-			glm::vec2 dir2d = glm::normalize(p2d - h2d);
-			glm::vec2 new2d = h2d + dir2d * minDist;
-			pos.x = new2d.x;
-			pos.z = new2d.y;
-		}
-	}
+	physics_.Restore(snapshot);
+	has_retake_ = false;
+	place_pressed_ = false;
+	FollowBodies();
+	cue_->PlaceAtBall(physics_.CueBall());
+	physics_.State().SetMessage("Autosave restored.", 1.2f);
+	LOG_INFO(General, std::string("Restored ") + Config::autosave_path);
+}
 
-	return pos;
+void World::OpenSession(const LockstepOptions& options)
+{
+	const float dt = 1.0f / static_cast<float>(Config::simulation_rate);
+	session_ = LockstepSession::Open(options, TickDamping::For(dt, physics_.Params()));
+	racks_ = 0;
 }
 
-void World::PlaceCueBallWithMouse()
+void World::PollSession()
 {
-	GLFWwindow* window = glfwGetCurrentContext(); if (!window) return;
+	GameState& state = physics_.State();
+	if (session_->IsClosed()) {
+		LOG_WARNING(General, "Lockstep: lost the opponent, the match continues locally");
+		state.SetMessage("Opponent disconnected.", 3.0f);
+		session_.reset();
+		return;
+	}
 
+	// However far this side runs behind, a decision lands on the same resting table
+	while (!physics_.AreBallsInMotion() && !state.CheckRulesPending()) {
+		const std::optional<LockstepMessage> message = session_->Poll();
+		if (!message)
+			break;
+		ApplyRemote(*message);
+	}
 
-	double mouseX, mouseY; glfwGetCursorPos(window, &mouseX, &mouseY);
-	int screenW, screenH; glfwGetWindowSize(window, &screenW, &screenH);
+	if (racks_ == 0)
+		state.SetMessage("Waiting for the opponent...", 1.0f);
+}
 
+void World::ApplyRemote(const LockstepMessage& message)
+{
+	switch (message.type) {
+	case LockstepMessage::Type::Hello:
+		StartMatch(message.seed, message.damping);
+		break;
+	case LockstepMessage::Type::NewRack:
+		StartMatch(message.seed, physics_.Damping());
+		break;
+	case LockstepMessage::Type::RackRequest:
+		Rerack();
+		break;
+	case LockstepMessage::Type::Shot:
+		physics_.CueBall().Shot(message.velocity, message.spin);
+		break;
+	case LockstepMessage::Type::PlaceCueBall:
+		if (physics_.PlaceCueBall(glm::vec3(message.position.x, Ball::radius_, message.position.y)) && message.confirm)
+			physics_.ConfirmCueBall();
+		cue_->PlaceAtBall(physics_.CueBall());
+		break;
+	case LockstepMessage::Type::ClockExpired:
+		physics_.ExpireShotClock();
+		break;
+	case LockstepMessage::Type::StateHash:
+		if (message.rack == racks_)
+			MatchHash(message.shot, message.hash);
+		break;
+	}
+}
 
-	auto [rayOrigin, rayDir] = camera_.GetMouseRay((float)mouseX, (float)mouseY, screenW, screenH);
-	auto [hit, intersect] = RayIntersectTablePlane(rayOrigin, rayDir);
-	if (!hit) return;
+void World::StartMatch(const uint32_t seed, const TickDamping& damping)
+{
+	const std::vector<Player> players = physics_.State().Players();
+	physics_ = TableSimulation(seed, physics_.Params());
+	physics_.ShareDamping(damping);
+	UpdatePlayerNames(players[0].GetName(), players[1].GetName());
+	Init();
 
+	++racks_;
+	shots_resolved_ = 0;
+	unmatched_hashes_.clear();
+	rack_requested_ = false;
+	place_pressed_ = false;
+	physics_.State().SetMessage(IsLocalTurn() ? "Your break." : "Opponent breaks.", 2.0f);
+}
 
-	glm::vec3 finalPos(intersect.x, Ball::radius_, intersect.z);
-	finalPos = ClampCueBallPosition(finalPos);
+void World::SendToPeer(const LockstepMessage& message) const
+{
+	if (session_)
+		session_->Send(message);
+}
 
+void World::ReportShot()
+{
+	if (!session_)
+		return;
 
-	auto& cueBall = balls_[0];
-	cueBall->TakeFromHole(); cueBall->SetDrawn(true); cueBall->Translate(finalPos);
+	const LockstepMessage report{ .type = LockstepMessage::Type::StateHash,
+		.rack = racks_, .shot = ++shots_resolved_, .hash = physics_.StateHash() };
+	SendToPeer(report);
+	MatchHash(report.shot, report.hash);
+}
 
+void World::MatchHash(const uint32_t shot, const uint64_t hash)
+{
+	// Each side reports every shot once; the first report waits for the other
+	const auto [entry, first] = unmatched_hashes_.try_emplace(shot, hash);
+	if (first)
+		return;
 
-	for (int i = 1; i < (int)balls_.size(); ++i) if (balls_[i]->IsDrawn()) {
-		float d = glm::distance(cueBall->translation_, balls_[i]->translation_);
-		if (d < 2.0f * Ball::radius_) {
-			state_.SetBallInHand(false);
-			state_.SetMessage("Foul! Illegal contact during ball-in-hand.", 1.2f);
-			state_.SwitchTurn(balls_[0]->IsDrawn());
-			state_.SetBallInHand(true);
-			return;
-		}
+	if (entry->second != hash) {
+		LOG_ERROR(General, std::format("Lockstep: tables differ after shot {} of rack {}", shot, racks_));
+		physics_.State().SetMessage("Out of sync with the opponent's table!", 3.0f);
 	}
+	unmatched_hashes_.erase(entry);
+}
 
-
-	HandleBoundsCollision(0);
-	cueBall->translation_.y = Ball::radius_;
-	cue_->PlaceAtBall(cueBall);
-
-
-	static bool wasPressed = false;
-	int mouseState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT);
-	if (mouseState == GLFW_PRESS) {
-		wasPressed = true;
-	}
-	else if (wasPressed) {
-		wasPressed = false;
-		state_.SetBallInHand(false);
-		state_.ResetShotClock();
-	}
+bool World::IsLocalTurn() const
+{
+	return !session_ || (racks_ > 0 && !rack_requested_ && physics_.State().CurrentPlayerIndex() == session_->LocalPlayer());
 }
@@ -7,33 +7,59 @@
 #include "../objects/Ball.hpp"
 #include "../objects/Ceiling.hpp"
 #include "Light.hpp"
-#include "../gameplay/GameState.hpp"
-#include "../gameplay/GameRules.hpp"
+#include "TransformBuffer.hpp"
+#include "RenderQueue.hpp"
+#include "Snapshot.hpp"
+#include "../physics/TableSimulation.hpp"
+#include "../gameplay/ShotStats.hpp"
+#include "../net/LockstepSession.hpp"
 
-// Forward declarations
-class CueBallMap;
-class Camera;
+#include <map>
 
 class World
 {
 public:
-	World(std::shared_ptr<CueBallMap> cue_ball_map, Camera& camera);
-
-	void Update(float dt, bool in_game);
-	void Draw(const std::shared_ptr<Shader>& shader) const;
+	World();
+
+	// --- simulation thread (see Simulation) ---
+	void Update(float dt, const SimulationInput& input);
+	void WriteSnapshot(WorldSnapshot& snapshot) const;
+
+	// --- render thread: only snapshot data, static objects and lights ---
+	// Gathers this frame's model matrices into the per-frame SSBO; call once
+	// before any pass (shadow or main) draws the world
+	void UpdateTransforms(const WorldSnapshot& snapshot);
+	// Both passes go through the render queue: sorted by state, then flushed once
+	void Draw(const std::shared_ptr<Shader>& shader, const WorldSnapshot& snapshot);
+	// Shadow pass for one light: only objects whose bounds reach 'light_frustum'. A lamp
+	// around the light itself is skipped, it would only shadow its own bulb
+	void DrawShadowCasters(const std::shared_ptr<Shader>& shader, const WorldSnapshot& snapshot,
+		const Frustum& light_frustum, const glm::vec3& light_position);
+	// World-space bounds of the table as of the last UpdateTransforms
+	[[nodiscard]] const BoundingSphere& GetTableBounds() const { return bounds_[table_->GetTransformIndex()]; }
 
 	// Initialization & Reset
 	void Init() ;
+	// In a lockstep match, on this side's turn only: the host re-racks, the guest asks it to
 	void Reset() ;
 
+	// Undo: the table as it was just before the last shot was struck (local play only)
+	void RetakeShot();
+	// Crash recovery: the table as of the last autosave (local play only)
+	void LoadAutosave();
+
+	// Plays a lockstep match as 'options' say (before the simulation starts): both
+	// sides run this same simulation and only exchange shots, placements and hashes.
+	// As the host, this table's ball model sets the damping of both. Throws on failure
+	void OpenSession(const LockstepOptions& options);
+
 	std::shared_ptr<Cue> GetCue() const { return cue_; }
 
-	//Collision Handling
-	void HandleBallsCollision(int number) ;
-	void HandleHolesFall(int number) ;
-	void HandleBoundsCollision(const int number) ;
+	// The ball model from the quick setup menu (posted by the render thread); the
+	// table takes it between shots, a lockstep match keeps the one it started with
+	void SetPhysicsTuning(const PhysicsParams& tuning) { tuning_ = tuning; }
 
-	[[nodiscard]] bool AreBallsInMotion() const;
+	[[nodiscard]] bool AreBallsInMotion() const { return physics_.AreBallsInMotion(); }
 
 	// Add method to toggle lights
 	void ToggleLight(int index); 
@@ -42,39 +68,49 @@ public:
 	const std::vector<std::shared_ptr<Light>>& GetLights() const { return lights_; }
 
 	// HUD accessors from gameplay state
-	const std::vector<Player>& GetPlayers() const { return state_.Players(); }
-	int GetCurrentPlayerIndex() const { return state_.CurrentPlayerIndex(); }
+	const std::vector<Player>& GetPlayers() const { return physics_.State().Players(); }
+	int GetCurrentPlayerIndex() const { return physics_.State().CurrentPlayerIndex(); }
 
 
-	void ResetPlayerIndex() { state_.ResetPlayerIndex(); }
+	void ResetPlayerIndex() { if (!session_) physics_.State().ResetPlayerIndex(); }   // a match fixes the order
 	void UpdatePlayerNames(const std::string& p1, const std::string& p2);
 	void ResetGame();
 
 
-	float GetShotClock() const { return state_.ShotClock(); }
-	bool IsGameOver() const { return state_.IsGameOver(); }
-	std::string GetMessage() const { return state_.Message(); }
-
-
-	// expose balls for rules module
-	const std::vector<std::shared_ptr<Ball>>& GetBalls() const { return balls_; }
+	float GetShotClock() const { return physics_.State().ShotClock(); }
+	bool IsGameOver() const { return physics_.State().IsGameOver(); }
+	std::string GetMessage() const { return physics_.State().Message(); }
 
 	// True if the current player is allowed to *first-contact* ball 'hitIdx'
-	bool IsLegalAimTarget(int hitIdx) const;
+	bool IsLegalAimTarget(int hitIdx) const { return physics_.IsLegalAimTarget(hitIdx); }
 
-	void NotePocketedThisShot(int ballNumber);
-	GameState& State();           // optional helper if you want direct access
+	GameState& State() { return physics_.State(); }
 
 private:
 	void InitializeLights();
 
 
 	// Input helper
-	void PlaceCueBallWithMouse();
-	glm::vec3 ClampCueBallPosition(const glm::vec3& desiredPos) const;
+	void PlaceCueBallWithMouse(const SimulationInput& input);
 
+	// Drawn balls take their position and drawn state from the physics bodies
+	void FollowBodies();
 
-	Camera& camera_;
+	// Written after every shot; a crash loses at most the shot in progress
+	void WriteAutosave() const;
+
+	// --- lockstep ---
+	// Applies the opponent's decisions once the table is at rest, as it was when they made them
+	void PollSession();
+	void ApplyRemote(const LockstepMessage& message);
+	// New rack from a seed both sides know; scores and turn order start over
+	void StartMatch(uint32_t seed, const TickDamping& damping);
+	// Host only: picks a new rack, sends it and starts it
+	void Rerack();
+	void SendToPeer(const LockstepMessage& message) const;
+	void ReportShot();
+	void MatchHash(uint32_t shot, uint64_t hash);
+	[[nodiscard]] bool IsLocalTurn() const;
 
 
 	std::shared_ptr<Table> table_ = nullptr;
@@ -83,8 +119,25 @@ private:
 	std::vector<std::shared_ptr<Light>> lights_{};
 	std::shared_ptr<Ceiling> ceiling_ = nullptr;
 
-	std::array<bool, 16> wasDrawn_{ };   // track drawn state per ball (1..15)
+	TransformBuffer transforms_{};
+	std::vector<BoundingSphere> bounds_{};   // world space, per transform slot
+	RenderQueue queue_{};
+
+	// Balls, rules and game state; balls_ are indexed by ball number, not slot
+	TableSimulation physics_{ std::random_device{}() };
+	PhysicsParams tuning_{};        // see SetPhysicsTuning
+	TrajectoryPreview preview_{};   // the lined-up shot played ahead, for the aiming guide
+
+	bool place_pressed_ = false;   // ball in hand: placement button held
+
+	ShotStats stats_{};            // shots of the current rack
+
+	TableSimulation::Snapshot retake_{};   // just before the last shot
+	bool has_retake_ = false;
 
-	GameState state_{};
-	GameRules rules_{};
+	std::unique_ptr<LockstepSession> session_ = nullptr;
+	uint32_t racks_ = 0;                                  // matches started in this session
+	uint32_t shots_resolved_ = 0;                         // on the current rack
+	bool rack_requested_ = false;                         // guest: asked the host for a new rack, not here yet
+	std::map<uint32_t, uint64_t> unmatched_hashes_{};     // shot -> hash, until the other side's arrives
 };
\ No newline at end of file
@@ -1,36 +1,38 @@
-﻿#include "../precompiled.h"
+﻿#include "../headless.h"
 #include "GameRules.hpp"
 #include "GameState.hpp"
-#include "../objects/Ball.hpp"
 
 
-// 0 = solids, 1 = stripes, -1 = neither (cue=0, eight=8)
-static int BallTypeFromNumber(int num) {
-    if (num >= 1 && num <= 7)  return 0;
-    if (num >= 9 && num <= 15) return 1;
-    return -1;
-}
-
-
-
-bool GameRules::AreAllGroupBallsPocketed(const std::vector<std::shared_ptr<Ball>>& balls, int groupType)
+GameRules::Foul GameRules::EvaluateEndOfShot(std::span<const BallBody> balls, const RackMask& rack,
+    std::span<const ShotEvent> events, GameState& s)
 {
-    if (groupType == -1) return false;
-    for (size_t k = 1; k < balls.size(); ++k) {
-        if (!balls[k]->IsDrawn()) continue;                 // already pocketed -> ignore
-        int num = balls[k]->GetNumber();
-        if (num == 0 || num == 8) continue;                 // ignore cue / eight
-        if (BallTypeFromNumber(num) == groupType) return false; // still on table
+    if (s.IsGameOver()) return Foul::None;
+
+    // What the shot did: first ball the cue ball touched, any cushion, object balls pocketed
+    int firstIdx = -1;                  // slot, -1: none
+    bool railContact = false;
+    std::array<int, 16> pocketed{};     // ball numbers, in the order they dropped
+    int pocketedCount = 0;
+    for (const ShotEvent& e : events) {
+        switch (e.type) {
+        case ShotEvent::Type::BallContact:
+            if (e.slot == 0 && firstIdx == -1) firstIdx = e.other;
+            break;
+        case ShotEvent::Type::Cushion:
+            railContact = true;
+            break;
+        case ShotEvent::Type::Pocket:
+            if (e.slot != 0 && pocketedCount < static_cast<int>(pocketed.size()))
+                pocketed[pocketedCount++] = balls[e.slot].number;
+            break;
+        default:
+            break;
+        }
     }
-    return true;
-}
-
-
-void GameRules::EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& balls, GameState& s)
-{
-    if (s.IsGameOver()) return;
+    const bool cueHitOtherBall = firstIdx != -1;
 
     bool foul = false;
+    Foul reason = Foul::None;           // the first foul this shot
     bool ballPocketed = false;          // for this shot only
     bool eightBallPocketed = false;
     bool pottedSolid = false;           // this shot only
@@ -46,40 +48,42 @@ void GameRules::EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& ball
         s.SetFirstShot(false);
 
     // 1) cue ball pocketed => foul & BIH
-    if (!balls[0]->IsDrawn()) {
+    if (!balls[0].drawn) {
+        reason = Foul::Scratch;
         foul = true;
         s.SetBallInHand(true);
     }
 
     // 2) no contact => foul (unless currently placing BIH)
-    if (!s.CueHitOtherBall() && !s.BallInHand()) {
+    if (!cueHitOtherBall && !s.BallInHand()) {
+        if (!foul) reason = Foul::NoContact;
         foul = true;
         s.SetBallInHand(true);
     }
 
     // 3) first-contact rule
     if (!foul) {
-        const int firstIdx = s.FirstContactIndex();
         if (firstIdx != -1) {
-            const int firstNum = balls[firstIdx]->GetNumber();
+            const int firstNum = balls[firstIdx].number;
 
             if (tableOpen && !onBreak) {
-                if (firstNum == 8) { foul = true; s.SetBallInHand(true); }
+                if (firstNum == 8) { reason = Foul::WrongFirstContact; foul = true; s.SetBallInHand(true); }
             }
             else if (!tableOpen && curGroup != -1) {
-                if (firstNum == 8 && !AreAllGroupBallsPocketed(balls, curGroup)) {
-                    foul = true; s.SetBallInHand(true);
+                if (firstNum == 8 && !rack.IsGroupCleared(curGroup)) {
+                    reason = Foul::WrongFirstContact; foul = true; s.SetBallInHand(true);
                 }
                 else if (firstNum != 8) {
-                    const int contactType = BallTypeFromNumber(firstNum);
-                    if (contactType != curGroup) { foul = true; s.SetBallInHand(true); }
+                    const int contactType = RackMask::GroupOf(firstNum);
+                    if (contactType != curGroup) { reason = Foul::WrongFirstContact; foul = true; s.SetBallInHand(true); }
                 }
             }
         }
     }
 
     // 4) analyze only the balls pocketed *this shot*
-    for (int num : s.PocketedThisShot()) {
+    for (int i = 0; i < pocketedCount; ++i) {
+        const int num = pocketed[i];
         ballPocketed = true;
 
         if (num == 8) {
@@ -87,7 +91,7 @@ void GameRules::EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& ball
             continue;
         }
 
-        const int type = BallTypeFromNumber(num);
+        const int type = RackMask::GroupOf(num);
         if (type == 0) pottedSolid = true;
         if (type == 1) pottedStripe = true;
 
@@ -98,7 +102,8 @@ void GameRules::EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& ball
     }
 
     // 5) cushion-after-contact: if no pocket this shot, at least one ball must hit a rail
-    if (!ballPocketed && !s.RailAfterContact()) {
+    if (!ballPocketed && !railContact) {
+        if (!foul) reason = Foul::NoRail;
         foul = true;
         s.SetBallInHand(true);
     }
@@ -106,16 +111,18 @@ void GameRules::EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& ball
     // 6) 8-ball outcomes
     if (eightBallPocketed && onBreak) {
         s.SetGameOver(true);
+        s.SetWinner(foul ? 1 - s.CurrentPlayerIndex() : s.CurrentPlayerIndex());
         s.SetMessage(foul ? "Scratch with 8-ball on the break — loss."
             : "8-ball on the break — WIN!", 2.f);
-        return;
+        return reason;
     }
     if (eightBallPocketed) {
-        const bool cleared = AreAllGroupBallsPocketed(balls, curGroup);
+        const bool cleared = rack.IsGroupCleared(curGroup);
         s.SetGameOver(true);
+        s.SetWinner((!cleared || foul) ? 1 - s.CurrentPlayerIndex() : s.CurrentPlayerIndex());
         s.SetMessage((!cleared || foul) ? "8-ball pocketed illegally — loss."
             : "8-ball pocketed — WIN!", 2.f);
-        return;
+        return reason;
     }
 
     // 7) post-break (no 8-ball)
@@ -124,23 +131,23 @@ void GameRules::EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& ball
 
         if (foul) {
             s.SetMessage("Foul on the break. Ball in hand for opponent.", 1.2f);
-            s.SwitchTurn(balls[0]->IsDrawn());
+            s.SwitchTurn(balls[0].drawn);
         }
         else {
             if (ballPocketed) {
                 s.ResetShotClock();      // breaker keeps table; assignment later
             }
             else {
-                s.SwitchTurn(balls[0]->IsDrawn()); // dry break
+                s.SwitchTurn(balls[0].drawn); // dry break
             }
         }
-        return;
+        return reason;
     }
 
     // 8) normal turn resolution (not break)
     if (foul) {
         s.SetMessage("Foul! Ball in hand for opponent.", 1.2f);
-        s.SwitchTurn(balls[0]->IsDrawn());
+        s.SwitchTurn(balls[0].drawn);
     }
     else {
         bool shooterKeeps = false;
@@ -155,7 +162,7 @@ void GameRules::EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& ball
         }
 
         if (shooterKeeps) s.ResetShotClock();
-        else              s.SwitchTurn(balls[0]->IsDrawn()); // legal hit, no make → pass turn
+        else              s.SwitchTurn(balls[0].drawn); // legal hit, no make → pass turn
     }
 
     // 9) group assignment: open table, not the break, exactly one color fell this shot
@@ -165,4 +172,18 @@ void GameRules::EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& ball
         if (assignType != -1) s.AssignGroupFromBallNumber(assignType == 0 ? 1 : 9);
         // both colors fell -> remain open; shooterKeeps handled above
     }
+    return reason;
+}
+
+
+const char* GameRules::FoulName(const Foul foul)
+{
+    switch (foul) {
+    case Foul::None:              return "none";
+    case Foul::Scratch:           return "scratch";
+    case Foul::NoContact:         return "no contact";
+    case Foul::WrongFirstContact: return "wrong first contact";
+    case Foul::NoRail:            return "no rail";
+    }
+    return "?";
 }
@@ -1,16 +1,23 @@
 #pragma once
-#include "../precompiled.h"
+#include "../headless.h"
+#include "../physics/BallBody.hpp"
+#include "../physics/RackMask.hpp"
+#include "../physics/ShotEvents.hpp"
 
-class Ball;
 class GameState;
 
 
 class GameRules {
 public:
-	// Call once when balls settle (not moving). Handles fouls, scoring, win/lose, turn switch.
-	void EvaluateEndOfShot(const std::vector<std::shared_ptr<Ball>>& balls, GameState& state);
+	// Why a shot was a foul (the first rule it broke)
+	enum class Foul : uint8_t { None, Scratch, NoContact, WrongFirstContact, NoRail };
+	static constexpr int foul_kinds = 5;
 
+	// Call once when balls settle (not moving). Handles fouls, scoring, win/lose, turn switch.
+	// 'rack' is what is left on the table, kept by the simulation as balls drop;
+	// 'events' is everything that happened during the shot (read in one pass)
+	Foul EvaluateEndOfShot(std::span<const BallBody> balls, const RackMask& rack,
+		std::span<const ShotEvent> events, GameState& state);
 
-private:
-	static bool AreAllGroupBallsPocketed(const std::vector<std::shared_ptr<Ball>>& balls, int groupType);
+	static const char* FoulName(Foul foul);
 };
\ No newline at end of file
@@ -1,4 +1,4 @@
-#include "../precompiled.h"
+#include "../headless.h"
 #include "GameState.hpp"
 
 
@@ -15,17 +15,12 @@ void GameState::ResetPlayerIndex() { current_player_index_ = 0; }
 
 void GameState::StartNewRack() {
 	is_game_over_ = false;
+	winner_ = -1;
 	is_first_shot_ = true;
 	is_after_break_ = true;
 	check_game_rules_ = false;
 	ball_in_hand_ = false;
 	shot_clock_ = SHOT_CLOCK_MAX;
-	ClearShotTransients();
-}
-
-
-void GameState::StartNewTurn() {
-	ClearShotTransients();
 }
 
 
@@ -66,25 +61,6 @@ void GameState::TickMessage(float dt) {
 }
 
 
-void GameState::MarkCueContact(int nonCueBallIndex) {
-	cueBallHitOtherBall_ = true;
-	if (firstBallContactIndex_ == -1 && nonCueBallIndex != 0) {
-		firstBallContactIndex_ = nonCueBallIndex;
-	}
-}
-
-
-void GameState::ClearShotTransients() {
-	cueBallHitOtherBall_ = false;
-	firstBallContactIndex_ = -1;
-	rail_after_contact_ = false;
-	pocketed_this_shot_.clear();
-}
-
-void GameState::NotePocketedThisShot(int ballNumber) {
-	pocketed_this_shot_.push_back(ballNumber);
-}
-
 void GameState::SetMessage(const std::string& msg, float seconds) {
 	current_message_ = msg;
 	message_timer_ = seconds;
@@ -117,5 +93,46 @@ void GameState::AssignGroupFromBallNumber(int ballNumber) {
 }
 
 
-void GameState::MarkRailContact() { rail_after_contact_ = true; }
-bool GameState::RailAfterContact() const { return rail_after_contact_; }
+void GameState::Save(Snapshot& out) const {
+	for (int i = 0; i < 2; ++i) {
+		const std::string& name = players_[i].GetName();
+		const size_t length = std::min(name.size(), Snapshot::name_capacity - 1);
+		std::copy_n(name.data(), length, out.names[i].data());
+		out.names[i][length] = '\0';
+		out.scores[i] = players_[i].GetScore();
+	}
+
+	out.current_player_index = current_player_index_;
+	out.winner = winner_;
+	out.player1_ball_type = player1_ball_type_;
+	out.player2_ball_type = player2_ball_type_;
+	out.shot_clock = shot_clock_;
+	out.is_game_over = is_game_over_;
+	out.is_first_shot = is_first_shot_;
+	out.is_after_break = is_after_break_;
+	out.check_game_rules = check_game_rules_;
+	out.ball_in_hand = ball_in_hand_;
+}
+
+
+void GameState::Restore(const Snapshot& in) {
+	for (int i = 0; i < 2; ++i) {
+		const auto& name = in.names[i];
+		const std::string_view restored(name.data(), static_cast<size_t>(std::find(name.begin(), name.end(), '\0') - name.begin()));
+		if (players_[i].GetName() != restored)
+			players_[i].SetName(std::string(restored));
+		players_[i].ResetScore();
+		players_[i].AddScore(in.scores[i]);
+	}
+
+	current_player_index_ = std::clamp(in.current_player_index, 0, 1);
+	winner_ = std::clamp(in.winner, -1, 1);
+	player1_ball_type_ = std::clamp(in.player1_ball_type, -1, 1);
+	player2_ball_type_ = std::clamp(in.player2_ball_type, -1, 1);
+	shot_clock_ = std::clamp(in.shot_clock, 0.0f, SHOT_CLOCK_MAX);
+	is_game_over_ = in.is_game_over;
+	is_first_shot_ = in.is_first_shot;
+	is_after_break_ = in.is_after_break;
+	check_game_rules_ = in.check_game_rules;
+	ball_in_hand_ = in.ball_in_hand;
+}
@@ -1,6 +1,6 @@
 ﻿#pragma once
 
-#include "../precompiled.h"
+#include "../headless.h"
 #include "Player.hpp"
 
 
@@ -27,7 +27,6 @@ public:
 
 	// Shot/turn management
 	void StartNewRack(); // resets flags for a rack (break pending)
-	void StartNewTurn(); // called when a shot actually begins
 	void SwitchTurn(bool cueBallDrawn); // advances player, sets BIH if cue not drawn
 
 
@@ -37,11 +36,6 @@ public:
 	void TickMessage(float dt);
 
 
-	// Transient shot flags (set by world on collisions)
-	void MarkCueContact(int nonCueBallIndex);
-	void ClearShotTransients();
-
-
 	// Messages for HUD
 	void SetMessage(const std::string& msg, float seconds);
 	const std::string& Message() const { return current_message_; }
@@ -56,6 +50,10 @@ public:
 	bool IsGameOver() const { return is_game_over_; }
 	void SetGameOver(bool v) { is_game_over_ = v; }
 
+	// Player index that won the rack, -1 while it is still on
+	int Winner() const { return winner_; }
+	void SetWinner(int playerIdx) { winner_ = playerIdx; }
+
 
 	bool IsFirstShot() const { return is_first_shot_; }
 	void SetFirstShot(bool v) { is_first_shot_ = v; }
@@ -64,10 +62,6 @@ public:
 	bool IsAfterBreak() const { return is_after_break_; }
 	void SetAfterBreak(bool v) { is_after_break_ = v; }
 
-	// Mark that at least one ball hit a rail after legal contact in this shot
-	void MarkRailContact();
-	bool RailAfterContact() const;
-
 
 	bool CheckRulesPending() const { return check_game_rules_; }
 	void SetCheckRulesPending(bool v) { check_game_rules_ = v; }
@@ -77,14 +71,6 @@ public:
 	void SetBallInHand(bool v) { ball_in_hand_ = v; }
 
 
-	bool CueHitOtherBall() const { return cueBallHitOtherBall_; }
-	void SetCueHitOtherBall(bool v) { cueBallHitOtherBall_ = v; }
-
-
-
-	int FirstContactIndex() const { return firstBallContactIndex_; }
-
-
 	int GroupOfPlayer(int playerIdx) const { return (playerIdx == 0) ? player1_ball_type_ : player2_ball_type_; }
 	void SetGroupOfPlayer(int playerIdx, int group) { if (playerIdx == 0) player1_ball_type_ = group; else player2_ball_type_ = group; }
 
@@ -95,11 +81,29 @@ public:
 	float ShotClock() const { return shot_clock_; }
 	void SetShotClock(float v) { shot_clock_ = v; }
 
-	// Record a ball number the instant it’s pocketed on THIS shot.
-	void NotePocketedThisShot(int ballNumber);
 
-	// Read-only access for rules logic.
-	const std::vector<int>& PocketedThisShot() const { return pocketed_this_shot_; }
+	// Everything above but the HUD message, flat and trivially copyable (see
+	// TableSimulation::Snapshot). Names longer than name_capacity - 1 are cut
+	struct Snapshot {
+		static constexpr size_t name_capacity = 32;
+
+		std::array<std::array<char, name_capacity>, 2> names{};
+		std::array<int, 2> scores{};
+		int current_player_index = 0;
+		int winner = -1;
+		int player1_ball_type = -1;
+		int player2_ball_type = -1;
+		float shot_clock = SHOT_CLOCK_MAX;
+		bool is_game_over = false;
+		bool is_first_shot = true;
+		bool is_after_break = true;
+		bool check_game_rules = false;
+		bool ball_in_hand = false;
+	};
+
+	void Save(Snapshot& out) const;
+	// Names are only rewritten when they differ, so restoring allocates nothing
+	void Restore(const Snapshot& in);
 
 private:
 	std::vector<Player> players_{ Player("Player 1"), Player("Player 2") };
@@ -107,17 +111,10 @@ private:
 
 
 	bool is_game_over_ = false;
+	int winner_ = -1;
 	bool is_first_shot_ = true; // table open at start
 	bool is_after_break_ = true; // first resolution after break
 	bool check_game_rules_ = false; // gate to run rules once when balls settle
-	bool rail_after_contact_ = false;
-
-
-	// per‑shot transients
-	bool cueBallHitOtherBall_ = false;
-	int firstBallContactIndex_ = -1; // -1: none; 8=8ball
-
-	std::vector<int> pocketed_this_shot_; // ball numbers pocketed during this shot
 
 	// groups: -1 unset, 0 solids, 1 stripes
 	int player1_ball_type_ = -1;
@@ -1,5 +1,5 @@
 #pragma once
-#include "../precompiled.h"
+#include "../headless.h"
 
 class Player {
 public:
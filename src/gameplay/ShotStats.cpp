@@ -0,0 +1,38 @@
+#include "../precompiled.h"
+#include "ShotStats.hpp"
+
+
+void ShotStats::Record(std::span<const ShotEvent> events, float tick_seconds) {
+	++shots_;
+	bool scratched = false;
+	uint32_t last_tick = 0;
+	for (const ShotEvent& e : events) {
+		switch (e.type) {
+		case ShotEvent::Type::BallContact:
+			++contacts_;
+			hardest_impact_ = std::max(hardest_impact_, e.speed);
+			break;
+		case ShotEvent::Type::Cushion:
+			++cushions_;
+			break;
+		case ShotEvent::Type::Pocket:
+			if (e.slot == 0) scratched = true;
+			else ++pockets_;
+			break;
+		case ShotEvent::Type::AtRest:
+			break;
+		}
+		last_tick = std::max(last_tick, e.tick);
+	}
+	scratches_ += scratched;
+	seconds_ += static_cast<float>(last_tick + 1) * tick_seconds;
+}
+
+
+std::string ShotStats::Summary() const {
+	const float per_shot = shots_ > 0 ? 1.0f / static_cast<float>(shots_) : 0.0f;
+	return std::format("{} shots: {} ball contacts ({:.1f}/shot, hardest {:.2f} m/s), {} cushions, "
+		"{} balls pocketed, {} scratches, {:.1f} s average shot",
+		shots_, contacts_, contacts_ * per_shot, hardest_impact_, cushions_,
+		pockets_, scratches_, seconds_ * per_shot);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "../precompiled.h"
+#include "../physics/ShotEvents.hpp"
+
+#include <span>
+
+// Running totals over the shots of a session, built from each shot's events
+// (TableSimulation::Events) once it has settled
+class ShotStats {
+public:
+	void Record(std::span<const ShotEvent> events, float tick_seconds);
+	void Reset() { *this = ShotStats{}; }
+
+	int Shots() const { return shots_; }
+	int Contacts() const { return contacts_; }
+	int Cushions() const { return cushions_; }
+	int Pockets() const { return pockets_; }
+	int Scratches() const { return scratches_; }
+	float HardestImpact() const { return hardest_impact_; }
+
+	// One line for the log
+	std::string Summary() const;
+
+private:
+	int shots_ = 0;
+	int contacts_ = 0;          // ball on ball
+	int cushions_ = 0;
+	int pockets_ = 0;           // object balls
+	int scratches_ = 0;         // shots that sank the cue ball
+	float hardest_impact_ = 0.0f;   // m/s, closing speed of the hardest ball contact
+	float seconds_ = 0.0f;      // table time from the strike to the last ball stopping
+};
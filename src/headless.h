@@ -0,0 +1,41 @@
+#pragma once
+
+// What the simulation side (physics, rules, game state, logging, thread pool,
+// sockets) builds on: glm and the standard library, no window, GL or FreeType.
+// precompiled.h adds the rest for the game; the headless tools use this one.
+
+// Keep Windows headers lean if a source pulls one in (winsock2.h in Socket.cpp)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "Config.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/string_cast.hpp>
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstdlib>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <filesystem>
+#include <unordered_map>
+#include <map>
+#include <fstream>
+#include <format>
+#include <algorithm>
+#include <random>
+#include <functional>
+#include <utility>
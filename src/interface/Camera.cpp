@@ -1,6 +1,6 @@
 #include "../precompiled.h"
 #include "Camera.hpp"
-#include "../core/World.hpp"
+#include "Input.hpp"
 
 
 namespace {
@@ -65,53 +65,11 @@ void Camera::UpdateProjectionMatrix(const int width, const int height)
 	projection_matrix_ = glm::perspective(Config::fov, aspect_ratio, Config::near_clip, Config::far_clip);
 }
 
-void Camera::UpdateMain(const std::shared_ptr<Shader>& main_shader, const World& world) const {
+void Camera::UpdateMain(const std::shared_ptr<Shader>& main_shader) const {
 	main_shader->Bind();
 	main_shader->SetMat4(view_matrix_, "viewMatrix");
 	main_shader->SetMat4(projection_matrix_, "projectionMatrix");
 	main_shader->SetVec3(position_, "cameraPos");
-
-	const int max_shader_lights = Config::max_shader_lights; // Matches `lights[14]` in the shader
-
-	// 1) Virtual lights
-	for (int i = 0; i < Config::light_count && i < max_shader_lights; ++i) {
-		const float lx = (i % 2) ? 2.0f * i : -2.0f * i;
-		main_shader->SetVec3(glm::vec3(20.0f), "lights[" + std::to_string(i) + "].color");
-		main_shader->SetVec3(glm::vec3(lx, 2.0f, 0.0f), "lights[" + std::to_string(i) + "].position");
-		main_shader->SetBool(true, "lights[" + std::to_string(i) + "].isOn");
-	}
-
-
-	// 2) Physical lights
-	const auto& lights = world.GetLights();
-	for (int i = 0; i < static_cast<int>(lights.size()); ++i) {
-		const int idx = Config::light_count + i;
-		if (idx >= max_shader_lights) break;
-		main_shader->SetVec3(lights[i]->GetColor(), "lights[" + std::to_string(idx) + "].color");
-		main_shader->SetVec3(lights[i]->GetPosition(), "lights[" + std::to_string(idx) + "].position");
-		main_shader->SetBool(lights[i]->IsOn(), "lights[" + std::to_string(idx) + "].isOn");
-	}
-
-	// 3. Set `lightCount` to the correct number
-	int total_lights = Config::light_count + static_cast<int>(lights.size());
-	if (total_lights > max_shader_lights) {
-		Logger::Log("Warning: Total light count exceeds shader capacity! Truncating to " + std::to_string(max_shader_lights));
-		total_lights = max_shader_lights;
-	}
-
-	main_shader->SetInt(total_lights, "lightCount");
-
-	if (glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) {
-		// example: treat the camera as a dynamic light
-		if (Config::light_count < max_shader_lights)
-		{
-			main_shader->SetVec3(glm::vec3(10.0f), std::string("lights[") + std::to_string(Config::light_count) + "].color");
-			main_shader->SetVec3(position_, std::string("lights[") + std::to_string(Config::light_count) + "].position");
-			main_shader->SetBool(true, "lights[" + std::to_string(Config::light_count) + "].isOn");
-			main_shader->SetInt(Config::light_count + 1, "lightCount");
-		}
-	}
-
 	main_shader->Unbind();
 }
 
@@ -129,27 +87,27 @@ void Camera::Move(GLFWwindow* window, const glm::vec3& direction, const float fa
 	constexpr glm::vec3 up = { 0.0f, 1.0f, 0.0f };
 	const glm::vec3 right = glm::normalize(glm::cross(direction, up));
 
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	if (Input::IsDown(GLFW_KEY_W))
 	{
 		position_ += direction * factor;
 	}
-	else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	else if (Input::IsDown(GLFW_KEY_S))
 	{
 		position_ -= direction * factor;
 	}
-	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	if (Input::IsDown(GLFW_KEY_A))
 	{
 		position_ -= right * factor;
 	}
-	else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else if (Input::IsDown(GLFW_KEY_D))
 	{
 		position_ += right * factor;
 	}
-	if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
+	if (Input::IsDown(GLFW_KEY_E))
 	{
 		position_ += up * factor;
 	}
-	else if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS)
+	else if (Input::IsDown(GLFW_KEY_Q))
 	{
 		position_ -= up * factor;
 	}
@@ -160,8 +118,7 @@ void Camera::Move(GLFWwindow* window, const glm::vec3& direction, const float fa
 
 void Camera::Rotate(GLFWwindow* window, const float factor)
 {
-	double current_cursor_x, current_cursor_y;
-	glfwGetCursorPos(window, &current_cursor_x, &current_cursor_y);
+	const double current_cursor_x = Input::Cursor().x, current_cursor_y = Input::Cursor().y;
 
 	// On first frame after locking the cursor, initialize without applying a delta
 	if (!cursor_initialized_)
@@ -206,8 +163,7 @@ bool Camera::IsTopDownView() const {
 
 glm::vec3 Camera::GetCursorWorldPosition() const
 {
-	double cursor_x, cursor_y;
-	glfwGetCursorPos(glfwGetCurrentContext(), &cursor_x, &cursor_y);
+	const double cursor_x = Input::Cursor().x, cursor_y = Input::Cursor().y;
 
 	glm::vec4 viewport = glm::vec4(0.0f, 0.0f, Config::width, Config::height);
 	glm::vec3 screen_pos = glm::vec3(static_cast<float>(cursor_x), static_cast<float>(Config::height - cursor_y), 0.0f);
@@ -4,9 +4,6 @@
 #include "../core/Object.hpp"
 #include "Logger.hpp"
 
-// Forward declaration
-class World;
-
 class Camera
 {
 public:
@@ -15,7 +12,7 @@ public:
 	void Init();
 	void UpdateViewMatrix(float frame_time);
 	void UpdateProjectionMatrix(int width, int height);
-	void UpdateMain(const std::shared_ptr<Shader>& main_shader, const World& world) const;
+	void UpdateMain(const std::shared_ptr<Shader>& main_shader) const;
 	void UpdateBackground(const std::shared_ptr<Shader>& background_shader) const;
 	void SetTopDownView(bool enabled);
 	bool IsTopDownView() const;
@@ -23,6 +20,7 @@ public:
 	// Added getter methods
 	glm::mat4 GetViewMatrix() const { return view_matrix_; }
 	glm::mat4 GetProjectionMatrix() const { return projection_matrix_; }
+	glm::vec3 GetPosition() const { return position_; }
 	glm::vec3 GetCursorWorldPosition() const;
 
 	// Return (origin, direction) of a picking ray
@@ -0,0 +1,232 @@
+#include "../precompiled.h"
+#include "Input.hpp"
+#include "../Logger.hpp"
+
+#include <bitset>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+namespace {
+    constexpr char kRecordingMagic[4] = { '8', 'B', 'I', 'N' };
+    constexpr uint32_t kRecordingVersion = 1;
+    constexpr size_t kMaxQueuedEvents = 1024;   // nobody draining (menu before the first game): keep the newest
+
+    struct InputState {
+        // UI view, written on the main thread only
+        std::bitset<GLFW_KEY_LAST + 1> keys_down;
+        std::bitset<GLFW_KEY_LAST + 1> keys_pressed;          // since the last NewFrame
+        std::bitset<GLFW_KEY_LAST + 1> frame_keys_pressed;
+        std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> buttons_down;
+        std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> buttons_pressed;
+        std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> frame_buttons_pressed;
+        glm::dvec2 cursor{ 0.0 };
+
+        // Simulation queue
+        std::mutex queue_mutex;
+        std::deque<InputEvent> queue;
+
+        // Record / replay
+        std::ofstream recording;
+        double recording_start = 0.0;
+        std::vector<InputEvent> replay;
+        size_t replay_next = 0;
+        double replay_start = 0.0;
+    };
+
+    InputState& State() {
+        static InputState state;
+        return state;
+    }
+
+    // Single entry point for live and replayed events
+    void Dispatch(const InputEvent& event) {
+        InputState& s = State();
+
+        switch (event.type) {
+            case InputEvent::Type::Key:
+                if (event.code < 0 || event.code > GLFW_KEY_LAST) return;
+                if (event.action == GLFW_PRESS) { s.keys_down.set(event.code); s.keys_pressed.set(event.code); }
+                else if (event.action == GLFW_RELEASE) s.keys_down.reset(event.code);
+                else return;                                    // OS auto-repeat carries no new state
+                break;
+            case InputEvent::Type::MouseButton:
+                if (event.code < 0 || event.code > GLFW_MOUSE_BUTTON_LAST) return;
+                if (event.action == GLFW_PRESS) { s.buttons_down.set(event.code); s.buttons_pressed.set(event.code); }
+                else s.buttons_down.reset(event.code);
+                break;
+            case InputEvent::Type::Cursor:
+                s.cursor = { event.x, event.y };
+                break;
+        }
+
+        if (s.recording.is_open()) {
+            InputEvent recorded = event;
+            recorded.time -= s.recording_start;
+            s.recording.write(reinterpret_cast<const char*>(&recorded), sizeof(recorded));
+        }
+
+        // The simulation only cares about state changes; cursor moves stay on the UI side
+        if (event.type != InputEvent::Type::Cursor) {
+            std::lock_guard lock(s.queue_mutex);
+            if (s.queue.size() >= kMaxQueuedEvents)
+                s.queue.pop_front();
+            s.queue.push_back(event);
+        }
+    }
+
+    void OnKey(GLFWwindow*, const int key, int, const int action, int) {
+        if (Input::IsReplaying()) return;
+        Dispatch({ Input::Now(), 0.0, 0.0, InputEvent::Type::Key, key, action });
+    }
+
+    void OnMouseButton(GLFWwindow*, const int button, const int action, int) {
+        if (Input::IsReplaying()) return;
+        Dispatch({ Input::Now(), 0.0, 0.0, InputEvent::Type::MouseButton, button, action });
+    }
+
+    void OnCursor(GLFWwindow*, const double x, const double y) {
+        if (Input::IsReplaying()) return;
+        Dispatch({ Input::Now(), x, y, InputEvent::Type::Cursor, 0, 0 });
+    }
+}
+
+void Input::Install(GLFWwindow* window) {
+    glfwSetKeyCallback(window, OnKey);
+    glfwSetMouseButtonCallback(window, OnMouseButton);
+    glfwSetCursorPosCallback(window, OnCursor);
+
+    double x, y;
+    glfwGetCursorPos(window, &x, &y);
+    State().cursor = { x, y };
+}
+
+double Input::Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Input::NewFrame() {
+    InputState& s = State();
+
+    if (IsReplaying()) {
+        // Re-stamp onto the current clock so the simulation sees the original spacing
+        const double elapsed = Now() - s.replay_start;
+        while (s.replay_next < s.replay.size() && s.replay[s.replay_next].time <= elapsed) {
+            InputEvent event = s.replay[s.replay_next++];
+            event.time += s.replay_start;
+            Dispatch(event);
+        }
+        if (s.replay_next == s.replay.size()) {
+            s.replay.clear();
+            s.replay_next = 0;
+            LOG_INFO(Input, "Input replay finished");
+        }
+    }
+
+    s.frame_keys_pressed = s.keys_pressed;
+    s.keys_pressed.reset();
+    s.frame_buttons_pressed = s.buttons_pressed;
+    s.buttons_pressed.reset();
+}
+
+bool Input::IsDown(const int key) {
+    return key >= 0 && key <= GLFW_KEY_LAST && State().keys_down.test(key);
+}
+
+bool Input::WasPressed(const int key) {
+    return key >= 0 && key <= GLFW_KEY_LAST && State().frame_keys_pressed.test(key);
+}
+
+bool Input::IsMouseDown(const int button) {
+    return button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST && State().buttons_down.test(button);
+}
+
+bool Input::WasMousePressed(const int button) {
+    return button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST && State().frame_buttons_pressed.test(button);
+}
+
+glm::dvec2 Input::Cursor() {
+    return State().cursor;
+}
+
+void Input::DrainEvents(const double until, std::vector<InputEvent>& out) {
+    InputState& s = State();
+    std::lock_guard lock(s.queue_mutex);
+    while (!s.queue.empty() && s.queue.front().time <= until) {
+        out.push_back(s.queue.front());
+        s.queue.pop_front();
+    }
+}
+
+bool Input::StartRecording(const std::filesystem::path& path) {
+    InputState& s = State();
+    StopRecording();
+
+    s.recording.open(path, std::ios::binary | std::ios::trunc);
+    if (!s.recording)
+        return false;
+
+    s.recording.write(kRecordingMagic, sizeof(kRecordingMagic));
+    s.recording.write(reinterpret_cast<const char*>(&kRecordingVersion), sizeof(kRecordingVersion));
+    s.recording_start = Now();
+
+    // Seed the cursor so a replay starts from the same place
+    Dispatch({ Now(), s.cursor.x, s.cursor.y, InputEvent::Type::Cursor, 0, 0 });
+
+    LOG_INFO(Input, "Recording input to " + path.string());
+    return true;
+}
+
+void Input::StopRecording() {
+    InputState& s = State();
+    if (s.recording.is_open()) {
+        s.recording.close();
+        LOG_INFO(Input, "Input recording stopped");
+    }
+}
+
+bool Input::IsRecording() {
+    return State().recording.is_open();
+}
+
+bool Input::StartReplay(const std::filesystem::path& path) {
+    InputState& s = State();
+    StopRecording();
+
+    std::ifstream file(path, std::ios::binary);
+    char magic[4]{};
+    uint32_t version = 0;
+    if (!file.read(magic, sizeof(magic)) || !file.read(reinterpret_cast<char*>(&version), sizeof(version)) ||
+        std::memcmp(magic, kRecordingMagic, sizeof(magic)) != 0 || version != kRecordingVersion) {
+        LOG_WARNING(Input, "Not an input recording: " + path.string());
+        return false;
+    }
+
+    std::vector<InputEvent> events;
+    InputEvent event;
+    while (file.read(reinterpret_cast<char*>(&event), sizeof(event)))
+        events.push_back(event);
+    if (events.empty())
+        return false;
+
+    // Start from a clean slate: release everything currently held (the simulation sees it too)
+    const double now = Now();
+    for (int key = 0; key <= GLFW_KEY_LAST; ++key)
+        if (s.keys_down.test(key))
+            Dispatch({ now, 0.0, 0.0, InputEvent::Type::Key, key, GLFW_RELEASE });
+    for (int button = 0; button <= GLFW_MOUSE_BUTTON_LAST; ++button)
+        if (s.buttons_down.test(button))
+            Dispatch({ now, 0.0, 0.0, InputEvent::Type::MouseButton, button, GLFW_RELEASE });
+
+    s.replay = std::move(events);
+    s.replay_next = 0;
+    s.replay_start = Now();
+
+    LOG_INFO(Input, "Replaying " + std::to_string(s.replay.size()) + " input events from " + path.string());
+    return true;
+}
+
+bool Input::IsReplaying() {
+    return !State().replay.empty();
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "../precompiled.h"
+
+// One key / mouse-button / cursor change, stamped when GLFW delivered it
+struct InputEvent
+{
+    enum class Type : uint32_t { Key, MouseButton, Cursor };
+
+    double time = 0.0;      // seconds on Input::Now()'s clock
+    double x = 0.0;         // cursor position (Cursor events)
+    double y = 0.0;
+    Type type = Type::Key;
+    int32_t code = 0;       // GLFW key or mouse button
+    int32_t action = 0;     // GLFW_PRESS / GLFW_RELEASE / GLFW_REPEAT
+    int32_t reserved = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<InputEvent> && sizeof(InputEvent) == 40);
+
+// Central input fed by GLFW callbacks. Every event is timestamped and
+//  - folded into held / pressed-this-frame state for the UI thread, and
+//  - appended to a queue the simulation drains tick by tick, so presses shorter
+//    than a frame are never lost and a shot lands on the tick it was made in.
+// The event stream can be recorded to a file and replayed for benchmarking.
+class Input
+{
+public:
+    static void Install(GLFWwindow* window);
+
+    // Monotonic seconds; event timestamps and the simulation tick clock share it
+    [[nodiscard]] static double Now();
+
+    // --- UI thread: state as of the last NewFrame() ---
+    // Call once per frame right after glfwPollEvents (also feeds an active replay)
+    static void NewFrame();
+    [[nodiscard]] static bool IsDown(int key);
+    [[nodiscard]] static bool WasPressed(int key);               // went down since the previous frame
+    [[nodiscard]] static bool IsMouseDown(int button);
+    [[nodiscard]] static bool WasMousePressed(int button);
+    [[nodiscard]] static glm::dvec2 Cursor();
+
+    // --- simulation thread: moves every event stamped at or before 'until' into 'out' (in order) ---
+    static void DrainEvents(double until, std::vector<InputEvent>& out);
+
+    // --- record / replay (UI thread) ---
+    static bool StartRecording(const std::filesystem::path& path);
+    static void StopRecording();
+    [[nodiscard]] static bool IsRecording();
+
+    // Live input is ignored until the recording has been played out
+    static bool StartReplay(const std::filesystem::path& path);
+    [[nodiscard]] static bool IsReplaying();
+
+private:
+    Input() = delete;
+};
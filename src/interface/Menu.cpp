@@ -1,5 +1,7 @@
 ﻿#include "../precompiled.h"
 #include "Menu.hpp"
+#include "Input.hpp"
+#include "../core/Quality.hpp"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -142,8 +144,7 @@ void Menu::beginFrameCaptureMouse()
 {
     texts_.clear();
     GLFWwindow* w = glfwGetCurrentContext();
-    double mx, my;
-    glfwGetCursorPos(w, &mx, &my);
+    const double mx = Input::Cursor().x, my = Input::Cursor().y;
     int ww, wh;
     glfwGetWindowSize(w, &ww, &wh);
     mouse_x_ = mx;
@@ -223,13 +224,11 @@ void Menu::CharCallbackThunk(GLFWwindow* /*wnd*/, unsigned int codepoint) {
 }
 
 void Menu::DrawMainMenu(bool modalOpen, int winW, int winH,
-    float mouseX, float mouseY, int curEnter,
-    int& prevEnter, int& selected)
+    float mouseX, float mouseY, bool enterPressed, int& selected)
 {
     auto isEnterOn = [&](int logicalIndex)->bool {
         if (selected == -1) return false;
-        const bool pressed = (curEnter == GLFW_PRESS && prevEnter == GLFW_RELEASE);
-        return pressed && (selected == logicalIndex);
+        return enterPressed && (selected == logicalIndex);
         };
 
     // --- Play (center) unchanged ---
@@ -277,13 +276,11 @@ void Menu::DrawMainMenu(bool modalOpen, int winW, int winH,
 
 
 void Menu::DrawPauseMenu(bool modalOpen, int winW, int winH,
-    float mouseX, float mouseY, int curEnter,
-    int& prevEnter, int& selected)
+    float mouseX, float mouseY, bool enterPressed, int& selected)
 {
     auto isEnterOn = [&](int i)->bool {
         if (selected == -1) return false;
-        bool pressed = (curEnter == GLFW_PRESS && prevEnter == GLFW_RELEASE);
-        return pressed && (selected == i);
+        return enterPressed && (selected == i);
         };
 
     if (!modalOpen) {
@@ -423,18 +420,10 @@ void Menu::DrawQuickSetupModal(int winW, int winH, float /*mouseX*/, float /*mou
 
     // Keyboard focus (0 = strike force, 1 = friction)
     static int focus = 0;
-    GLFWwindow* w = glfwGetCurrentContext();
-    static int prevUp = GLFW_RELEASE, prevDown = GLFW_RELEASE, prevLeft = GLFW_RELEASE, prevRight = GLFW_RELEASE, prevEsc = GLFW_RELEASE;
-    const int kUp = glfwGetKey(w, GLFW_KEY_UP);
-    const int kDown = glfwGetKey(w, GLFW_KEY_DOWN);
-    const int kLeft = glfwGetKey(w, GLFW_KEY_LEFT);
-    const int kRight = glfwGetKey(w, GLFW_KEY_RIGHT);
-    const int kEsc = glfwGetKey(w, GLFW_KEY_ESCAPE);
-
-    const bool upEdge = (kUp == GLFW_PRESS && prevUp == GLFW_RELEASE);
-    const bool downEdge = (kDown == GLFW_PRESS && prevDown == GLFW_RELEASE);
-    const bool leftEdge = (kLeft == GLFW_PRESS && prevLeft == GLFW_RELEASE);
-    const bool rightEdge = (kRight == GLFW_PRESS && prevRight == GLFW_RELEASE);
+    const bool upEdge = Input::WasPressed(GLFW_KEY_UP);
+    const bool downEdge = Input::WasPressed(GLFW_KEY_DOWN);
+    const bool leftEdge = Input::WasPressed(GLFW_KEY_LEFT);
+    const bool rightEdge = Input::WasPressed(GLFW_KEY_RIGHT);
 
 
     if (interactive) {
@@ -462,13 +451,10 @@ void Menu::DrawQuickSetupModal(int winW, int winH, float /*mouseX*/, float /*mou
         selected_ = has_started ? 2 : 1;
     }
 
-    if (kEsc == GLFW_PRESS && prevEsc == GLFW_RELEASE) {
+    if (Input::WasPressed(GLFW_KEY_ESCAPE)) {
         settings_open_ = false;
         selected_ = has_started ? 2 : 1;
     }
-
-    // Prev key states
-    prevUp = kUp; prevDown = kDown; prevLeft = kLeft; prevRight = kRight; prevEsc = kEsc;
 }
 
 
@@ -526,13 +512,10 @@ void Menu::DrawHelpModal(bool has_started)
         selected_ = has_started ? 3 : 2;
     }
 
-    static int prevEsc = GLFW_RELEASE;
-    int kEsc = glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_ESCAPE);
-    if (interactive && kEsc == GLFW_PRESS && prevEsc == GLFW_RELEASE) {
+    if (interactive && Input::WasPressed(GLFW_KEY_ESCAPE)) {
         help_open_ = false;
         selected_ = has_started ? 3 : 2;
     }
-    prevEsc = kEsc;
 }
 
 
@@ -566,7 +549,8 @@ void Menu::DrawUiSettingsModal(bool has_started)
     const float headV = 0.70f;
     const float row1V = headV - vpx(gap_px);                 // UI scale row
     const float guideV = row1V - vpx(gap_px);                 // guideline row
-    const float row2V = guideV - vpx(gap_px * 1.20f);        // Player 1
+    const float qualityV = guideV - vpx(gap_px);              // quality tier row
+    const float row2V = qualityV - vpx(gap_px * 1.20f);      // Player 1
     const float row3V = row2V - vpx(gap_px);                 // Player 2
     const float hintV = row3V - vpx(gap_px * 0.90f);
     const float closeV = hintV - vpx(gap_px);                 // Close
@@ -596,28 +580,16 @@ void Menu::DrawUiSettingsModal(bool has_started)
 
     // -------------------------------
     // Keyboard focus & key edges
-    // 0 = UI scale, 1 = Guideline, 2 = Player1, 3 = Player2, 4 = Close
+    // 0 = UI scale, 1 = Guideline, 2 = Quality, 3 = Player1, 4 = Player2, 5 = Close
     // -------------------------------
     static int uiFocus = 0;
-    GLFWwindow* w = glfwGetCurrentContext();
-
-    static int prevUp = GLFW_RELEASE, prevDown = GLFW_RELEASE, prevLeft = GLFW_RELEASE, prevRight = GLFW_RELEASE,
-        prevEnter = GLFW_RELEASE, prevTab = GLFW_RELEASE, prevEsc = GLFW_RELEASE;
-    const int kUp = glfwGetKey(w, GLFW_KEY_UP);
-    const int kDown = glfwGetKey(w, GLFW_KEY_DOWN);
-    const int kLeft = glfwGetKey(w, GLFW_KEY_LEFT);
-    const int kRight = glfwGetKey(w, GLFW_KEY_RIGHT);
-    const int kEnter = glfwGetKey(w, GLFW_KEY_ENTER);
-    const int kEnter2 = glfwGetKey(w, GLFW_KEY_KP_ENTER);
-    const int kTab = glfwGetKey(w, GLFW_KEY_TAB);
-    const int kEsc = glfwGetKey(w, GLFW_KEY_ESCAPE);
-
-    const bool upEdge = (kUp == GLFW_PRESS && prevUp == GLFW_RELEASE);
-    const bool downEdge = (kDown == GLFW_PRESS && prevDown == GLFW_RELEASE);
-    const bool leftEdge = (kLeft == GLFW_PRESS && prevLeft == GLFW_RELEASE);
-    const bool rightEdge = (kRight == GLFW_PRESS && prevRight == GLFW_RELEASE);
-    const bool enterEdge = ((kEnter == GLFW_PRESS || kEnter2 == GLFW_PRESS) && prevEnter == GLFW_RELEASE);
-    const bool tabEdge = (kTab == GLFW_PRESS && prevTab == GLFW_RELEASE);
+    const bool upEdge = Input::WasPressed(GLFW_KEY_UP);
+    const bool downEdge = Input::WasPressed(GLFW_KEY_DOWN);
+    const bool leftEdge = Input::WasPressed(GLFW_KEY_LEFT);
+    const bool rightEdge = Input::WasPressed(GLFW_KEY_RIGHT);
+    const bool enterEdge = Input::WasPressed(GLFW_KEY_ENTER) || Input::WasPressed(GLFW_KEY_KP_ENTER);
+    const bool tabEdge = Input::WasPressed(GLFW_KEY_TAB);
+    const bool escEdge = Input::WasPressed(GLFW_KEY_ESCAPE);
 
     auto wrap = [](int v, int lo, int hi) { int n = hi - lo + 1; v = (v - lo + n) % n; return lo + v; };
 
@@ -680,6 +652,40 @@ void Menu::DrawUiSettingsModal(bool has_started)
         show_guideline_ = !show_guideline_;
     }
 
+    // -------------------------------
+    // Quality tier (Low/Medium/High/Ultra) - App resizes the render targets next frame
+    // -------------------------------
+    {
+        static constexpr const char* kTierLabels[] = { "Low", "Medium", "High", "Ultra" };
+        static constexpr int kTierCount = static_cast<int>(QualityTier::Count);
+        const int current = static_cast<int>(Quality::Tier());
+
+        std::string tierLabels[kTierCount];
+        float tierWidths[kTierCount] = { 0,0,0,0 };
+        float tierTotalPx = 0.0f;
+        for (int i = 0; i < kTierCount; ++i) {
+            tierLabels[i] = std::string(i == current ? "[x] " : "[ ] ") + kTierLabels[i];
+            tierWidths[i] = estimateWidthPx(tierLabels[i], cbScale);
+            tierTotalPx += tierWidths[i];
+        }
+        tierTotalPx += colGapPx * (kTierCount - 1);
+
+        float tx = 0.5f * width_ - 0.5f * tierTotalPx;
+        for (int i = 0; i < kTierCount; ++i) {
+            const float centerU = (tx + tierWidths[i] * 0.5f) / static_cast<float>(width_);
+            if (button(centerU, Vslide(qualityV, -0.5f, 60.0f), tierLabels[i], S(cbScale), Alignment::CENTER,
+                (i == current || uiFocus == 2), nullptr, nullptr) && interactive) {
+                Quality::SetTier(static_cast<QualityTier>(i));
+            }
+            tx += tierWidths[i] + colGapPx;
+        }
+
+        if (interactive && active_input_ == -1 && uiFocus == 2) {
+            if (leftEdge)  Quality::SetTier(static_cast<QualityTier>(std::max(0, current - 1)));
+            if (rightEdge) Quality::SetTier(static_cast<QualityTier>(std::min(kTierCount - 1, current + 1)));
+        }
+    }
+
     // -------------------------------
     // Player names (with caret & mouse focus)
     // -------------------------------
@@ -696,8 +702,8 @@ void Menu::DrawUiSettingsModal(bool has_started)
                 field += caretOn ? "|" : " ";
             }
 
-            // Highlight either when editing or when row is focused (2 or 3)
-            const bool rowFocused = (uiFocus == (fieldIndex == 0 ? 2 : 3));
+            // Highlight either when editing or when row is focused (3 or 4)
+            const bool rowFocused = (uiFocus == (fieldIndex == 0 ? 3 : 4));
 
             // Draw at the animated position/scale
             AddText(0.5f, drawV, std::string(label) + field, drawScale, Alignment::CENTER,
@@ -742,8 +748,8 @@ void Menu::DrawUiSettingsModal(bool has_started)
 
     // Start editing on Enter/Tab if focused on a name row and not already editing
     if (interactive && canEditNames && active_input_ == -1) {
-        if (uiFocus == 2 && (enterEdge || tabEdge)) active_input_ = 0;
-        if (uiFocus == 3 && (enterEdge || tabEdge)) active_input_ = 1;
+        if (uiFocus == 3 && (enterEdge || tabEdge)) active_input_ = 0;
+        if (uiFocus == 4 && (enterEdge || tabEdge)) active_input_ = 1;
     }
 
     // -------------------------------
@@ -769,7 +775,7 @@ void Menu::DrawUiSettingsModal(bool has_started)
         // Backspace auto-repeat
         static bool   bsWasDown = false;
         static double bsNext = 0.0;
-        bool   bsDown = (glfwGetKey(w, GLFW_KEY_BACKSPACE) == GLFW_PRESS);
+        bool   bsDown = Input::IsDown(GLFW_KEY_BACKSPACE);
         double now = glfwGetTime();
         if (bsDown) {
             if (!bsWasDown) { eraseLast(); bsNext = now + 0.45; }   // initial delay
@@ -788,20 +794,19 @@ void Menu::DrawUiSettingsModal(bool has_started)
         g_charQueue.clear();
 
         // Enter/Tab -> next field or finish
-        bool enterNow = (kEnter == GLFW_PRESS || kEnter2 == GLFW_PRESS);
-        if ((enterNow && prevEnter == GLFW_RELEASE) || tabEdge) {
+        if (enterEdge || tabEdge) {
             if (active_input_ == 0) {         // go to P2
                 active_input_ = 1;
-                uiFocus = 3;
+                uiFocus = 4;
             }
             else {                           // leave after P2
                 active_input_ = -1;
-                uiFocus = 4;                   // move to Close
+                uiFocus = 5;                   // move to Close
             }
         }
 
         // Esc exits the current field (doesn't close modal)
-        if (kEsc == GLFW_PRESS && prevEsc == GLFW_RELEASE) {
+        if (escEdge) {
             active_input_ = -1;
         }
     }
@@ -816,7 +821,7 @@ void Menu::DrawUiSettingsModal(bool has_started)
 
     // Close down
     if (interactive && button(0.5f, Vslide(closeV, +1.0f, 70.0f), "Close [Esc]", S(Ui(0.85f)),
-        Alignment::CENTER, (uiFocus == 4), nullptr, nullptr)) {
+        Alignment::CENTER, (uiFocus == 5), nullptr, nullptr)) {
         ui_settings_open_ = false;
         active_input_ = -1;
         rename_gate_open_ = false;
@@ -827,7 +832,7 @@ void Menu::DrawUiSettingsModal(bool has_started)
     // - if editing a field → exit field
     // - else → close modal
     // -------------------------------
-    if (interactive && kEsc == GLFW_PRESS && prevEsc == GLFW_RELEASE) {
+    if (interactive && escEdge) {
         if (active_input_ != -1) {
             active_input_ = -1;
         }
@@ -841,48 +846,34 @@ void Menu::DrawUiSettingsModal(bool has_started)
     // Arrow navigation between rows (only when NOT editing)
     // -------------------------------
     if (interactive && active_input_ == -1) {
-        if (upEdge)   uiFocus = wrap(uiFocus - 1, 0, 4);
-        if (downEdge) uiFocus = wrap(uiFocus + 1, 0, 4);
+        if (upEdge)   uiFocus = wrap(uiFocus - 1, 0, 5);
+        if (downEdge) uiFocus = wrap(uiFocus + 1, 0, 5);
 
         // Enter on "Close" closes
-        if (uiFocus == 4 && enterEdge) {
+        if (uiFocus == 5 && enterEdge) {
             ui_settings_open_ = false;
             rename_gate_open_ = false;
         }
     }
-
-    // keep previous key states
-    prevUp = kUp; prevDown = kDown; prevLeft = kLeft; prevRight = kRight;
-    prevEnter = (kEnter == GLFW_PRESS || kEnter2 == GLFW_PRESS) ? GLFW_PRESS : GLFW_RELEASE;
-    prevTab = kTab; prevEsc = kEsc;
 }
 
 
 void Menu::Draw(const bool not_loaded, const bool has_started)
 {
     texts_.clear();
-    GLFWwindow* w = glfwGetCurrentContext();
-
     const int winW = width_, winH = height_;
-    double mx, my; glfwGetCursorPos(w, &mx, &my);
-    const float mouseX = static_cast<float>(mx);
-    const float mouseY = static_cast<float>(winH - my);
+    const glm::dvec2 cursor = Input::Cursor();
+    const float mouseX = static_cast<float>(cursor.x);
+    const float mouseY = static_cast<float>(winH - cursor.y);
     mouse_x_ = mouseX; mouse_y_ = mouseY;
 
-    static int prevMouse = GLFW_RELEASE;
-    const  int curMouse = glfwGetMouseButton(w, GLFW_MOUSE_BUTTON_LEFT);
-    static int prevEnter = GLFW_RELEASE;
-    const  int curEnter = glfwGetKey(w, GLFW_KEY_ENTER);
+    const  bool enterPressed = Input::WasPressed(GLFW_KEY_ENTER);
 
-    // NEW: edge-detect left/right for keyboard nav
-    static int prevLeft = GLFW_RELEASE;
-    static int prevRight = GLFW_RELEASE;
-    const  int curLeft = glfwGetKey(w, GLFW_KEY_LEFT);
-    const  int curRight = glfwGetKey(w, GLFW_KEY_RIGHT);
-    const  bool leftEdge = (curLeft == GLFW_PRESS && prevLeft == GLFW_RELEASE);
-    const  bool rightEdge = (curRight == GLFW_PRESS && prevRight == GLFW_RELEASE);
+    // edge-detect left/right for keyboard nav
+    const  bool leftEdge = Input::WasPressed(GLFW_KEY_LEFT);
+    const  bool rightEdge = Input::WasPressed(GLFW_KEY_RIGHT);
 
-    mouse_edge_down_ = (curMouse == GLFW_PRESS && prevMouse == GLFW_RELEASE);
+    mouse_edge_down_ = Input::WasMousePressed(GLFW_MOUSE_BUTTON_LEFT);
 
 
     // --- modal animation (open→1, closed→0) ---
@@ -954,8 +945,8 @@ void Menu::Draw(const bool not_loaded, const bool has_started)
     // ---------------------------------------
 
     // Main vs Pause
-    if (!has_started) DrawMainMenu(modalOpen, winW, winH, mouseX, mouseY, curEnter, prevEnter, selected_);
-    else              DrawPauseMenu(modalOpen, winW, winH, mouseX, mouseY, curEnter, prevEnter, selected_);
+    if (!has_started) DrawMainMenu(modalOpen, winW, winH, mouseX, mouseY, enterPressed, selected_);
+    else              DrawPauseMenu(modalOpen, winW, winH, mouseX, mouseY, enterPressed, selected_);
 
     // Modals
     // Draw modals while animating, not just while *open*
@@ -967,7 +958,7 @@ void Menu::Draw(const bool not_loaded, const bool has_started)
     const int gearIndex = has_started ? 5 : 3; // index we gave to the gear on each page
     if (!ui_settings_open_) {
         const bool isSelected = (selected_ == gearIndex);
-        const bool enterOnGear = isSelected && (curEnter == GLFW_PRESS && prevEnter == GLFW_RELEASE);
+        const bool enterOnGear = isSelected && enterPressed;
         const bool clicked = DrawSettingsIcon(winW, winH, isSelected);
         if (clicked || enterOnGear) {
             ui_settings_open_ = true;
@@ -975,10 +966,6 @@ void Menu::Draw(const bool not_loaded, const bool has_started)
         }
     }
 
-    prevMouse = curMouse;
-    prevEnter = curEnter;
-    prevLeft = curLeft;
-    prevRight = curRight;
 
     // If no text field is focused, drop any typed characters this frame
     if (active_input_ == -1 && !g_charQueue.empty())
@@ -995,21 +982,15 @@ void Menu::Draw(const bool not_loaded, const bool has_started)
 
 void Menu::ControlState()
 {
-    GLFWwindow* window = glfwGetCurrentContext();
-
     // DOWN: move selection down; if nothing selected yet, start at 0
-    const int down_state = glfwGetKey(window, GLFW_KEY_DOWN);
-    if (down_state == GLFW_PRESS && last_down_state_ != GLFW_PRESS) {
+    if (Input::WasPressed(GLFW_KEY_DOWN)) {
         if (selected_ == -1) selected_ = 0; else selected_++;
     }
-    last_down_state_ = down_state;
 
     // UP: move selection up; if nothing selected yet, start at 0
-    const int up_state = glfwGetKey(window, GLFW_KEY_UP);
-    if (up_state == GLFW_PRESS && last_up_state_ != GLFW_PRESS) {
+    if (Input::WasPressed(GLFW_KEY_UP)) {
         if (selected_ == -1) selected_ = 0; else selected_--;
     }
-    last_up_state_ = up_state;
 }
 
 void Menu::AddText(const float u, const float v, const std::string& text,
@@ -78,11 +78,9 @@ private:
 
 	// ---------- helpers ----------
 	void DrawMainMenu(bool modalOpen, int winW, int winH,
-		float mouseX, float mouseY, int curEnter,
-		int& prevEnter, int& selected);
+		float mouseX, float mouseY, bool enterPressed, int& selected);
 	void DrawPauseMenu(bool modalOpen, int winW, int winH,
-		float mouseX, float mouseY, int curEnter,
-		int& prevEnter, int& selected);
+		float mouseX, float mouseY, bool enterPressed, int& selected);
 	void DrawQuickSetupModal(int winW, int winH, float mouseX, float mouseY, bool has_started);
 	void DrawHelpModal(bool has_started);
 	bool DrawSettingsIcon(int winW, int winH, bool selected);         // bottom-right launcher
@@ -105,7 +103,6 @@ private:
 	int width_{};
 	int height_{};
 	int selected_{};
-	int last_left_state_{}, last_up_state_{}, last_right_state_{}, last_down_state_{};
 	std::vector<Text> texts_{};
 
 	// mouse
@@ -241,22 +241,32 @@ bool TextRenderer::AddFaceFromPath(const std::filesystem::path& p) {
 	return true;
 }
 
+bool TextRenderer::AddFaceFromAsset(const std::string& path) {
+	auto file = FileSystem::Open(path);
+	if (!file) return false;
+	FT_Face f{};
+	if (FT_New_Memory_Face(ft_, file.Data(), static_cast<FT_Long>(file.Size()), 0, &f)) return false;
+	FT_Set_Pixel_Sizes(f, 0, Config::default_font_size);
+	FT_Select_Charmap(f, FT_ENCODING_UNICODE);
+	faces_.push_back(f);
+	face_paths_.push_back(path);
+	face_data_.push_back(std::move(file));
+	return true;
+}
+
 void TextRenderer::Load() {
 	if (FT_Init_FreeType(&ft_))
 		throw std::exception("Could not init FreeType Library");
 
 	// 1) Primary UI font (KEEP THIS AS A NORMAL TEXT FONT)
 	//    e.g. "NotoSans-Regular.ttf" (not the symbols file)
-	const auto primary = std::filesystem::current_path()
-		/ "assets" / "fonts" / Config::font_path;
-	if (!AddFaceFromPath(primary))
+	const auto primary = std::string("assets/fonts/") + Config::font_path;
+	if (!AddFaceFromAsset(primary))
 		throw std::exception("Failed to load primary UI font");
 
 	// 2) Fallbacks (try symbols + system)
 	// assets fallback: NotoSansSymbols2-Regular.ttf
-	auto fb1 = std::filesystem::current_path()
-		/ "assets" / "fonts" / "NotoSansSymbols2-Regular.ttf";
-	AddFaceFromPath(fb1);
+	AddFaceFromAsset("assets/fonts/NotoSansSymbols2-Regular.ttf");
 
 #ifdef _WIN32
 	// Windows: Segoe UI Symbol
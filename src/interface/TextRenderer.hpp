@@ -3,6 +3,7 @@
 #include "Menu.hpp"
 #include "../core/Shader.hpp"
 #include "../core/Texture.hpp"
+#include "../core/FileSystem.hpp"
 
 
 struct Character
@@ -40,6 +41,7 @@ private:
 
     // Load an extra FT_Face and add to fallback list (primary inserted first)
     bool AddFaceFromPath(const std::filesystem::path& p);
+    bool AddFaceFromAsset(const std::string& path);
 
 private:
     // glyph cache by Unicode codepoint
@@ -56,6 +58,8 @@ private:
     // faces_[0] is the primary UI face; the rest are fallbacks
     std::vector<FT_Face> faces_{};
     std::vector<std::filesystem::path> face_paths_{};
+    // backing bytes for memory faces (FreeType reads them lazily)
+    std::vector<FileView> face_data_{};
 
     // --- styling ---
     bool      draw_shadow_ = true;
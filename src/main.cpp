@@ -1,11 +1,11 @@
 #include "precompiled.h"
 #include "core/App.hpp"
 
-int main()
+int main(int argc, char** argv)
 {
 	try
 	{
-		App app;
+		App app(LockstepOptions::Parse(argc, argv));
 		app.Run();
 	}
 	catch (const std::exception& e)
@@ -0,0 +1,59 @@
+#pragma once
+#include "../headless.h"
+
+#include <bit>
+#include <cstring>
+
+// Little-endian framing shared by the network protocols: a frame is a u16 payload
+// size, then the payload. Values are copied in host order, hence the assert.
+static_assert(std::endian::native == std::endian::little, "wire format is written as host order");
+
+class ByteWriter
+{
+public:
+	template<class T>
+	void Put(const T value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+		bytes_.insert(bytes_.end(), bytes, bytes + sizeof(T));
+	}
+
+	// Prepends the frame header; the writer is empty afterwards
+	std::vector<uint8_t> Frame()
+	{
+		std::vector<uint8_t> frame(sizeof(uint16_t) + bytes_.size());
+		const auto size = static_cast<uint16_t>(bytes_.size());
+		std::memcpy(frame.data(), &size, sizeof(size));
+		std::copy(bytes_.begin(), bytes_.end(), frame.begin() + sizeof(size));
+		bytes_.clear();
+		return frame;
+	}
+
+private:
+	std::vector<uint8_t> bytes_{};
+};
+
+class ByteReader
+{
+public:
+	ByteReader(const uint8_t* data, const size_t size) : data_(data), size_(size) {}
+
+	template<class T>
+	bool Get(T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		if (size_ - position_ < sizeof(T))
+			return false;
+		std::memcpy(&value, data_ + position_, sizeof(T));
+		position_ += sizeof(T);
+		return true;
+	}
+
+	[[nodiscard]] bool AtEnd() const { return position_ == size_; }
+
+private:
+	const uint8_t* data_;
+	size_t size_;
+	size_t position_ = 0;
+};
@@ -0,0 +1,250 @@
+#include "../precompiled.h"
+#include "LockstepSession.hpp"
+#include "ByteStream.hpp"
+#include "Logger.hpp"
+
+namespace
+{
+	using Type = LockstepMessage::Type;
+
+	constexpr size_t kMaxPayload = 64;
+
+	bool AllFinite(const std::initializer_list<float> values)
+	{
+		return std::all_of(values.begin(), values.end(), [](const float value) { return std::isfinite(value); });
+	}
+
+	std::vector<uint8_t> Encode(const LockstepMessage& message)
+	{
+		ByteWriter writer;
+		writer.Put(message.type);
+		switch (message.type)
+		{
+		case Type::Hello:
+			writer.Put(LockstepSession::protocol_version);
+			writer.Put(message.seed);
+			writer.Put(message.damping.dt);
+			writer.Put(message.damping.linear);
+			writer.Put(message.damping.angular);
+			break;
+		case Type::Shot:
+			writer.Put(message.velocity.x);
+			writer.Put(message.velocity.y);
+			writer.Put(message.velocity.z);
+			writer.Put(message.spin.x);
+			writer.Put(message.spin.y);
+			break;
+		case Type::PlaceCueBall:
+			writer.Put(message.position.x);
+			writer.Put(message.position.y);
+			writer.Put(static_cast<uint8_t>(message.confirm));
+			break;
+		case Type::NewRack:
+			writer.Put(message.seed);
+			break;
+		case Type::StateHash:
+			writer.Put(message.rack);
+			writer.Put(message.shot);
+			writer.Put(message.hash);
+			break;
+		default:
+			break;
+		}
+		return writer.Frame();
+	}
+
+	std::optional<LockstepMessage> Decode(const uint8_t* payload, const size_t size)
+	{
+		ByteReader reader(payload, size);
+		LockstepMessage message;
+		if (!reader.Get(message.type))
+			return std::nullopt;
+
+		bool ok = true;
+		uint16_t version = 0;
+		uint8_t confirm = 0;
+		switch (message.type)
+		{
+		case Type::Hello:
+			ok = reader.Get(version) && version == LockstepSession::protocol_version && reader.Get(message.seed) &&
+				reader.Get(message.damping.dt) && reader.Get(message.damping.linear) && reader.Get(message.damping.angular) &&
+				AllFinite({ message.damping.dt, message.damping.linear, message.damping.angular });
+			break;
+		case Type::Shot:
+			// NaN or inf would go straight into the cue ball and spread through the contacts
+			ok = reader.Get(message.velocity.x) && reader.Get(message.velocity.y) && reader.Get(message.velocity.z) &&
+				reader.Get(message.spin.x) && reader.Get(message.spin.y) &&
+				AllFinite({ message.velocity.x, message.velocity.y, message.velocity.z, message.spin.x, message.spin.y });
+			break;
+		case Type::PlaceCueBall:
+			ok = reader.Get(message.position.x) && reader.Get(message.position.y) && reader.Get(confirm) &&
+				AllFinite({ message.position.x, message.position.y });
+			message.confirm = confirm != 0;
+			break;
+		case Type::ClockExpired:
+		case Type::RackRequest:
+			break;
+		case Type::NewRack:
+			ok = reader.Get(message.seed);
+			break;
+		case Type::StateHash:
+			ok = reader.Get(message.rack) && reader.Get(message.shot) && reader.Get(message.hash);
+			break;
+		default:
+			return std::nullopt;
+		}
+		if (!ok || !reader.AtEnd())
+			return std::nullopt;
+		return message;
+	}
+}
+
+LockstepOptions LockstepOptions::Parse(const int argc, char** argv)
+{
+	LockstepOptions options;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view arg = argv[i];
+		const bool has_value = i + 1 < argc && argv[i + 1][0] != '-';
+		if (arg == "--host")
+		{
+			options.mode = Mode::Host;
+			if (has_value)
+				options.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+		}
+		else if (arg == "--join" && has_value)
+		{
+			options.mode = Mode::Join;
+			options.address = argv[++i];
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+				options.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+		}
+		else
+		{
+			throw std::runtime_error("usage: 8-Ball-Pool [--host [port] | --join address [port]]");
+		}
+	}
+	return options;
+}
+
+std::unique_ptr<LockstepSession> LockstepSession::Open(const LockstepOptions& options, const TickDamping& host_damping)
+{
+	if (options.mode == LockstepOptions::Mode::Off)
+		return nullptr;
+
+	std::unique_ptr<LockstepSession> session(new LockstepSession(options.mode == LockstepOptions::Mode::Host, host_damping));
+	if (session->host_)
+	{
+		session->listener_ = Socket::Listen(options.port, false);
+		LOG_INFO(General, std::format("Lockstep: waiting for an opponent on port {}", options.port));
+	}
+	else
+	{
+		session->socket_ = Socket::Connect(options.address, options.port);
+		session->connected_.store(true);
+		LOG_INFO(General, std::format("Lockstep: connected to {}:{}", options.address, options.port));
+	}
+	session->thread_ = std::thread([session = session.get()] { session->Run(); });
+	return session;
+}
+
+LockstepSession::LockstepSession(const bool host, const TickDamping& host_damping) :
+	host_(host),
+	host_damping_(host_damping)
+{
+}
+
+LockstepSession::~LockstepSession()
+{
+	stopping_.store(true);
+	{
+		// Wake the session thread; the handles it may still be inside close with the members, after the join
+		std::lock_guard lock(socket_mutex_);
+		listener_.WakeAccept();
+		socket_.Shutdown();
+	}
+	if (thread_.joinable())
+		thread_.join();
+}
+
+void LockstepSession::Send(const LockstepMessage& message)
+{
+	if (!connected_.load() || closed_.load())
+		return;
+	const auto frame = Encode(message);
+	std::lock_guard lock(socket_mutex_);
+	if (!socket_.SendAll(frame.data(), frame.size()))
+		closed_.store(true);
+}
+
+std::optional<LockstepMessage> LockstepSession::Poll()
+{
+	std::lock_guard lock(inbox_mutex_);
+	if (inbox_.empty())
+		return std::nullopt;
+	LockstepMessage message = inbox_.front();
+	inbox_.pop_front();
+	return message;
+}
+
+void LockstepSession::Deliver(const LockstepMessage& message)
+{
+	std::lock_guard lock(inbox_mutex_);
+	inbox_.push_back(message);
+}
+
+void LockstepSession::Run()
+{
+	if (host_)
+	{
+		// The host decides the rack and the damping factors both tables use
+		LockstepMessage hello;
+		hello.type = Type::Hello;
+		hello.seed = std::random_device{}();
+		hello.damping = host_damping_;
+		const auto frame = Encode(hello);
+
+		Socket peer = listener_.Accept();
+		{
+			std::lock_guard lock(socket_mutex_);
+			if (!peer.IsValid() || stopping_.load())
+			{
+				closed_.store(true);
+				return;
+			}
+			socket_ = std::move(peer);
+			listener_.Close();   // one opponent per session
+			if (!socket_.SendAll(frame.data(), frame.size()))
+			{
+				closed_.store(true);
+				return;
+			}
+		}
+		Deliver(hello);
+		connected_.store(true);
+		LOG_INFO(General, "Lockstep: opponent connected");
+	}
+
+	std::vector<uint8_t> payload;
+	while (!stopping_.load())
+	{
+		uint16_t size = 0;
+		if (!socket_.ReceiveAll(&size, sizeof(size)) || size > kMaxPayload)
+			break;
+		payload.resize(size);
+		if (!socket_.ReceiveAll(payload.data(), payload.size()))
+			break;
+
+		const std::optional<LockstepMessage> message = Decode(payload.data(), payload.size());
+		// Hello and NewRack only come from the host, RackRequest only from the guest
+		const bool misdirected = message && (host_ ? message->type == Type::Hello || message->type == Type::NewRack
+			: message->type == Type::RackRequest);
+		if (!message || misdirected)
+		{
+			LOG_ERROR(General, "Lockstep: unexpected or invalid message (different game version?)");
+			break;
+		}
+		Deliver(*message);
+	}
+	closed_.store(true);
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "../precompiled.h"
+#include "Socket.hpp"
+#include "../physics/BallBody.hpp"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// What one player tells the other in a lockstep match. Only decisions travel: both
+// sides run the same deterministic TableSimulation from the same rack, so a shot is
+// a few dozen bytes and the table itself never goes over the wire, only a hash of
+// it after every shot to catch a desync.
+//
+// Frames as in net/ByteStream.hpp, payload u8 type, then per type
+//   Hello        u16 version, u32 seed, f32 dt, f32 linear, f32 angular (host -> guest)
+//   Shot         f32 velocity x3, f32 spin x2
+//   PlaceCueBall f32 x, f32 z, u8 confirm
+//   ClockExpired -
+//   NewRack      u32 seed                  (host -> guest)
+//   StateHash    u32 rack, u32 shot, u64 hash
+//   RackRequest  -                         (guest -> host, answered with a NewRack)
+// A message with a number that is not finite ends the session.
+struct LockstepMessage
+{
+	enum class Type : uint8_t { Hello = 1, Shot, PlaceCueBall, ClockExpired, NewRack, StateHash, RackRequest };
+
+	Type type = Type::Hello;
+	uint32_t seed = 0;                // Hello, NewRack: rack shuffle
+	TickDamping damping{};            // Hello: the host's, used by both sides
+	glm::vec3 velocity{ 0.0f };       // Shot: cue pose and power as they struck the ball, bit-exact
+	glm::vec2 spin{ 0.0f };           // Shot: tip offset
+	glm::vec2 position{ 0.0f };       // PlaceCueBall: requested x, z
+	bool confirm = false;             // PlaceCueBall: released there (else the placement fouled)
+	uint32_t rack = 0;                // StateHash: racks played this session, 1 = first
+	uint32_t shot = 0;                // StateHash: shots resolved on that rack
+	uint64_t hash = 0;                // StateHash: TableSimulation::StateHash
+};
+
+// --host [port] | --join address [port] on the game's command line
+struct LockstepOptions
+{
+	enum class Mode : uint8_t { Off, Host, Join };
+
+	Mode mode = Mode::Off;
+	std::string address{};
+	uint16_t port = 27016;
+
+	// Throws on anything it does not understand
+	static LockstepOptions Parse(int argc, char** argv);
+};
+
+// One peer-to-peer TCP connection carrying LockstepMessages. Connecting and reading
+// happen on a thread of its own; the simulation thread only sends and polls.
+// The host plays player 0 (breaks) and picks every rack; the guest plays player 1.
+class LockstepSession final
+{
+public:
+	// Nullptr when 'options' is Off. Joining connects right away; hosting listens on
+	// all interfaces and waits for the opponent in the background. A host sends
+	// 'host_damping' (its own table's) in the Hello. Throws on failure
+	static std::unique_ptr<LockstepSession> Open(const LockstepOptions& options, const TickDamping& host_damping);
+	~LockstepSession();
+
+	LockstepSession(const LockstepSession&) = delete;
+	LockstepSession& operator= (const LockstepSession&) = delete;
+
+	[[nodiscard]] int LocalPlayer() const { return host_ ? 0 : 1; }
+	// The connection dropped (or the opponent spoke another protocol version)
+	[[nodiscard]] bool IsClosed() const { return closed_.load(); }
+
+	// Dropped while not connected yet
+	void Send(const LockstepMessage& message);
+	// Next message from the opponent, in order. The host also gets its own Hello
+	// here, so both sides start the match on the same path
+	std::optional<LockstepMessage> Poll();
+
+	static constexpr uint16_t protocol_version = 2;
+
+private:
+	LockstepSession(bool host, const TickDamping& host_damping);
+
+	void Run();
+	void Deliver(const LockstepMessage& message);
+
+	bool host_;
+	const TickDamping host_damping_;      // Hello: what both tables use
+	Socket listener_{};
+	Socket socket_{};
+	std::mutex socket_mutex_;             // guards the handles: socket_ is set on the session thread, sent on from the simulation
+	std::atomic<bool> connected_{ false };
+	std::atomic<bool> closed_{ false };
+	std::atomic<bool> stopping_{ false };
+
+	std::mutex inbox_mutex_;
+	std::deque<LockstepMessage> inbox_{};
+
+	std::thread thread_;
+};
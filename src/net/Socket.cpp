@@ -0,0 +1,203 @@
+#include "../headless.h"
+#include "Socket.hpp"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+	using NativeSocket = SOCKET;
+	using IoLength = int;
+
+	// WSAStartup once per process, before the first socket
+	void EnsureStartup()
+	{
+		static const bool started = [] {
+			WSADATA data{};
+			if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+				throw std::runtime_error("WSAStartup failed");
+			return true;
+		}();
+		(void)started;
+	}
+
+	void CloseNative(const NativeSocket s) { closesocket(s); }
+	constexpr int kShutdownBoth = SD_BOTH;
+	constexpr int kSendFlags = 0;
+#else
+	using NativeSocket = int;
+	using IoLength = size_t;
+
+	void EnsureStartup() {}
+	void CloseNative(const NativeSocket s) { close(s); }
+	constexpr int kShutdownBoth = SHUT_RDWR;
+	constexpr int kSendFlags = MSG_NOSIGNAL;   // a dropped peer is an error return, not SIGPIPE
+#endif
+
+	NativeSocket Native(const uintptr_t handle) { return static_cast<NativeSocket>(handle); }
+
+	void DisableNagle(const NativeSocket s)
+	{
+		int on = 1;
+		setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+	}
+}
+
+Socket::~Socket()
+{
+	Close();
+}
+
+Socket::Socket(Socket&& other) noexcept : handle_(std::exchange(other.handle_, invalid_handle))
+{
+}
+
+Socket& Socket::operator= (Socket&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		handle_ = std::exchange(other.handle_, invalid_handle);
+	}
+	return *this;
+}
+
+Socket Socket::Listen(const uint16_t port, const bool loopback_only)
+{
+	EnsureStartup();
+
+	const NativeSocket s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	Socket listener(static_cast<Handle>(s));
+	if (!listener.IsValid())
+		throw std::runtime_error("socket() failed");
+
+	int reuse = 1;
+	setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(loopback_only ? INADDR_LOOPBACK : INADDR_ANY);
+
+	if (bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+		throw std::runtime_error(std::format("Cannot bind port {}", port));
+	if (listen(s, SOMAXCONN) != 0)
+		throw std::runtime_error("listen() failed");
+	return listener;
+}
+
+Socket Socket::Connect(const std::string& host, const uint16_t port)
+{
+	EnsureStartup();
+
+	addrinfo hints{};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	addrinfo* found = nullptr;
+	const std::string service = std::to_string(port);
+	if (getaddrinfo(host.c_str(), service.c_str(), &hints, &found) != 0 || !found)
+		throw std::runtime_error("Cannot resolve " + host);
+
+	Socket connection;
+	for (const addrinfo* candidate = found; candidate && !connection.IsValid(); candidate = candidate->ai_next)
+	{
+		Socket attempt(static_cast<Handle>(socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol)));
+		if (attempt.IsValid() && connect(Native(attempt.handle_), candidate->ai_addr, static_cast<int>(candidate->ai_addrlen)) == 0)
+			connection = std::move(attempt);
+	}
+	freeaddrinfo(found);
+
+	if (!connection.IsValid())
+		throw std::runtime_error(std::format("Cannot connect to {}:{}", host, port));
+	DisableNagle(Native(connection.handle_));
+	return connection;
+}
+
+Socket Socket::Accept() const
+{
+	const NativeSocket s = accept(Native(handle_), nullptr, nullptr);
+	Socket client(static_cast<Handle>(s));
+	if (client.IsValid())
+		DisableNagle(s);
+	return client;
+}
+
+bool Socket::SendAll(const void* data, size_t size) const
+{
+	const auto* bytes = static_cast<const char*>(data);
+	while (size > 0)
+	{
+		const auto sent = send(Native(handle_), bytes, static_cast<IoLength>(size), kSendFlags);
+		if (sent <= 0)
+			return false;
+		bytes += sent;
+		size -= static_cast<size_t>(sent);
+	}
+	return true;
+}
+
+bool Socket::ReceiveAll(void* data, size_t size) const
+{
+	auto* bytes = static_cast<char*>(data);
+	while (size > 0)
+	{
+		const auto received = recv(Native(handle_), bytes, static_cast<IoLength>(size), 0);
+		if (received <= 0)
+			return false;
+		bytes += received;
+		size -= static_cast<size_t>(received);
+	}
+	return true;
+}
+
+void Socket::Shutdown() const
+{
+	if (IsValid())
+		shutdown(Native(handle_), kShutdownBoth);
+}
+
+void Socket::WakeAccept() const
+{
+	if (!IsValid())
+		return;
+	sockaddr_in address{};
+	socklen_t length = sizeof(address);
+	if (getsockname(Native(handle_), reinterpret_cast<sockaddr*>(&address), &length) != 0)
+		return;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	const Socket wake(static_cast<Handle>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)));
+	if (wake.IsValid())
+		connect(Native(wake.handle_), reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+}
+
+void Socket::Close()
+{
+	if (!IsValid())
+		return;
+	// shutdown first: a peer blocked on the other end sees the stream end
+	shutdown(Native(handle_), kShutdownBoth);
+	CloseNative(Native(handle_));
+	handle_ = invalid_handle;
+}
+
+uint16_t Socket::LocalPort() const
+{
+	sockaddr_in address{};
+	socklen_t length = sizeof(address);
+	if (getsockname(Native(handle_), reinterpret_cast<sockaddr*>(&address), &length) != 0)
+		return 0;
+	return ntohs(address.sin_port);
+}
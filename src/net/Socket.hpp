@@ -0,0 +1,49 @@
+#pragma once
+#include "../headless.h"
+
+// Blocking TCP stream socket over Winsock (Windows) or BSD sockets, move-only.
+// Small request/reply traffic, so Nagle is off on every connected socket.
+// Setup failures throw; I/O failures (peer gone) return false.
+class Socket final
+{
+public:
+	Socket() = default;
+	~Socket();
+
+	Socket(Socket&& other) noexcept;
+	Socket& operator= (Socket&& other) noexcept;
+	Socket(const Socket&) = delete;
+	Socket& operator= (const Socket&) = delete;
+
+	// Listens on 127.0.0.1 ('loopback_only') or all interfaces; port 0 picks a free one (see LocalPort)
+	static Socket Listen(uint16_t port, bool loopback_only = true);
+	static Socket Connect(const std::string& host, uint16_t port);
+
+	// Blocks for the next client; invalid once the listener is closed
+	[[nodiscard]] Socket Accept() const;
+
+	bool SendAll(const void* data, size_t size) const;
+	// Blocks until exactly 'size' bytes arrived; false if the peer closed first
+	bool ReceiveAll(void* data, size_t size) const;
+
+	// Wakes a thread blocked in ReceiveAll on this socket and fails its later I/O, but
+	// keeps the handle: safe while that thread is still inside a call
+	void Shutdown() const;
+	// Wakes a thread blocked in Accept on this listener by connecting to it over
+	// loopback (shutdown does not do that on Windows); it gets that connection back
+	void WakeAccept() const;
+	// Releases the handle: only once no other thread can be using the socket
+	void Close();
+
+	[[nodiscard]] bool IsValid() const { return handle_ != invalid_handle; }
+	[[nodiscard]] uint16_t LocalPort() const;
+
+private:
+	// SOCKET (Windows) and int (POSIX) both fit; their invalid values map to all ones
+	using Handle = uintptr_t;
+	static constexpr Handle invalid_handle = ~Handle{ 0 };
+
+	explicit Socket(Handle handle) : handle_(handle) {}
+
+	Handle handle_ = invalid_handle;
+};
@@ -1,33 +1,43 @@
 ﻿#pragma once
 #include "../precompiled.h"
-#include "Ball.hpp"
-#include "CueBallMap.hpp"
+#include "../core/Object.hpp"
+#include "../physics/BallBody.hpp"
+#include "../core/Snapshot.hpp"
 
 class Cue final : public Object
 {
 public:
-	Cue(std::shared_ptr<CueBallMap> cue_ball_map);
-	void HandleShot(const std::shared_ptr<Ball>& white_ball, float dt);
-	void PlaceAtBall(const std::shared_ptr<Ball>& ball);
+	Cue();
+	// Aims/fires from the sampled input (simulation thread). True on the tick it strikes the ball
+	bool HandleShot(BallBody& white_ball, float dt, const SimulationInput& input);
+	// What HandleShot would give the white ball if it fired now with 'strike_force' (before spin)
+	[[nodiscard]] glm::vec3 ShotVelocity(const BallBody& white_ball, float strike_force) const;
+	void PlaceAtBall(const BallBody& ball);
 
-	//override to apply visual tilt
-	void Draw(const std::shared_ptr<Shader>& shader) override;
-
-	// Add the GetCueBallMap method
-	std::shared_ptr<CueBallMap> GetCueBallMap() const { return cue_ball_map_; }
+	// Yaw around the (slightly tilted) arc axis; the cue keeps an absolute yaw
+	// instead of accumulating rotations so AimDir() stays exact
+	void SetYaw(float yaw, const glm::vec3& axis);
+	void AddYaw(const glm::vec3& axis, float delta);
+	[[nodiscard]] float GetYaw() const { return yaw_; }
 
 	glm::vec3 AimDir() const {
 		const glm::vec3 up(0, 1, 0);
-		const glm::vec3 cueDir(std::sin(angle_), 0.0f, std::cos(angle_));
+		const glm::vec3 cueDir(std::sin(yaw_), 0.0f, std::cos(yaw_));
 		return -glm::normalize(glm::cross(cueDir, up)); // matches HandleShot()
 	}
 
 	// --- elevation state ---
 	float elevation_angle_ = 0.0f;      // radians, 0..~0.44 (25°)
 
+protected:
+	// override to apply visual tilt
+	[[nodiscard]] glm::mat4 BuildModelMatrix() const override;
+
 private:
+	float yaw_ = 0.0f;
+	glm::vec3 yaw_axis_{ 0.0f, 1.0f, 0.0f };
+
 	bool power_changed_{false};
-	std::shared_ptr<CueBallMap> cue_ball_map_;
 
 	// --- press-to-step support ---
 	float target_elevation_angle_ = 0.0f; // radians
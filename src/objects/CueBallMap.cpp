@@ -1,6 +1,7 @@
 #include "../precompiled.h"
 #include "CueBallMap.hpp"
 #include "../core/Loader.hpp"
+#include "../interface/Input.hpp"
 
 CueBallMap::CueBallMap(Camera& camera, GLFWwindow* window)
     : camera_(camera), window_(window), is_dragging_(false), is_visible_(false), is_highlighted_(false), is_within_bounds_(false) {
@@ -12,8 +13,7 @@ CueBallMap::CueBallMap(Camera& camera, GLFWwindow* window)
     aim_position_ = cue_ball_center_;  // Ensure the red dot starts in the center of the cue ball
 
     // Load the cue ball texture
-    auto cue_ball_texture_path = (std::filesystem::current_path() / "assets/textures/ball0.jpg").string();
-    auto cue_ball_texture = Loader::LoadTexture(cue_ball_texture_path);
+    auto cue_ball_texture = Loader::LoadTexture("ball0.jpg");
 
     // Create material for the cue ball
     auto cue_ball_material = std::make_shared<Material>();
@@ -26,8 +26,8 @@ CueBallMap::CueBallMap(Camera& camera, GLFWwindow* window)
     cue_ball_sprite_ = std::make_shared<Object>();
     cue_ball_sprite_->SetMaterials({ cue_ball_material });
     cue_ball_sprite_->SetMeshes({ cue_ball_mesh });
-    cue_ball_sprite_->translation_ = glm::vec3(cue_ball_center_, 0.0f);
-    cue_ball_sprite_->scale_ = glm::vec3(cue_ball_radius_);
+    cue_ball_sprite_->SetTranslation(glm::vec3(cue_ball_center_, 0.0f));
+    cue_ball_sprite_->SetScaling(glm::vec3(cue_ball_radius_));
 
     // Create a red dot texture
     unsigned char red_pixel[3] = { 136, 8, 8 };
@@ -78,14 +78,14 @@ std::shared_ptr<Mesh> CueBallMap::CreateCircleMesh(float radius, int segments) {
     std::vector<unsigned> indices;
 
     // Center vertex
-    vertices.push_back({ {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.5f, 0.5f}, 0 });
+    vertices.push_back({ {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.5f, 0.5f} });
 
     // Circle vertices
     for (int i = 0; i <= segments; ++i) {
         float angle = glm::two_pi<float>() * i / segments;
         float x = radius * cos(angle);
         float y = radius * sin(angle);
-        vertices.push_back({ {x, y, 0.0f}, {0.0f, 0.0f, 1.0f}, {x * 0.5f + 0.5f, y * 0.5f + 0.5f}, 0 });
+        vertices.push_back({ {x, y, 0.0f}, {0.0f, 0.0f, 1.0f}, {x * 0.5f + 0.5f, y * 0.5f + 0.5f} });
     }
 
     // Indices
@@ -107,7 +107,7 @@ void CueBallMap::UpdateWindowSize() {
     // Adjust the scale of the cue ball relative to the window size
     float scale_factor = static_cast<float>(window_width) / 1920.0f;
     cue_ball_radius_ = 60.0f * scale_factor;
-    cue_ball_sprite_->scale_ = glm::vec3(cue_ball_radius_);
+    cue_ball_sprite_->SetScaling(glm::vec3(cue_ball_radius_));
 
     // Calculate the new center of the cue ball
     glm::vec2 new_cue_ball_center = glm::vec2(window_width - cue_ball_radius_ - 10.0f, window_height - cue_ball_radius_ - 10.0f);
@@ -189,8 +189,7 @@ void CueBallMap::DrawRedDot(const glm::mat4& screenProjection) {
 void CueBallMap::HandleMouseInput(GLFWwindow* window) {
     if (!is_visible_) return;
 
-    double mouse_x, mouse_y;
-    glfwGetCursorPos(window, &mouse_x, &mouse_y);
+    double mouse_x = Input::Cursor().x, mouse_y = Input::Cursor().y;
 
     int window_width, window_height;
     glfwGetFramebufferSize(window, &window_width, &window_height);
@@ -215,9 +214,7 @@ void CueBallMap::HandleMouseInput(GLFWwindow* window) {
         glfwSetCursor(window, glfwCreateStandardCursor(GLFW_ARROW_CURSOR)); // Change cursor back to arrow
     }
 
-    int left_button_state = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
-
-    if (left_button_state == GLFW_PRESS) {
+    if (Input::IsMouseDown(GLFW_MOUSE_BUTTON_LEFT)) {
         // Prevent the camera from switching views if in top-down view
         if (camera_.IsTopDownView()) {
             // Start drag if within 'hit' range of the red dot
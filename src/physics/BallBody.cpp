@@ -0,0 +1,212 @@
+#include "../headless.h"
+#include "BallBody.hpp"
+
+void BallBody::Shot(const glm::vec3 power, const glm::vec2 shot_spin)
+{
+	if (!IsInMotion()) {
+		velocity = power;
+		spin = shot_spin;
+
+		// remember direction of travel (horizontal component)
+		glm::vec3 horiz = glm::vec3(velocity.x, 0.0f, velocity.z);
+		if (glm::length(horiz) > Config::min_change)
+			last_dir = glm::normalize(horiz);
+	}
+}
+
+void BallBody::Roll(const float dt, const TickDamping& damping, const PhysicsParams& params)
+{
+	// Integrate position
+	position += velocity * dt;
+
+	// Update last_dir from horizontal velocity if meaningful
+	glm::vec3 horiz_v = { velocity.x, 0.0f, velocity.z };
+	const float speed = glm::length(horiz_v);
+	if (speed > Config::min_change) {
+		last_dir = glm::normalize(horiz_v);
+	}
+
+	// Spin-driven accelerations
+	const glm::vec3 up(0, 1, 0);
+	const glm::vec3 forward = last_dir;
+	const glm::vec3 right = glm::normalize(glm::cross(up, forward)); // right-handed
+
+	// +Y topspin (follow), -Y backspin (draw). +X right english, -X left.
+	const float a_long = params.spin_longitudinal_accel * spin.y;
+	const float a_side = params.spin_lateral_accel * spin.x;
+
+	velocity += forward * (a_long * dt);
+	velocity += right * (a_side * dt);
+
+	// If we are essentially stopped but still have strong backspin,
+	// give a small impulse to start the draw motion.
+	if (glm::length(horiz_v) < 0.02f && spin.y < -0.15f) {
+		const float draw_kick = params.draw_kick * (-spin.y);
+		velocity += -forward * draw_kick;
+	}
+
+	// Softer, frame-rate independent damping (per-second style)
+	velocity *= damping.linear;
+	spin *= damping.angular;
+
+	if (!IsInMotion())
+		velocity = glm::vec3(0.0f);
+}
+
+void BallBody::CollideWith(BallBody& other, const PhysicsParams& params)
+{
+	// Separation / basis
+	glm::vec3 n = position - other.position;
+	float n_len = glm::length(n);
+	if (n_len > radius * 2.0f) return;
+
+	glm::vec3 un = (n_len > 0.0f) ? (n / n_len) : glm::vec3(1, 0, 0);
+
+	// Separate so they don't overlap
+	glm::vec3 mtv = un * (radius * 2.0f - n_len);
+	position += 0.5f * mtv;
+	other.position -= 0.5f * mtv;
+
+	// Tangent along cloth
+	glm::vec3 ut = glm::vec3(-un.z, 0.0f, un.x);
+
+	// Decompose velocities (equal masses)
+	float v1n = glm::dot(un, velocity);
+	float v1t = glm::dot(ut, velocity);
+	float v2n = glm::dot(un, other.velocity);
+	float v2t = glm::dot(ut, other.velocity);
+
+	// Normal exchange with restitution
+	const float e = params.ball_restitution;     // 0.95 default
+	float v1n_after = e * v2n;
+	float v2n_after = e * v1n;
+
+	// Small tangential exchange (cloth slip at contact)
+	const float tf = 0.5f * params.table_friction; // e.g. 0.06 if table_friction=0.12
+	float dv_t = v1t - v2t;
+	float v1t_after = v1t - tf * dv_t;
+	float v2t_after = v2t + tf * dv_t;
+
+	// Recompose
+	velocity = un * v1n_after + ut * v1t_after;
+	other.velocity = un * v2n_after + ut * v2t_after;
+
+	// ---------- SPIN HANDLING ----------
+	// Keep MOST of cue's longitudinal spin (this is what gives draw/follow).
+	// Reduce a little due to impact losses; do NOT swap spins.
+	spin.y *= params.impact_spin_keep;  // slight loss only
+
+	// Transfer a bit of SIDE spin based on tangential slip at contact (feels natural).
+	float side_transfer = params.spin_transfer_coef * dv_t; // 0.4 * dv_t by default
+	spin.x -= side_transfer;
+	other.spin.x += side_transfer;
+
+	// Clamp to a sane range
+	spin = glm::clamp(spin, glm::vec2(-1.5f), glm::vec2(1.5f));
+	other.spin = glm::clamp(other.spin, glm::vec2(-1.5f), glm::vec2(1.5f));
+}
+
+void BallBody::BounceOffBound(const glm::vec3 surface_normal, const float bound_x, const float bound_z, const PhysicsParams& params)
+{
+	// Decompose velocity into normal/tangent
+	glm::vec3 n = glm::normalize(surface_normal);
+	float vn = glm::dot(velocity, n);
+	glm::vec3 vN = vn * n;
+	glm::vec3 vT = velocity - vN;
+
+	const float e = params.cushion_restitution; // normal restitution
+	const float mu = params.cushion_friction;    // tangential loss
+
+	// Bounce with restitution + friction
+	velocity = -e * vN + vT * (1.0f - mu);
+
+	// Clamp position back to the rail plane
+	if (std::abs(n.x) > Config::min_change)
+		position.x = -n.x * bound_x;
+	else if (std::abs(n.z) > Config::min_change)
+		position.z = -n.z * bound_z;
+
+	// Build right/forward to apply spin effects
+	const glm::vec3 up(0, 1, 0);
+	glm::vec3 fwd = glm::vec3(velocity.x, 0.0f, velocity.z);
+	if (glm::length(fwd) < Config::min_change) fwd = last_dir;
+	else                                       fwd = glm::normalize(fwd);
+	glm::vec3 right = glm::normalize(glm::cross(up, fwd));
+
+	// Keep old side spin for rail-throw direction
+	const float side_before = spin.x;
+
+	// Spin on rail: flip side, keep some top/back
+	spin.x = -spin.x * params.rail_side_flip;
+	spin.y *= params.rail_longitudinal_keep;
+
+	// Rail throw: a small sideways velocity from english
+	velocity += right * (params.rail_throw_impulse * side_before);
+}
+
+void BallBody::BounceOffHole(const glm::vec2 surface_normal, const float hole_radius, const PhysicsParams& params)
+{
+	// 2D normal (x,z), and rim tangent
+	glm::vec2 n2 = glm::normalize(surface_normal);
+	glm::vec2 t2 = glm::vec2(-n2.y, n2.x); // tangent around the rim
+
+	// Decompose horizontal velocity into normal/tangent
+	glm::vec2 v2(velocity.x, velocity.z);
+	float vn = glm::dot(v2, n2);
+	glm::vec2 vN = vn * n2;
+	glm::vec2 vT = v2 - vN;
+
+	const float e = params.cushion_restitution; // reuse cushion coeff for rim
+	const float mu = params.cushion_friction;
+
+	glm::vec2 v2p = -e * vN + vT * (1.0f - mu);
+	velocity.x = v2p.x;
+	velocity.z = v2p.y;
+
+	// Snap ball to rim, preserving height
+	const float keep_y = position.y;
+	glm::vec3 push_dir = glm::vec3(-n2.x, 0.0f, -n2.y); // away from rim center
+	position = hole + push_dir * (hole_radius - radius);
+	position.y = keep_y;
+
+	// Spin effects on rim: flip side, keep some top/back, and a small tangent throw
+	const float side_before = spin.x;
+
+	spin.x = -spin.x * params.rail_side_flip;
+	spin.y *= params.rail_longitudinal_keep;
+
+	glm::vec3 t3(t2.x, 0.0f, t2.y);
+	velocity += t3 * (params.rail_throw_impulse * side_before);
+}
+
+void BallBody::HandleGravity(const float min_position)
+{
+	if (position.y > min_position + radius + Config::min_change)
+		velocity.y -= 0.05f;
+	else
+		velocity.y = 0.0f;
+
+	position.y = glm::clamp(position.y, min_position + radius, radius);
+}
+
+void BallBody::TakeFromHole()
+{
+	in_hole = false;
+	velocity = glm::vec3(0.0f);
+	position = glm::vec3(0.0f, radius, 0.0f);
+	spin = glm::vec2(0.0f);
+}
+
+bool BallBody::IsInHole(const std::span<const glm::vec3> holes, const float hole_radius)
+{
+	for (const auto& h : holes)
+	{
+		if (glm::distance(position, h) < hole_radius)
+		{
+			hole = h;
+			in_hole = true;
+		}
+	}
+
+	return in_hole;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "../headless.h"
+#include "PhysicsParams.hpp"
+
+#include <span>
+
+// Velocity and spin multipliers for one tick of 'dt', computed once per tick length
+// instead of per ball per tick. std::pow is not guaranteed to round alike on every
+// CPU (the CRT picks FMA code paths at runtime), so lockstep peers use the host's.
+struct TickDamping
+{
+	float dt = 0.0f;
+	float linear = 1.0f;
+	float angular = 1.0f;
+
+	static TickDamping For(const float dt, const PhysicsParams& params)
+	{
+		return { dt, std::pow(params.linear_damping, dt * 60.0f), std::pow(params.angular_damping, dt * 60.0f) };
+	}
+};
+
+// Physical state of one ball: no mesh, texture or GL, so a table of them fits in
+// a few hundred bytes (objects/Ball is the drawn counterpart that follows one).
+struct BallBody
+{
+	inline static constexpr float radius{ 0.0286f };
+
+	int number = 0;
+	glm::vec3 position{ 0.0f, radius, 0.0f };
+	glm::vec3 velocity{ 0.0f };
+	glm::vec2 spin{ 0.0f };                  // x: english (+ right), y: follow (+) / draw (-)
+	glm::vec3 last_dir{ 1.0f, 0.0f, 0.0f };  // last horizontal direction of travel (used when speed ~ 0 for draw)
+	glm::vec3 hole{};
+	bool in_hole = false;
+	bool drawn = true;                       // false once pocketed and taken off the table
+
+	void Shot(glm::vec3 power, glm::vec2 shot_spin);
+	void Roll(float dt, const TickDamping& damping, const PhysicsParams& params);
+	void CollideWith(BallBody& other, const PhysicsParams& params);
+	void BounceOffBound(glm::vec3 surface_normal, float bound_x, float bound_z, const PhysicsParams& params);
+	void BounceOffHole(glm::vec2 surface_normal, float hole_radius, const PhysicsParams& params);
+	void HandleGravity(float min_position);
+	void TakeFromHole();
+
+	[[nodiscard]] bool IsInHole(std::span<const glm::vec3> holes, float hole_radius);
+	[[nodiscard]] bool IsInMotion() const { return glm::length(velocity) > 0.003f; }
+};
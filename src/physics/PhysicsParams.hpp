@@ -0,0 +1,34 @@
+#pragma once
+#include "../headless.h"
+
+// Constants of the ball model, carried by each table instead of read from Config,
+// so tools can run thousands of tables side by side with different values. A
+// default-constructed set is the game's tuning in Config at that moment (the quick
+// setup menu edits it on the render thread, so the game builds one only there and
+// posts it to the simulation). Trivially copyable and compared field by field.
+struct PhysicsParams
+{
+	// Rolling: per-second factors (see TickDamping)
+	float linear_damping = Config::linear_damping;
+	float angular_damping = Config::angular_damping;
+
+	// Spin -> linear coupling while rolling
+	float spin_longitudinal_accel = Config::spin_longitudinal_accel;
+	float spin_lateral_accel = Config::spin_lateral_accel;
+	float draw_kick = Config::draw_kick;                   // per unit of backspin once the ball has all but stopped
+
+	// Ball-ball impacts
+	float ball_restitution = Config::ball_restitution;
+	float table_friction = Config::table_friction;         // tangential exchange at the contact
+	float spin_transfer_coef = Config::spin_transfer_coef;
+	float impact_spin_keep = Config::impact_spin_keep;     // follow/draw kept through an impact
+
+	// Cushions and pocket rims
+	float cushion_restitution = Config::cushion_restitution;
+	float cushion_friction = Config::cushion_friction;
+	float rail_longitudinal_keep = Config::rail_longitudinal_keep;
+	float rail_side_flip = Config::rail_side_flip;
+	float rail_throw_impulse = Config::rail_throw_impulse;
+
+	bool operator== (const PhysicsParams&) const = default;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include "../headless.h"
+
+#include <bit>
+
+// Which balls are still on the table, one bit per ball *number* (not slot), kept
+// by TableSimulation as balls are pocketed. Rules and aiming queries (group
+// cleared, legal first contact, balls left) become a mask and a compare.
+struct RackMask
+{
+	static constexpr uint16_t cue = 1u << 0;
+	static constexpr uint16_t eight = 1u << 8;
+	static constexpr uint16_t solids = 0x00FE;    // 1..7
+	static constexpr uint16_t stripes = 0xFE00;   // 9..15
+	static constexpr uint16_t all = 0xFFFF;
+
+	uint16_t on_table = all;
+
+	static constexpr uint16_t Bit(const int number) { return static_cast<uint16_t>(1u << number); }
+
+	// 0 = solids, 1 = stripes, -1 = neither (cue, eight)
+	static constexpr int GroupOf(const int number)
+	{
+		return (solids & Bit(number)) ? 0 : (stripes & Bit(number)) ? 1 : -1;
+	}
+
+	static constexpr uint16_t GroupMask(const int group)
+	{
+		return group == 0 ? solids : group == 1 ? stripes : uint16_t{ 0 };
+	}
+
+	void Pocket(const int number) { on_table &= static_cast<uint16_t>(~Bit(number)); }
+	void Return(const int number) { on_table |= Bit(number); }
+
+	[[nodiscard]] bool IsOnTable(const int number) const { return (on_table & Bit(number)) != 0; }
+	[[nodiscard]] uint16_t Remaining(const int group) const { return static_cast<uint16_t>(on_table & GroupMask(group)); }
+	[[nodiscard]] int RemainingCount(const int group) const { return std::popcount(Remaining(group)); }
+	// Unassigned (-1) never counts as cleared
+	[[nodiscard]] bool IsGroupCleared(const int group) const { return group != -1 && Remaining(group) == 0; }
+};
+
+static_assert(RackMask::GroupOf(1) == 0 && RackMask::GroupOf(15) == 1 && RackMask::GroupOf(8) == -1 && RackMask::GroupOf(0) == -1);
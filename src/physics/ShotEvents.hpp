@@ -0,0 +1,53 @@
+#pragma once
+#include "../headless.h"
+
+#include <span>
+
+// What happened on the table during one shot, in the order the physics saw it.
+// TableSimulation writes these while a shot plays out; the rules read them once
+// when it settles, and statistics or sound can read the same list afterwards.
+struct ShotEvent
+{
+	enum class Type : uint8_t
+	{
+		BallContact,   // two balls start touching
+		Cushion,       // a ball reaches a cushion (not a pocket's rim)
+		Pocket,        // a ball drops into a pocket
+		AtRest,        // a ball stops
+	};
+
+	Type type = Type::AtRest;
+	uint8_t slot = 0;       // the ball (BallContact: the lower slot, so the cue ball is always here)
+	uint8_t other = 0;      // BallContact: the other ball's slot
+	uint32_t tick = 0;      // ticks since the shot started
+	float speed = 0.0f;     // BallContact: closing speed along the centres; Cushion: speed into it
+};
+
+// Fixed-capacity event list for one shot: no allocation while the table runs.
+// A shot that overflows it loses contact, cushion and rest events, never
+// pockets: the last slots are held back for those, one per ball.
+class ShotEventLog
+{
+public:
+	static constexpr size_t capacity = 256;
+	static constexpr size_t reserved_for_pockets = 16;
+
+	void Clear() { count_ = 0; dropped_ = 0; }
+
+	void Push(const ShotEvent& event)
+	{
+		const size_t limit = event.type == ShotEvent::Type::Pocket ? capacity : capacity - reserved_for_pockets;
+		if (count_ < limit)
+			events_[count_++] = event;
+		else
+			++dropped_;
+	}
+
+	[[nodiscard]] std::span<const ShotEvent> Events() const { return { events_.data(), count_ }; }
+	[[nodiscard]] size_t Dropped() const { return dropped_; }
+
+private:
+	std::array<ShotEvent, capacity> events_{};
+	size_t count_ = 0;
+	size_t dropped_ = 0;
+};
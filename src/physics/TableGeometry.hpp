@@ -0,0 +1,24 @@
+#pragma once
+#include "../headless.h"
+#include "BallBody.hpp"
+
+// Playing surface in world units (table top at y = 0): cushion planes for ball
+// centres and the six pocket centres. objects/Table draws the matching model.
+struct TableGeometry final
+{
+	TableGeometry() = delete;
+
+	inline static constexpr float hole_radius{ 0.07f };
+	inline static constexpr float hole_bottom{ -0.14324f };
+	inline static constexpr float bound_x{ 1.35f - BallBody::radius - 0.042f };
+	inline static constexpr float bound_z{ 0.7f - BallBody::radius - 0.042f };
+
+	inline static constexpr std::array<glm::vec3, 6> holes = {
+		glm::vec3(1.35f - BallBody::radius, 0.0f, 0.7f - BallBody::radius),
+		glm::vec3(1.35f - BallBody::radius, 0.0f, -0.7f + BallBody::radius),
+		glm::vec3(0.0f, 0.0f, -0.7f - BallBody::radius),
+		glm::vec3(-1.35f + BallBody::radius, 0.0f, -0.7f + BallBody::radius),
+		glm::vec3(-1.35f + BallBody::radius, 0.0f, 0.7f - BallBody::radius),
+		glm::vec3(0.0f, 0.0f, 0.7f + BallBody::radius),
+	};
+};
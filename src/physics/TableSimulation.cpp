@@ -0,0 +1,493 @@
+#include "../headless.h"
+#include "TableSimulation.hpp"
+
+TableSimulation::TableSimulation(const uint32_t seed, const PhysicsParams& params) :
+	params_(params)
+{
+	std::array<int, ball_count> numbers{};
+	for (int n = 0; n < ball_count; ++n)
+		numbers[n] = n;
+
+	// mixing balls
+	std::swap(numbers[5], numbers[8]);
+	std::swap(numbers[5], numbers[15]);
+
+	std::mt19937 rng(seed);
+	std::shuffle(numbers.begin() + 1, numbers.end() - 1, rng);
+
+	std::swap(numbers[5], numbers[15]);
+
+	for (int slot = 0; slot < ball_count; ++slot)
+		balls_[slot].number = numbers[slot];
+
+	Rack();
+}
+
+void TableSimulation::Rack()
+{
+	for (auto& ball : balls_) {
+		ball.TakeFromHole();
+		ball.drawn = true;
+	}
+	rack_ = RackMask{};
+	on_cushion_ = 0;
+	moving_ = 0;
+
+	balls_[0].position = glm::vec3(0.8f, BallBody::radius, 0.0f);
+	balls_[1].position = glm::vec3(-0.8f + 2.0f * glm::root_three<float>() * BallBody::radius, BallBody::radius, 0.0f);
+
+	glm::vec3 temp = balls_[1].position;
+	int index = 2;
+	for (int i = 0; i < 4; ++i) {
+		temp.x -= glm::root_three<float>() * BallBody::radius;
+		temp.z -= BallBody::radius;
+		for (int j = 0; j < i + 2; ++j) {
+			balls_[index].position = glm::vec3(temp.x, BallBody::radius, temp.z + j * (BallBody::radius * 2.0f));
+			++index;
+		}
+	}
+
+	// The triangle is frozen together: the break does not start those contacts
+	touching_.fill(0);
+	for (int i = 1; i < ball_count; ++i)
+		for (int j = i + 1; j < ball_count; ++j) {
+			const glm::vec3 n = balls_[i].position - balls_[j].position;
+			if (glm::dot(n, n) <= contact_distance * contact_distance)
+				touching_[i] |= static_cast<uint16_t>(1u << j);
+		}
+}
+
+void TableSimulation::Step(const float dt)
+{
+	// Start of shot happens exactly when we first see movement
+	// and we are NOT already in a shot (i.e., rules aren't pending yet).
+	if (AreBallsInMotion() && !state_.CheckRulesPending()) {
+		state_.SetCheckRulesPending(true);  // we are now "in a shot"
+		events_.Clear();
+		shot_tick_ = 0;
+
+		// Contacts already under way count again for the new shot (a cue ball
+		// frozen to a ball, a ball frozen to a cushion)
+		touching_[0] = 0;
+		on_cushion_ = 0;
+	}
+
+	if (damping_.dt != dt)
+		damping_ = TickDamping::For(dt, params_);
+
+	for (int i = 0; i < ball_count; ++i) {
+		BallBody& ball = balls_[i];
+		ball.Roll(dt, damping_, params_);
+
+		const bool was_in_hole = ball.in_hole;
+		if (ball.IsInHole(TableGeometry::holes, TableGeometry::hole_radius))
+			HandleHolesFall(i);
+		else
+			HandleBoundsCollision(i);
+
+		// A cushion bounce can also carry the ball over a pocket
+		if (!ball.IsInHole(TableGeometry::holes, TableGeometry::hole_radius))
+			ball.position.y = BallBody::radius;
+		else if (!was_in_hole)
+			Emit(ShotEvent::Type::Pocket, i);
+
+		HandleBallsCollision(i);
+	}
+
+	uint16_t moving = 0;
+	for (int i = 0; i < ball_count; ++i)
+		if (balls_[i].IsInMotion())
+			moving |= static_cast<uint16_t>(1u << i);
+	for (int i = 0; i < ball_count; ++i)
+		if (moving_ & ~moving & (1u << i))
+			Emit(ShotEvent::Type::AtRest, i);
+	moving_ = moving;
+	++shot_tick_;
+
+	if (moving != 0)
+		return;
+
+	// Everything stopped: pocketed balls leave the table
+	for (int i = 0; i < ball_count; ++i) {
+		BallBody& ball = balls_[i];
+		if (!ball.in_hole || !ball.drawn)
+			continue;
+		ball.drawn = false;
+		rack_.Pocket(ball.number);
+		if (i == 0) {
+			state_.SetBallInHand(true);
+			state_.SetMessage("Foul! Scratch — ball in hand.", 1.2f);
+		}
+	}
+
+	if (state_.CheckRulesPending()) {
+		// One pass over what happened during the shot
+		last_foul_ = rules_.EvaluateEndOfShot(balls_, rack_, events_.Events(), state_);
+		state_.SetCheckRulesPending(false);  // shot closed
+
+		// Settled balls keep no spin: what is left would go on decaying for however
+		// many idle ticks pass before the next shot, and so depend on timing
+		for (auto& ball : balls_)
+			ball.spin = glm::vec2(0.0f);
+	}
+}
+
+int TableSimulation::ResolveShot(const float dt, const int max_ticks)
+{
+	int ticks = 0;
+	while ((AreBallsInMotion() || state_.CheckRulesPending()) && ticks < max_ticks) {
+		Step(dt);
+		++ticks;
+	}
+
+	if (state_.CheckRulesPending() || AreBallsInMotion()) {
+		for (auto& ball : balls_)
+			ball.velocity = glm::vec3(0.0f);
+		Step(dt);
+		++ticks;
+	}
+	return ticks;
+}
+
+bool TableSimulation::Shoot(const glm::vec3 aim, const float speed, const glm::vec2 spin)
+{
+	const glm::vec3 flat(aim.x, 0.0f, aim.z);
+	if (!std::isfinite(aim.x) || !std::isfinite(aim.z) || !std::isfinite(speed) || !std::isfinite(spin.x) || !std::isfinite(spin.y))
+		return false;
+	if (state_.IsGameOver() || state_.BallInHand() || AreBallsInMotion() || glm::length(flat) < Config::min_change)
+		return false;
+
+	balls_[0].Shot(glm::normalize(flat) * glm::clamp(speed, 0.0f, MaxShotSpeed()), glm::clamp(spin, glm::vec2(-1.0f), glm::vec2(1.0f)));
+	return true;
+}
+
+void TableSimulation::SetParams(const PhysicsParams& params)
+{
+	if (params == params_)
+		return;
+	params_ = params;
+	damping_ = TickDamping{};
+}
+
+bool TableSimulation::TickShotClock(const float dt)
+{
+	if (!state_.TickShotClock(dt))
+		return false;
+	ExpireShotClock();
+	return true;
+}
+
+void TableSimulation::ExpireShotClock()
+{
+	state_.SetShotClock(0.0f);
+	state_.SetMessage("Foul! Shot clock expired.", 1.2f);
+	state_.SetBallInHand(true);
+	state_.SwitchTurn(balls_[0].drawn);
+}
+
+bool TableSimulation::PlaceCueBall(const glm::vec3& desired)
+{
+	if (!std::isfinite(desired.x) || !std::isfinite(desired.z))
+		return false;
+
+	BallBody& cue_ball = balls_[0];
+	cue_ball.TakeFromHole();
+	cue_ball.drawn = true;
+	rack_.Return(0);
+	cue_ball.position = ClampCueBallPosition(glm::vec3(desired.x, BallBody::radius, desired.z));
+
+	for (int i = 1; i < ball_count; ++i) if (balls_[i].drawn) {
+		if (glm::distance(cue_ball.position, balls_[i].position) < 2.0f * BallBody::radius) {
+			state_.SetBallInHand(false);
+			state_.SetMessage("Foul! Illegal contact during ball-in-hand.", 1.2f);
+			state_.SwitchTurn(cue_ball.drawn);
+			state_.SetBallInHand(true);
+			return false;
+		}
+	}
+
+	HandleBoundsCollision(0);
+	cue_ball.position.y = BallBody::radius;
+	return true;
+}
+
+void TableSimulation::ConfirmCueBall()
+{
+	state_.SetBallInHand(false);
+	state_.ResetShotClock();
+}
+
+static_assert(std::is_trivially_copyable_v<TableSimulation::Snapshot>, "snapshots are copied and written as bytes");
+
+void TableSimulation::Save(Snapshot& out) const
+{
+	out.balls = balls_;
+	out.touching = touching_;
+	out.on_cushion = on_cushion_;
+	out.moving = moving_;
+	out.shot_tick = shot_tick_;
+	out.damping = damping_;
+	state_.Save(out.state);
+}
+
+void TableSimulation::Restore(const Snapshot& in)
+{
+	balls_ = in.balls;
+	touching_ = in.touching;
+	on_cushion_ = in.on_cushion;
+	moving_ = in.moving;
+	shot_tick_ = in.shot_tick;
+	damping_ = in.damping;
+	events_.Clear();
+	last_foul_ = GameRules::Foul::None;
+	state_.Restore(in.state);
+
+	rack_.on_table = 0;
+	for (const BallBody& ball : balls_)
+		if (ball.drawn)
+			rack_.Return(ball.number);
+}
+
+uint64_t TableSimulation::StateHash() const
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	auto mix = [&hash](const auto& value) {
+		const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+		for (size_t i = 0; i < sizeof(value); ++i)
+			hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+	};
+
+	// Field by field: padding bytes are not state
+	for (const BallBody& ball : balls_) {
+		mix(ball.number);
+		mix(ball.position);
+		mix(ball.velocity);
+		mix(ball.spin);
+		mix(ball.last_dir);
+		mix(ball.hole);
+		mix(ball.in_hole);
+		mix(ball.drawn);
+	}
+
+	mix(state_.CurrentPlayerIndex());
+	mix(state_.IsGameOver());
+	mix(state_.Winner());
+	mix(state_.IsFirstShot());
+	mix(state_.IsAfterBreak());
+	mix(state_.BallInHand());
+	for (int player = 0; player < 2; ++player) {
+		mix(state_.GroupOfPlayer(player));
+		mix(state_.Players()[player].GetScore());
+	}
+	return hash;
+}
+
+bool TableSimulation::AreBallsInMotion() const {
+	for (const auto& b : balls_) if (b.IsInMotion()) return true; return false;
+}
+
+bool TableSimulation::IsLegalAimTarget(const int slot) const
+{
+	// Defensive: out of range or not actually on table => don't warn
+	if (slot <= 0 || slot >= ball_count) return true;
+	const int num = balls_[slot].number;
+	if (!rack_.IsOnTable(num)) return true;
+
+	return (LegalTargets() & RackMask::Bit(num)) != 0;
+}
+
+uint16_t TableSimulation::LegalTargets() const
+{
+	const auto object_balls = static_cast<uint16_t>(rack_.on_table & ~RackMask::cue);
+	const int curGroup = state_.CurrentPlayerGroup(); // -1 when not assigned yet
+
+	// On the break: any first contact is allowed (color = yellow)
+	if (state_.IsAfterBreak()) return object_balls;
+
+	// Open table (post-break before assignment): everything but the 8 is allowed
+	if (state_.IsFirstShot()) return static_cast<uint16_t>(object_balls & ~RackMask::eight);
+
+	// Defensive: groups should be assigned if tableOpen==false, but guard anyway
+	if (curGroup == -1) return object_balls;
+
+	// The 8 only once your group is completely cleared, and then nothing else is left
+	if (rack_.IsGroupCleared(curGroup)) return static_cast<uint16_t>(rack_.on_table & RackMask::eight);
+	return rack_.Remaining(curGroup);
+}
+
+void TableSimulation::Emit(const ShotEvent::Type type, const int slot, const int other, const float speed)
+{
+	events_.Push({ type, static_cast<uint8_t>(slot), static_cast<uint8_t>(other), shot_tick_, speed });
+}
+
+void TableSimulation::HandleBallsCollision(const int slot)
+{
+	BallBody& a = balls_[slot];
+	for (int j = slot + 1; j < ball_count; ++j) {
+		BallBody& b = balls_[j];
+		const auto bit = static_cast<uint16_t>(1u << j);
+
+		// Apart, the pair has nothing to do (CollideWith would return at once)
+		const glm::vec3 n = a.position - b.position;
+		if (glm::dot(n, n) > contact_distance * contact_distance) {
+			touching_[slot] &= static_cast<uint16_t>(~bit);
+			continue;
+		}
+
+		// Balls in a pocket are below the cloth: piled up they would keep nudging
+		// each other and the shot would never settle
+		if (a.in_hole && b.in_hole)
+			continue;
+
+		if (!(touching_[slot] & bit)) {
+			// Closing speed along the line of centres, before the impulse
+			const float distance = glm::length(n);
+			const float closing = distance > 0.0f ? glm::dot(b.velocity - a.velocity, n / distance) : 0.0f;
+			Emit(ShotEvent::Type::BallContact, slot, j, closing);
+			touching_[slot] |= bit;
+		}
+
+		a.CollideWith(b, params_);
+	}
+}
+
+void TableSimulation::HandleHolesFall(const int slot)
+{
+	// Once the table is at rest, balls piled in a pocket stay as they are (they would
+	// otherwise keep nudging each other); they leave the table at the end of the tick
+	if (!AreBallsInMotion())
+		return;
+
+	// still moving → keep the sink physics
+	BallBody& ball = balls_[slot];
+	ball.HandleGravity(TableGeometry::hole_bottom);
+
+	const auto p2 = glm::vec2(ball.position.x, ball.position.z);
+	const auto h2 = glm::vec2(ball.hole.x, ball.hole.z);
+
+	const glm::vec2 dir = glm::normalize(p2 - h2);
+	const float distance = glm::distance(p2, h2);
+
+	if (distance > TableGeometry::hole_radius - BallBody::radius)
+		ball.BounceOffHole(-dir, TableGeometry::hole_radius, params_);
+}
+
+void TableSimulation::HandleBoundsCollision(const int slot)
+{
+	BallBody& ball = balls_[slot];
+	const auto ball_pos = ball.position;
+	constexpr auto hole_edge_z = 0.7f - TableGeometry::hole_radius - BallBody::radius;
+	constexpr auto hole_edge_x = 1.35f - TableGeometry::hole_radius - BallBody::radius;
+	constexpr auto bound_x = TableGeometry::bound_x;
+	constexpr auto bound_z = TableGeometry::bound_z;
+	constexpr auto hole_radius = TableGeometry::hole_radius;
+	// Pocket mouths run past the cushion lines; a ball that misses the drop meets the rail behind
+	constexpr auto rail_x = 1.35f - BallBody::radius;
+	constexpr auto rail_z = 0.7f;
+
+	glm::vec3 normal(0.0f);
+	float plane_x = bound_x;
+	float plane_z = bound_z;
+
+	// X-bounds
+	if (ball_pos.x >= bound_x && ball_pos.z < hole_edge_z && ball_pos.z > -hole_edge_z)
+		normal = glm::vec3(-1.0f, 0.0f, 0.0f);
+	else if (ball_pos.x <= -bound_x && ball_pos.z < hole_edge_z && ball_pos.z > -hole_edge_z)
+		normal = glm::vec3(1.0f, 0.0f, 0.0f);
+	// Z-bounds
+	else if (ball_pos.z >= bound_z &&
+		((ball_pos.x < hole_edge_x && ball_pos.x > hole_radius) ||
+			(ball_pos.x > -hole_edge_x && ball_pos.x < -hole_radius)))
+		normal = glm::vec3(0.0f, 0.0f, -1.0f);
+	else if (ball_pos.z <= -bound_z &&
+		((ball_pos.x < hole_edge_x && ball_pos.x > hole_radius) ||
+			(ball_pos.x > -hole_edge_x && ball_pos.x < -hole_radius)))
+		normal = glm::vec3(0.0f, 0.0f, 1.0f);
+	else if (std::abs(ball_pos.x) >= rail_x) {
+		normal = glm::vec3(ball_pos.x > 0.0f ? -1.0f : 1.0f, 0.0f, 0.0f);
+		plane_x = rail_x;
+	}
+	else if (std::abs(ball_pos.z) >= rail_z) {
+		normal = glm::vec3(0.0f, 0.0f, ball_pos.z > 0.0f ? -1.0f : 1.0f);
+		plane_z = rail_z;
+	}
+
+	const auto bit = static_cast<uint16_t>(1u << slot);
+	if (normal == glm::vec3(0.0f)) {
+		on_cushion_ &= static_cast<uint16_t>(~bit);
+		return;
+	}
+
+	// A ball resting against the cushion bounces every tick: one event until it leaves
+	if (!(on_cushion_ & bit))
+		Emit(ShotEvent::Type::Cushion, slot, 0, -glm::dot(ball.velocity, normal));
+	on_cushion_ |= bit;
+
+	ball.BounceOffBound(normal, plane_x, plane_z, params_);
+}
+
+/**
+ * If user tries to put ball into hole radius, push it out
+ */
+glm::vec3 TableSimulation::ClampCueBallPosition(const glm::vec3& desired) const
+{
+	glm::vec3 pos = desired;
+	constexpr auto bound_x = TableGeometry::bound_x;
+	constexpr auto bound_z = TableGeometry::bound_z;
+	constexpr auto hole_radius = TableGeometry::hole_radius;
+
+	// 1) Check corners/pockets
+	const float hole_edge_x = (bound_x - hole_radius - BallBody::radius);
+	const float hole_edge_z = (bound_z - hole_radius - BallBody::radius);
+
+	// Right cushion region
+	if (pos.x >= bound_x &&
+		(pos.z < hole_edge_z && pos.z > -hole_edge_z))
+	{
+		pos.x = bound_x;
+	}
+	else if (pos.x <= -bound_x &&
+		(pos.z < hole_edge_z && pos.z > -hole_edge_z))
+	{
+		pos.x = -bound_x;
+	}
+	else if (pos.z >= bound_z &&
+		((pos.x < hole_edge_x && pos.x > hole_radius) ||
+			(pos.x > -hole_edge_x && pos.x < -hole_radius)))
+	{
+		pos.z = bound_z;
+	}
+	else if (pos.z <= -bound_z &&
+		((pos.x < hole_edge_x && pos.x > hole_radius) ||
+			(pos.x > -hole_edge_x && pos.x < -hole_radius)))
+	{
+		pos.z = -bound_z;
+	}
+	else
+	{
+		// simple clamp if not in corner range
+		pos.x = glm::clamp(pos.x, -bound_x, bound_x);
+		pos.z = glm::clamp(pos.z, -bound_z, bound_z);
+	}
+
+	// 2) Additionally, block holes. If distance < hole_radius + ball radius, push it out
+	for (const auto& hCenter : TableGeometry::holes)
+	{
+		glm::vec2 p2d(pos.x, pos.z);
+		glm::vec2 h2d(hCenter.x, hCenter.z);
+
+		float dist = glm::distance(p2d, h2d);
+		float minDist = hole_radius + BallBody::radius;
+
+		if (dist < minDist)
+		{
+			// push pos out along direction from hole -> pos
+			glm::vec2 dir2d = glm::normalize(p2d - h2d);
+			glm::vec2 new2d = h2d + dir2d * minDist;
+			pos.x = new2d.x;
+			pos.z = new2d.y;
+		}
+	}
+
+	return pos;
+}
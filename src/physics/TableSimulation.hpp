@@ -0,0 +1,134 @@
+#pragma once
+#include "../headless.h"
+#include "BallBody.hpp"
+#include "TableGeometry.hpp"
+#include "RackMask.hpp"
+#include "ShotEvents.hpp"
+#include "../gameplay/GameState.hpp"
+#include "../gameplay/GameRules.hpp"
+
+// One table's balls, game state and rules, without meshes, textures or GL: what
+// World runs on the simulation thread, and what the headless table server hosts
+// by the thousand. Slots are rack positions; a slot's ball number is fixed by the
+// shuffle (GameState contact indices refer to slots, like before).
+class TableSimulation
+{
+public:
+	static constexpr int ball_count = 16;
+
+	// Rack order shuffled from 'seed' (the 8 always lands in the middle of the triangle)
+	explicit TableSimulation(uint32_t seed, const PhysicsParams& params = {});
+
+	// All balls back on the table in the break formation; game state is left alone
+	void Rack();
+
+	// One fixed physics tick: rolling, pockets, cushions, ball contacts, then the
+	// rules once every ball has settled after a shot
+	void Step(float dt);
+
+	// Steps until the shot in progress is over and adjudicated. After 'max_ticks'
+	// the balls are stopped where they are so the rules still run. Returns the ticks taken
+	int ResolveShot(float dt, int max_ticks);
+
+	// Strikes the cue ball: 'aim' is horizontal, speed is clamped to what the cue can give.
+	// False (and nothing happens) while balls roll, the cue ball is in hand, the game is over
+	// or any number is not finite
+	bool Shoot(glm::vec3 aim, float speed, glm::vec2 spin);
+
+	// Counts the shot clock down; true when it ran out this tick (see ExpireShotClock)
+	bool TickShotClock(float dt);
+	// Shot clock foul: ball in hand for the opponent
+	void ExpireShotClock();
+
+	// Ball in hand: clamps 'desired' off the cushions and pockets and puts the cue ball
+	// there. Touching another ball is a foul (turn passes, still ball in hand) -> false.
+	// A spot that is not finite is refused (false) and nothing changes
+	bool PlaceCueBall(const glm::vec3& desired);
+	// Ends ball in hand at the current spot
+	void ConfirmCueBall();
+
+	// Complete table and game state as one trivially copyable block of about 1.2 KB,
+	// for undo, search and autosave. Saving and restoring are plain copies. The event
+	// list is not part of it: snapshots are taken at rest, and restoring clears it
+	struct Snapshot
+	{
+		std::array<BallBody, ball_count> balls;
+		std::array<uint16_t, ball_count> touching;
+		uint16_t on_cushion;
+		uint16_t moving;
+		uint32_t shot_tick;
+		TickDamping damping;
+		GameState::Snapshot state;
+	};
+
+	void Save(Snapshot& out) const;
+	[[nodiscard]] Snapshot Save() const { Snapshot out; Save(out); return out; }
+	// The HUD message is left as it is
+	void Restore(const Snapshot& in);
+
+	// Damping factors for ticks of 'damping.dt' from now on, instead of computing them
+	void ShareDamping(const TickDamping& damping) { damping_ = damping; }
+	[[nodiscard]] const TickDamping& Damping() const { return damping_; }
+
+	// This table's ball model. Not part of snapshots: whoever owns the table sets it.
+	// A change recomputes the damping factors at the next tick (after ShareDamping too)
+	void SetParams(const PhysicsParams& params);
+	[[nodiscard]] const PhysicsParams& Params() const { return params_; }
+
+	// FNV-1a over the exact bits of everything a shot can change (balls, turn, groups,
+	// scores, flags): two tables that hash alike will play every later shot alike
+	[[nodiscard]] uint64_t StateHash() const;
+
+	[[nodiscard]] bool AreBallsInMotion() const;
+	// True if the current player is allowed to *first-contact* the ball in slot 'slot'
+	[[nodiscard]] bool IsLegalAimTarget(int slot) const;
+	// The same for every ball at once: RackMask bits (by number) of the legal first contacts
+	[[nodiscard]] uint16_t LegalTargets() const;
+
+	// What happened during the current shot, in order; complete once it has settled,
+	// and kept until the next shot starts
+	[[nodiscard]] std::span<const ShotEvent> Events() const { return events_.Events(); }
+	// Events this shot lost to a full log (never pockets)
+	[[nodiscard]] size_t DroppedEvents() const { return events_.Dropped(); }
+	// The rules' verdict on the last shot that settled
+	[[nodiscard]] GameRules::Foul LastFoul() const { return last_foul_; }
+
+	// Balls still on the table, by number
+	[[nodiscard]] const RackMask& OnTable() const { return rack_; }
+
+	[[nodiscard]] const std::array<BallBody, ball_count>& Balls() const { return balls_; }
+	[[nodiscard]] BallBody& CueBall() { return balls_[0]; }
+	[[nodiscard]] const BallBody& CueBall() const { return balls_[0]; }
+
+	GameState& State() { return state_; }
+	[[nodiscard]] const GameState& State() const { return state_; }
+
+	// Highest speed a shot can have (full pull-back of the cue at the default strike force;
+	// the game's cue strikes with the menu's strike force, see SimulationInput)
+	[[nodiscard]] static constexpr float MaxShotSpeed() { return 0.5f * Config::default_power_coeff; }
+
+private:
+	// Centres this close count as touching: a hair over two radii, so a thin cut still registers
+	static constexpr float contact_distance = 2.0f * BallBody::radius + 1e-4f;
+
+	void Emit(ShotEvent::Type type, int slot, int other = 0, float speed = 0.0f);
+	void HandleBallsCollision(int slot);
+	void HandleHolesFall(int slot);
+	void HandleBoundsCollision(int slot);
+	[[nodiscard]] glm::vec3 ClampCueBallPosition(const glm::vec3& desired) const;
+
+	std::array<BallBody, ball_count> balls_{};
+	RackMask rack_{};                            // follows BallBody::drawn
+	PhysicsParams params_{};
+	TickDamping damping_{};
+
+	ShotEventLog events_{};
+	uint32_t shot_tick_ = 0;
+	std::array<uint16_t, ball_count> touching_{};  // per slot: bits of the higher slots it touches
+	uint16_t on_cushion_ = 0;                     // bit per slot: against a cushion
+	uint16_t moving_ = 0;                         // bit per slot: in motion at the end of the last tick
+	GameRules::Foul last_foul_ = GameRules::Foul::None;
+
+	GameState state_{};
+	GameRules rules_{};
+};
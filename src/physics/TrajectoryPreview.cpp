@@ -0,0 +1,143 @@
+#include "../headless.h"
+#include "TrajectoryPreview.hpp"
+
+namespace
+{
+	// Paths lie on the cloth, also where a ball ends in a pocket
+	glm::vec3 OnCloth(const BallBody& ball)
+	{
+		return glm::vec3(ball.position.x, BallBody::radius, ball.position.z);
+	}
+}
+
+void PredictedPaths::Clear()
+{
+	cue.clear();
+	object.clear();
+	object_slot = -1;
+	contact = glm::vec3(0.0f);
+	complete = false;
+}
+
+void TrajectoryPreview::Aim(const TableSimulation& table, const glm::vec3& velocity, const glm::vec2& spin)
+{
+	const uint64_t table_hash = table.StateHash();
+	if (aimed_ && table_hash == table_hash_ && velocity == velocity_ && spin == spin_ && table.Params() == params_)
+		return;
+
+	aimed_ = true;
+	table_hash_ = table_hash;
+	params_ = table.Params();
+	velocity_ = velocity;
+	spin_ = spin;
+
+	table_.Restore(table.Save());
+	table_.SetParams(params_);
+	table_.ShareDamping(table.Damping());
+	table_.CueBall().Shot(velocity, spin);
+
+	ticks_ = 0;
+	events_seen_ = 0;
+	cue_ = Track{ .slot = 0 };
+	object_ = Track{};
+	paths_.Clear();
+	paths_.cue.push_back(OnCloth(table_.CueBall()));
+}
+
+void TrajectoryPreview::Advance(const float dt, const int tick_budget, const int bounces)
+{
+	if (!aimed_ || paths_.complete)
+		return;
+
+	const int max_ticks = static_cast<int>(Config::trajectory_max_seconds * static_cast<float>(Config::simulation_rate));
+	for (int tick = 0; tick < tick_budget && !paths_.complete; ++tick)
+	{
+		table_.Step(dt);
+		++ticks_;
+
+		const std::span<const ShotEvent> events = table_.Events();
+		for (; events_seen_ < events.size(); ++events_seen_)
+			Follow(events[events_seen_], bounces);
+
+		if (ticks_ % Config::trajectory_sample_ticks == 0)
+		{
+			Sample(cue_, paths_.cue);
+			Sample(object_, paths_.object);
+		}
+
+		if (!table_.AreBallsInMotion() || ticks_ >= max_ticks)
+		{
+			End(cue_, paths_.cue);
+			End(object_, paths_.object);
+		}
+		paths_.complete = cue_.done && (object_.slot < 0 || object_.done);
+	}
+}
+
+void TrajectoryPreview::Reset()
+{
+	aimed_ = false;
+	paths_.Clear();
+}
+
+void TrajectoryPreview::Follow(const ShotEvent& event, const int bounces)
+{
+	switch (event.type)
+	{
+	case ShotEvent::Type::BallContact:
+		// The cue ball is always 'slot' when it is part of a contact
+		if (event.slot == cue_.slot && object_.slot < 0 && !cue_.done)
+		{
+			object_.slot = event.other;
+			paths_.object_slot = event.other;
+			paths_.contact = OnCloth(table_.CueBall());
+			paths_.cue.push_back(paths_.contact);
+			paths_.object.push_back(OnCloth(table_.Balls()[event.other]));
+			break;
+		}
+		if (event.slot == cue_.slot)
+			Bounce(cue_, paths_.cue, bounces);
+		if (event.slot == object_.slot || event.other == object_.slot)
+			Bounce(object_, paths_.object, bounces);
+		break;
+	case ShotEvent::Type::Cushion:
+		if (event.slot == cue_.slot)
+			Bounce(cue_, paths_.cue, bounces);
+		else if (event.slot == object_.slot)
+			Bounce(object_, paths_.object, bounces);
+		break;
+	case ShotEvent::Type::Pocket:
+	case ShotEvent::Type::AtRest:
+		if (event.slot == cue_.slot)
+			End(cue_, paths_.cue);
+		else if (event.slot == object_.slot)
+			End(object_, paths_.object);
+		break;
+	}
+}
+
+void TrajectoryPreview::Bounce(Track& track, std::vector<glm::vec3>& path, const int bounces)
+{
+	if (track.slot < 0 || track.done)
+		return;
+	path.push_back(OnCloth(table_.Balls()[track.slot]));
+	track.done = ++track.bounces > bounces;
+}
+
+void TrajectoryPreview::End(Track& track, std::vector<glm::vec3>& path)
+{
+	if (track.slot < 0 || track.done)
+		return;
+	path.push_back(OnCloth(table_.Balls()[track.slot]));
+	track.done = true;
+}
+
+void TrajectoryPreview::Sample(const Track& track, std::vector<glm::vec3>& path) const
+{
+	// Enough points to show a swerve; none while the ball sits still
+	if (track.slot < 0 || track.done)
+		return;
+	const glm::vec3 point = OnCloth(table_.Balls()[track.slot]);
+	if (path.empty() || glm::distance(point, path.back()) > Config::trajectory_min_spacing)
+		path.push_back(point);
+}
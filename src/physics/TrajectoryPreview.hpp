@@ -0,0 +1,65 @@
+#pragma once
+#include "../headless.h"
+#include "TableSimulation.hpp"
+
+// Where the next shot would send the cue ball and the first ball it hits, as
+// polylines on the cloth (ball centres). Plain data: World fills it on the
+// simulation thread and the aiming guide draws it from the snapshot.
+struct PredictedPaths
+{
+	std::vector<glm::vec3> cue;      // from the cue ball's spot
+	std::vector<glm::vec3> object;   // from the object ball's spot; empty until the cue ball hits one
+	int object_slot = -1;            // the first ball the cue ball touches, -1: none (yet)
+	glm::vec3 contact{ 0.0f };       // cue ball centre at that contact
+	bool complete = false;           // false while the prediction is still being played out
+
+	void Clear();
+};
+
+// Plays the shot the cue is lined up for on a copy of the table, with the table's
+// own physics, and records both paths up to 'bounces' cushions or ball contacts
+// each (the first contact between the two does not count). The prediction is kept
+// while aim, stroke and table stay the same; a change starts it over. Each Advance
+// runs at most a budget of ticks, so a long shot is played out over several calls
+// and the paths grow from the cue ball outwards in the meantime.
+class TrajectoryPreview
+{
+public:
+	// Lines the preview up for 'velocity' and 'spin' (what BallBody::Shot would get)
+	// on 'table' as it is now. Starts over only if any of them changed
+	void Aim(const TableSimulation& table, const glm::vec3& velocity, const glm::vec2& spin);
+	// Plays out up to 'tick_budget' more ticks of the prediction
+	void Advance(float dt, int tick_budget, int bounces);
+	// Nothing to show (balls rolling, ball in hand, guide off); the next Aim starts over
+	void Reset();
+
+	[[nodiscard]] const PredictedPaths& Paths() const { return paths_; }
+
+private:
+	// Cue ball or object ball, as it is being followed
+	struct Track
+	{
+		int slot = -1;
+		int bounces = 0;
+		bool done = false;
+	};
+
+	void Follow(const ShotEvent& event, int bounces);
+	void Bounce(Track& track, std::vector<glm::vec3>& path, int bounces);
+	void End(Track& track, std::vector<glm::vec3>& path);
+	void Sample(const Track& track, std::vector<glm::vec3>& path) const;
+
+	// What the current prediction was started from
+	uint64_t table_hash_ = 0;
+	PhysicsParams params_{};
+	glm::vec3 velocity_{ 0.0f };
+	glm::vec2 spin_{ 0.0f };
+	bool aimed_ = false;
+
+	TableSimulation table_{ 0 };   // the copy the shot plays out on
+	int ticks_ = 0;
+	size_t events_seen_ = 0;
+	Track cue_{};
+	Track object_{};
+	PredictedPaths paths_{};
+};
@@ -0,0 +1,92 @@
+#include "headless.h"
+#include "core/AssetArchive.hpp"
+#include "core/MeshCache.hpp"
+
+// The game gets this from precompiled.cpp, which needs GL
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+// Build step: bakes every OBJ under assets/models into the binary mesh format
+// and packs it, together with the rest of assets/ and src/shaders/, into one
+// archive. Paths inside the archive mirror the loose install layout.
+//
+// usage: AssetPacker <source root> <output .pak>
+
+namespace {
+	std::vector<uint8_t> readFile(const std::filesystem::path& path) {
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in)
+			throw std::runtime_error("Cannot read " + path.string());
+
+		std::vector<uint8_t> bytes(static_cast<size_t>(std::filesystem::file_size(path)));
+		in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		return bytes;
+	}
+
+	bool isSourceOnly(const std::filesystem::path& path) {
+		// OBJ/MTL are replaced by baked meshes; local caches and backups never ship
+		static const std::array<std::string, 5> skipped = { ".obj", ".mtl", ".mesh", ".tmp", ".bak" };
+		const auto ext = path.extension().string();
+		return std::find(skipped.begin(), skipped.end(), ext) != skipped.end();
+	}
+
+	void packDirectory(AssetArchive::Writer& writer, const std::filesystem::path& root, const std::filesystem::path& dir) {
+		if (!std::filesystem::exists(dir))
+			return;
+
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(dir))
+		{
+			if (!entry.is_regular_file())
+				continue;
+
+			const auto& path = entry.path();
+			const auto name = std::filesystem::relative(path, root).generic_string();
+
+			if (path.extension() == ".obj")
+			{
+				auto mesh_name = std::filesystem::path(name).replace_extension(MeshCache::extension).generic_string();
+				writer.Add(mesh_name, MeshCache::Serialize(MeshCache::BakeObj(path)));
+				std::cout << "  baked  " << mesh_name << '\n';
+			}
+			else if (!isSourceOnly(path))
+			{
+				writer.Add(name, readFile(path));
+				std::cout << "  packed " << name << '\n';
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "usage: AssetPacker <source root> <output .pak>\n";
+		return 2;
+	}
+
+	const std::filesystem::path root = argv[1];
+	const std::filesystem::path output = argv[2];
+
+	try
+	{
+		AssetArchive::Writer writer;
+		packDirectory(writer, root, root / "assets");
+		packDirectory(writer, root, root / "src" / "shaders");
+
+		if (!writer.Write(output))
+		{
+			std::cerr << "AssetPacker: cannot write " << output.string() << '\n';
+			return 1;
+		}
+
+		std::cout << "AssetPacker: " << writer.Count() << " files -> " << output.string() << '\n';
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "AssetPacker: " << e.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}
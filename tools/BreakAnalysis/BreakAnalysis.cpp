@@ -0,0 +1,273 @@
+#include "headless.h"
+#include "BreakStats.hpp"
+#include "core/ThreadPool.hpp"
+#include "Common/HeadlessRun.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <mutex>
+#include <optional>
+
+// Monte Carlo over the opening break: racks the balls as the game does
+// (TableSimulation::Rack, shuffled per break), puts the cue ball somewhere behind the
+// head string and breaks at the head ball with a random speed, tip offset and a slight
+// cut, on every core. Tallies what goes down where, 8-on-the-break and scratch rates,
+// and heatmaps over the cue ball's spot and the stroke, written as CSV (and PNG with
+// --png). Break i is seeded from --seed and i, so a run is reproducible whatever the
+// thread count.
+//
+// usage: BreakAnalysis [--breaks N] [--seed S] [--rack SEED] [--spot-x LO:HI] [--spot-z LO:HI]
+//                      [--speed LO:HI] [--spin MAX] [--aim-offset MAX] [--out DIR] [--png] [--threads N]
+//        A range may be one value to hold it fixed. --rack plays every break on one shuffle
+
+namespace {
+	using Axis = BreakStats::Axis;
+
+	// Behind the head string: the quarter of the table at the cue ball's end
+	constexpr float kHeadString = 0.5f * (TableGeometry::bound_x + BallBody::radius);
+	constexpr size_t kMaxThreads = 1024;
+
+	struct Options {
+		size_t breaks = 100000;
+		uint32_t seed = 1;
+		std::optional<uint32_t> rack;
+		BreakStats::Axes axes{
+			{ kHeadString, TableGeometry::bound_x },
+			{ -TableGeometry::bound_z, TableGeometry::bound_z },
+			{ 3.5f, TableSimulation::MaxShotSpeed() },
+			{ -0.5f, 0.5f },
+		};
+		float aim_offset = 0.5f;   // ball radii either side of the head ball's centre
+		std::filesystem::path out = "break_analysis";
+		bool png = false;
+		size_t threads = 0;        // 0: every hardware thread
+	};
+
+	// A whole unsigned number that fits 'T' (no sign, nothing after it)
+	template <typename T>
+	bool parseCount(const std::string_view text, T& count) {
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+		return error == std::errc() && end == text.data() + text.size();
+	}
+
+	// A whole finite number (nothing after it)
+	bool parseNumber(const std::string_view text, float& value) {
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		return error == std::errc() && end == text.data() + text.size() && std::isfinite(value);
+	}
+
+	bool parseAxis(const std::string_view text, Axis& axis) {
+		const size_t colon = text.find(':');
+		if (!parseNumber(text.substr(0, colon), axis.low))
+			return false;
+		if (colon == std::string_view::npos)
+			axis.high = axis.low;
+		else if (!parseNumber(text.substr(colon + 1), axis.high))
+			return false;
+		return axis.low <= axis.high;
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--png") {
+				options.png = true;
+				continue;
+			}
+			if (i + 1 >= argc)
+				return false;
+			const std::string_view value = argv[++i];
+			bool ok = true;
+			if (arg == "--breaks") ok = parseCount(value, options.breaks) && options.breaks > 0;
+			else if (arg == "--seed") ok = parseCount(value, options.seed);
+			else if (arg == "--rack") ok = parseCount(value, options.rack.emplace());
+			else if (arg == "--spot-x") ok = parseAxis(value, options.axes.spot_x);
+			else if (arg == "--spot-z") ok = parseAxis(value, options.axes.spot_z);
+			else if (arg == "--speed") ok = parseAxis(value, options.axes.speed);
+			else if (arg == "--spin") {
+				float spin = 0.0f;
+				ok = parseNumber(value, spin) && spin >= 0.0f && spin <= 1.0f;
+				options.axes.spin = { -spin, spin };
+			}
+			else if (arg == "--aim-offset") {
+				ok = parseNumber(value, options.aim_offset) && options.aim_offset >= 0.0f && options.aim_offset < 2.0f;   // two radii would miss the head ball
+			}
+			else if (arg == "--out") options.out = value;
+			else if (arg == "--threads") ok = parseCount(value, options.threads) && options.threads <= kMaxThreads;
+			else return false;
+			if (!ok)
+				return false;
+		}
+		// The cue ball's spot must be on the cloth and the stroke within what the cue can give
+		const BreakStats::Axes& axes = options.axes;
+		return options.breaks > 0 &&
+			axes.spot_x.low >= -TableGeometry::bound_x && axes.spot_x.high <= TableGeometry::bound_x &&
+			axes.spot_z.low >= -TableGeometry::bound_z && axes.spot_z.high <= TableGeometry::bound_z &&
+			axes.speed.low > 0.0f && axes.speed.high <= TableSimulation::MaxShotSpeed();
+	}
+
+	int pocketOf(const glm::vec3& hole) {
+		int nearest = 0;
+		for (int pocket = 1; pocket < BreakStats::pocket_count; ++pocket)
+			if (glm::distance(hole, TableGeometry::holes[pocket]) < glm::distance(hole, TableGeometry::holes[nearest]))
+				nearest = pocket;
+		return nearest;
+	}
+
+	void playBreak(const Options& options, const size_t index, BreakStats& stats) {
+		std::mt19937 rng(options.seed * 0x9E3779B9u + static_cast<uint32_t>(index));
+		auto sample = [&rng](const Axis& axis) { return std::uniform_real_distribution<float>(axis.low, axis.high)(rng); };
+		const BreakStats::Axes& axes = options.axes;
+
+		const uint32_t rack_seed = options.rack.value_or(static_cast<uint32_t>(rng()));
+		const glm::vec2 sampled_spot(sample(axes.spot_x), sample(axes.spot_z));
+		const float speed = sample(axes.speed);
+		const glm::vec2 spin(sample(axes.spin), sample(axes.spin));
+		const float offset = sample({ -options.aim_offset, options.aim_offset }) * BallBody::radius;
+
+		// Placed as a player would, so a spot in a pocket mouth is moved out of it
+		// instead of scratching; behind the head string it cannot touch the rack
+		TableSimulation table(rack_seed);
+		table.PlaceCueBall(glm::vec3(sampled_spot.x, BallBody::radius, sampled_spot.y));
+		const glm::vec2 spot(table.CueBall().position.x, table.CueBall().position.z);
+
+		// At the head ball, 'offset' to one side of its centre
+		const glm::vec3 cue = table.CueBall().position;
+		const glm::vec3 head = table.Balls()[1].position;
+		const glm::vec3 line = head - cue;
+		const glm::vec3 side = glm::normalize(glm::vec3(-line.z, 0.0f, line.x));
+		table.Shoot(line + side * offset, speed, spin);
+
+		const float dt = 1.0f / static_cast<float>(Config::simulation_rate);
+		const HeadlessRun::ResolvedShot shot = HeadlessRun::ResolveShot(table, dt);
+		stats.ticks += static_cast<uint64_t>(shot.ticks);
+		stats.timeouts += shot.timed_out;
+
+		BreakStats::Cell outcome{ .breaks = 1 };
+		for (const ShotEvent& event : table.Events()) {
+			if (event.type != ShotEvent::Type::Pocket)
+				continue;
+			const BallBody& ball = table.Balls()[event.slot];
+			const int pocket = pocketOf(ball.hole);
+			++stats.by_number[ball.number][pocket];
+			++stats.by_rack_position[event.slot][pocket];
+			if (event.slot == 0)
+				outcome.scratches = 1;
+			else {
+				++outcome.pocketed;
+				outcome.eights |= ball.number == 8;
+			}
+		}
+		outcome.dry = outcome.pocketed == 0;
+
+		++stats.breaks;
+		stats.scratches += outcome.scratches;
+		stats.eights += outcome.eights;
+		stats.eight_and_scratch += outcome.eights & outcome.scratches;
+		++stats.pocketed_histogram[outcome.pocketed];
+		++stats.fouls[static_cast<int>(table.LastFoul())];
+		stats.spots[axes.spot_x.Bin(spot.x, BreakStats::spot_bins_x) * BreakStats::spot_bins_z +
+			axes.spot_z.Bin(spot.y, BreakStats::spot_bins_z)].Add(outcome);
+		stats.strokes[axes.speed.Bin(speed, BreakStats::speed_bins) * BreakStats::spin_bins +
+			axes.spin.Bin(spin.y, BreakStats::spin_bins)].Add(outcome);
+	}
+
+	std::string percent(const uint64_t k, const uint64_t n) {
+		const auto [low, high] = HeadlessRun::Wilson(k, n);
+		return std::format("{:.2f} % (95 % CI {:.2f} - {:.2f} %)", n ? 100.0 * k / n : 0.0, 100.0 * low, 100.0 * high);
+	}
+
+	void report(const BreakStats& stats, const size_t threads, const double seconds) {
+		std::cout << std::format("BreakAnalysis: {} breaks on {} threads in {:.2f} s -> {:.0f} breaks/s, {:.2f} M ticks/s\n",
+			stats.breaks, threads, seconds, stats.breaks / seconds, stats.ticks / seconds * 1e-6);
+
+		uint64_t pocketed = 0;
+		for (int n = 0; n < BreakStats::ball_count; ++n)
+			pocketed += stats.pocketed_histogram[n] * static_cast<uint64_t>(n);
+		std::cout << std::format("  object balls down per break {:.2f}, dry breaks {}\n",
+			static_cast<double>(pocketed) / static_cast<double>(stats.breaks), percent(stats.pocketed_histogram[0], stats.breaks));
+		std::cout << "  8 on the break " << percent(stats.eights, stats.breaks) << '\n';
+		std::cout << "  scratches " << percent(stats.scratches, stats.breaks)
+			<< std::format(", 8 and scratch together {}\n", stats.eight_and_scratch);
+
+		std::string pockets = "  share of object balls by pocket:";
+		for (int pocket = 0; pocket < BreakStats::pocket_count; ++pocket) {
+			uint64_t count = 0;
+			for (int ball = 1; ball < BreakStats::ball_count; ++ball)
+				count += stats.by_rack_position[ball][pocket];
+			pockets += std::format(" {} {:.1f} %,", BreakStats::PocketName(pocket), pocketed ? 100.0 * count / pocketed : 0.0);
+		}
+		pockets.pop_back();
+		std::cout << pockets << '\n';
+
+		std::string fouls = "  rulings:";
+		for (int kind = 0; kind < GameRules::foul_kinds; ++kind)
+			fouls += std::format(" {} {:.1f} %,", GameRules::FoulName(static_cast<GameRules::Foul>(kind)),
+				100.0 * stats.fouls[kind] / stats.breaks);
+		fouls.pop_back();
+		std::cout << fouls << '\n';
+		if (stats.timeouts)
+			std::cout << std::format("  {} breaks stopped after {} s\n", stats.timeouts, HeadlessRun::max_shot_seconds);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		if (!parseOptions(argc, argv, options))
+		{
+			std::cerr << "usage: BreakAnalysis [--breaks N] [--seed S] [--rack SEED] [--spot-x LO:HI] [--spot-z LO:HI]\n"
+				"                     [--speed LO:HI] [--spin MAX] [--aim-offset MAX] [--out DIR] [--png] [--threads N]\n";
+			return 2;
+		}
+
+		// The caller runs chunks too, so N threads is N - 1 workers
+		std::unique_ptr<ThreadPool> own_pool;
+		if (options.threads > 1)
+			own_pool = std::make_unique<ThreadPool>(options.threads - 1);
+		ThreadPool& pool = own_pool ? *own_pool : ThreadPool::Shared();
+		const size_t threads = options.threads == 1 ? 1 : pool.WorkerCount() + 1;
+
+		BreakStats stats;
+		std::mutex stats_mutex;
+		std::atomic<size_t> finished{ 0 };
+		const size_t progress_step = std::max<size_t>(options.breaks / 10, 1);
+
+		auto play = [&](const size_t begin, const size_t end) {
+			BreakStats local;
+			for (size_t index = begin; index < end; ++index)
+				playBreak(options, index, local);
+
+			std::lock_guard lock(stats_mutex);
+			stats.Add(local);
+			const size_t before = finished.fetch_add(end - begin);
+			if ((before + end - begin) / progress_step != before / progress_step && before + end - begin < options.breaks)
+				std::cout << std::format("  {} / {} breaks\n", before + end - begin, options.breaks) << std::flush;
+		};
+
+		const auto start = std::chrono::steady_clock::now();
+		if (threads == 1)
+			play(0, options.breaks);
+		else
+			pool.ParallelFor(options.breaks, std::clamp<size_t>(options.breaks / (threads * 64), 1, 4096), play);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		report(stats, threads, seconds);
+
+		std::filesystem::create_directories(options.out);
+		stats.WriteCsv(options.out, options.axes);
+		if (options.png)
+			stats.WritePng(options.out);
+		std::cout << std::format("  wrote {}\n", options.out.string());
+		return 0;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "BreakAnalysis: " << e.what() << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,193 @@
+#include "headless.h"
+#include "BreakStats.hpp"
+
+#include <optional>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace
+{
+	constexpr int kPixelsPerCell = 16;
+
+	template <size_t N>
+	void AddCounts(std::array<uint64_t, N>& into, const std::array<uint64_t, N>& from)
+	{
+		for (size_t i = 0; i < N; ++i)
+			into[i] += from[i];
+	}
+
+	double Rate(const uint64_t count, const uint64_t of)
+	{
+		return of ? static_cast<double>(count) / static_cast<double>(of) : 0.0;
+	}
+
+	std::ofstream OpenCsv(const std::filesystem::path& path)
+	{
+		std::ofstream file(path);
+		if (!file)
+			throw std::runtime_error(std::format("cannot write {}", path.string()));
+		return file;
+	}
+
+	// One square per cell; 'value' gives the cell's value, or nothing for an empty cell
+	// (drawn dark grey). Scaled so the highest cell is white
+	void WriteHeatmap(const std::filesystem::path& path, const int columns, const int rows,
+		const std::function<std::optional<double>(int column, int row)>& value)
+	{
+		double highest = 0.0;
+		for (int row = 0; row < rows; ++row)
+			for (int column = 0; column < columns; ++column)
+				highest = std::max(highest, value(column, row).value_or(0.0));
+
+		const int width = columns * kPixelsPerCell;
+		const int height = rows * kPixelsPerCell;
+		std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 3);
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				const std::optional<double> cell = value(x / kPixelsPerCell, y / kPixelsPerCell);
+				uint8_t* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 3];
+				if (!cell)
+				{
+					pixel[0] = pixel[1] = pixel[2] = 40;
+					continue;
+				}
+				const float t = highest > 0.0 ? static_cast<float>(*cell / highest) : 0.0f;
+				pixel[0] = static_cast<uint8_t>(255.0f * std::clamp(3.0f * t, 0.0f, 1.0f));
+				pixel[1] = static_cast<uint8_t>(255.0f * std::clamp(3.0f * t - 1.0f, 0.0f, 1.0f));
+				pixel[2] = static_cast<uint8_t>(255.0f * std::clamp(3.0f * t - 2.0f, 0.0f, 1.0f));
+			}
+		}
+		if (!stbi_write_png(path.string().c_str(), width, height, 3, pixels.data(), width * 3))
+			throw std::runtime_error(std::format("cannot write {}", path.string()));
+	}
+
+	// The three maps every grid gets: mean object balls down, scratch rate, 8 rate
+	void WriteCellMaps(const std::filesystem::path& directory, const std::string& prefix,
+		const int columns, const int rows, const std::function<const BreakStats::Cell&(int column, int row)>& cell)
+	{
+		auto map = [&](const char* name, uint64_t BreakStats::Cell::* count) {
+			WriteHeatmap(directory / std::format("{}_{}.png", prefix, name), columns, rows,
+				[&](const int column, const int row) -> std::optional<double> {
+					const BreakStats::Cell& c = cell(column, row);
+					if (c.breaks == 0)
+						return std::nullopt;
+					return Rate(c.*count, c.breaks);
+				});
+		};
+		map("pocketed", &BreakStats::Cell::pocketed);
+		map("scratch", &BreakStats::Cell::scratches);
+		map("eight", &BreakStats::Cell::eights);
+	}
+}
+
+int BreakStats::Axis::Bin(const float value, const int bins) const
+{
+	if (high <= low)
+		return 0;
+	const int bin = static_cast<int>((value - low) / (high - low) * static_cast<float>(bins));
+	return std::clamp(bin, 0, bins - 1);
+}
+
+float BreakStats::Axis::Centre(const int bin, const int bins) const
+{
+	return low + (high - low) * (static_cast<float>(bin) + 0.5f) / static_cast<float>(bins);
+}
+
+void BreakStats::Cell::Add(const Cell& other)
+{
+	breaks += other.breaks;
+	pocketed += other.pocketed;
+	dry += other.dry;
+	scratches += other.scratches;
+	eights += other.eights;
+}
+
+void BreakStats::Add(const BreakStats& other)
+{
+	breaks += other.breaks;
+	ticks += other.ticks;
+	scratches += other.scratches;
+	eights += other.eights;
+	eight_and_scratch += other.eight_and_scratch;
+	timeouts += other.timeouts;
+	AddCounts(pocketed_histogram, other.pocketed_histogram);
+	AddCounts(fouls, other.fouls);
+	for (int ball = 0; ball < ball_count; ++ball)
+	{
+		AddCounts(by_number[ball], other.by_number[ball]);
+		AddCounts(by_rack_position[ball], other.by_rack_position[ball]);
+	}
+	for (size_t i = 0; i < spots.size(); ++i)
+		spots[i].Add(other.spots[i]);
+	for (size_t i = 0; i < strokes.size(); ++i)
+		strokes[i].Add(other.strokes[i]);
+}
+
+const char* BreakStats::PocketName(const int pocket)
+{
+	// TableGeometry::holes order; the rack stands at the foot (-x), the cue ball starts at the head
+	static constexpr std::array<const char*, pocket_count> names = {
+		"head +z", "head -z", "side -z", "foot -z", "foot +z", "side +z"
+	};
+	return names[pocket];
+}
+
+void BreakStats::WriteCsv(const std::filesystem::path& directory, const Axes& axes) const
+{
+	// Probability per break that a ball goes down in each pocket
+	auto writePockets = [&](const char* name, const char* first_column,
+		const std::array<std::array<uint64_t, pocket_count>, ball_count>& counts, const bool with_spot) {
+		std::ofstream file = OpenCsv(directory / name);
+		file << first_column << (with_spot ? ",x,z" : "");
+		for (int pocket = 0; pocket < pocket_count; ++pocket)
+			file << ',' << PocketName(pocket);
+		file << ",any\n";
+
+		const TableSimulation rack(0);
+		for (int ball = 0; ball < ball_count; ++ball)
+		{
+			file << ball;
+			if (with_spot)
+				file << std::format(",{},{}", rack.Balls()[ball].position.x, rack.Balls()[ball].position.z);
+			uint64_t any = 0;
+			for (int pocket = 0; pocket < pocket_count; ++pocket)
+			{
+				file << std::format(",{}", Rate(counts[ball][pocket], breaks));
+				any += counts[ball][pocket];
+			}
+			file << std::format(",{}\n", Rate(any, breaks));
+		}
+	};
+	writePockets("pockets_by_ball.csv", "ball", by_number, false);
+	writePockets("pockets_by_rack_position.csv", "rack_position", by_rack_position, true);
+
+	auto writeCells = [&](const char* name, const char* x_name, const char* y_name, const Axis& x_axis, const int x_bins,
+		const Axis& y_axis, const int y_bins, const std::function<const Cell&(int, int)>& cell) {
+		std::ofstream file = OpenCsv(directory / name);
+		file << std::format("{},{},breaks,mean_pocketed,p_dry,p_scratch,p_eight\n", x_name, y_name);
+		for (int x = 0; x < x_bins; ++x)
+			for (int y = 0; y < y_bins; ++y)
+			{
+				const Cell& c = cell(x, y);
+				file << std::format("{},{},{},{},{},{},{}\n", x_axis.Centre(x, x_bins), y_axis.Centre(y, y_bins), c.breaks,
+					Rate(c.pocketed, c.breaks), Rate(c.dry, c.breaks), Rate(c.scratches, c.breaks), Rate(c.eights, c.breaks));
+			}
+	};
+	writeCells("cue_spot_heatmap.csv", "x", "z", axes.spot_x, spot_bins_x, axes.spot_z, spot_bins_z,
+		[&](const int x, const int z) -> const Cell& { return spots[x * spot_bins_z + z]; });
+	writeCells("stroke_heatmap.csv", "speed", "spin", axes.speed, speed_bins, axes.spin, spin_bins,
+		[&](const int speed, const int spin) -> const Cell& { return strokes[speed * spin_bins + spin]; });
+}
+
+void BreakStats::WritePng(const std::filesystem::path& directory) const
+{
+	// Cue spot: across the table left to right, head string at the top
+	WriteCellMaps(directory, "cue_spot", spot_bins_z, spot_bins_x,
+		[&](const int column, const int row) -> const Cell& { return spots[row * spot_bins_z + column]; });
+	// Stroke: speed left to right, most follow at the top
+	WriteCellMaps(directory, "stroke", speed_bins, spin_bins,
+		[&](const int column, const int row) -> const Cell& { return strokes[column * spin_bins + (spin_bins - 1 - row)]; });
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "headless.h"
+#include "physics/TableSimulation.hpp"
+
+// Tallies over many break shots: what went down where, per ball number and per
+// position in the rack, and how the outcome varies with the cue ball's spot and
+// the stroke. Plain counters, so per-thread tallies just add up.
+struct BreakStats
+{
+	static constexpr int ball_count = TableSimulation::ball_count;
+	static constexpr int pocket_count = static_cast<int>(TableGeometry::holes.size());
+	static constexpr int spot_bins_x = 12;   // along the table, head string to cushion
+	static constexpr int spot_bins_z = 24;   // across it
+	static constexpr int speed_bins = 16;
+	static constexpr int spin_bins = 16;     // follow/draw
+
+	// The sampled interval a heatmap axis covers
+	struct Axis
+	{
+		float low = 0.0f;
+		float high = 0.0f;
+
+		[[nodiscard]] int Bin(float value, int bins) const;
+		[[nodiscard]] float Centre(int bin, int bins) const;
+	};
+
+	struct Axes
+	{
+		Axis spot_x, spot_z, speed, spin;
+	};
+
+	// Outcomes of the breaks that fell in one heatmap cell
+	struct Cell
+	{
+		uint64_t breaks = 0;
+		uint64_t pocketed = 0;    // object balls, summed
+		uint64_t dry = 0;         // nothing went down
+		uint64_t scratches = 0;
+		uint64_t eights = 0;
+
+		void Add(const Cell& other);
+	};
+
+	uint64_t breaks = 0;
+	uint64_t ticks = 0;
+	uint64_t scratches = 0;
+	uint64_t eights = 0;
+	uint64_t eight_and_scratch = 0;   // loses the rack in most rule sets
+	uint64_t timeouts = 0;
+	std::array<uint64_t, ball_count> pocketed_histogram{};   // breaks that sank n object balls
+	std::array<std::array<uint64_t, pocket_count>, ball_count> by_number{};
+	std::array<std::array<uint64_t, pocket_count>, ball_count> by_rack_position{};
+	std::array<uint64_t, GameRules::foul_kinds> fouls{};
+	std::array<Cell, spot_bins_x * spot_bins_z> spots{};
+	std::array<Cell, speed_bins * spin_bins> strokes{};
+
+	void Add(const BreakStats& other);
+
+	// pockets_by_ball.csv, pockets_by_rack_position.csv, cue_spot_heatmap.csv, stroke_heatmap.csv
+	void WriteCsv(const std::filesystem::path& directory, const Axes& axes) const;
+	// cue_spot_{pocketed,scratch,eight}.png and stroke_{pocketed,scratch,eight}.png, one
+	// square per cell, black (lowest) through red and yellow to white (highest)
+	void WritePng(const std::filesystem::path& directory) const;
+
+	static const char* PocketName(int pocket);
+};
@@ -0,0 +1,302 @@
+#include "headless.h"
+#include "Calibration.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <chrono>
+#include <limits>
+#include <numeric>
+
+// Fits the ball model's constants (PhysicsParams) to measured behaviour: stop
+// distances, cushion rebound angles and draw distances from a targets file (see
+// Calibration.hpp). Every candidate is scored by playing each target's staged shot
+// several times with small aim and spot offsets, all on the thread pool; a
+// (mu/mu_w, lambda) evolution strategy over the chosen constants does the fitting.
+// --sweep instead steps one constant through a range and prints what each target
+// measures at every value, as CSV.
+//
+// usage: Calibrate [--targets FILE] [--fit NAME,NAME...] [--set NAME=VALUE]... [--population N]
+//                  [--generations G] [--samples K] [--seed S] [--threads N]
+//        Calibrate [--targets FILE] [--set NAME=VALUE]... --sweep NAME:LOW:HIGH:STEPS
+
+namespace {
+	using Calibration::Param;
+	using Calibration::Target;
+
+	constexpr std::array<std::string_view, 6> kDefaultFit = {
+		"linear_damping", "angular_damping", "spin_longitudinal_accel", "draw_kick", "cushion_restitution", "cushion_friction"
+	};
+
+	struct Sweep {
+		const Param* param = nullptr;
+		float low = 0.0f;
+		float high = 0.0f;
+		int steps = 0;
+	};
+
+	struct Options {
+		std::filesystem::path targets = "targets.txt";
+		std::vector<const Param*> fit;
+		PhysicsParams start{};       // the game's tuning, with --set applied
+		std::optional<Sweep> sweep;
+		size_t population = 24;
+		int generations = 40;
+		size_t samples = 8;          // staged shots per target and candidate
+		uint32_t seed = 1;
+		size_t threads = 0;          // 0: every hardware thread
+	};
+
+	std::vector<std::string_view> split(std::string_view text, const char separator) {
+		std::vector<std::string_view> parts;
+		for (size_t next; (next = text.find(separator)) != std::string_view::npos; text.remove_prefix(next + 1))
+			parts.push_back(text.substr(0, next));
+		parts.push_back(text);
+		return parts;
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (i + 1 >= argc)
+				return false;
+			const std::string_view value = argv[++i];
+			if (arg == "--targets") options.targets = value;
+			else if (arg == "--population") options.population = std::stoul(std::string(value));
+			else if (arg == "--generations") options.generations = std::stoi(std::string(value));
+			else if (arg == "--samples") options.samples = std::stoul(std::string(value));
+			else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(std::string(value)));
+			else if (arg == "--threads") options.threads = std::stoul(std::string(value));
+			else if (arg == "--fit") {
+				for (const std::string_view name : split(value, ',')) {
+					const Param* param = Calibration::FindParam(name);
+					if (!param)
+						return false;
+					options.fit.push_back(param);
+				}
+			}
+			else if (arg == "--set") {
+				const auto parts = split(value, '=');
+				const Param* param = parts.size() == 2 ? Calibration::FindParam(parts[0]) : nullptr;
+				if (!param)
+					return false;
+				options.start.*param->field = std::stof(std::string(parts[1]));
+			}
+			else if (arg == "--sweep") {
+				const auto parts = split(value, ':');
+				if (parts.size() != 4 || !Calibration::FindParam(parts[0]))
+					return false;
+				options.sweep = Sweep{ Calibration::FindParam(parts[0]), std::stof(std::string(parts[1])),
+					std::stof(std::string(parts[2])), std::stoi(std::string(parts[3])) };
+				if (options.sweep->steps < 2)
+					return false;
+			}
+			else return false;
+		}
+		if (options.fit.empty())
+			for (const std::string_view name : kDefaultFit)
+				options.fit.push_back(Calibration::FindParam(name));
+		return options.population >= 4 && options.generations > 0 && options.samples > 0;
+	}
+
+	// Runs every (candidate, target, sample) shot at once on the pool and returns each
+	// candidate's mean measurement per target, candidate-major
+	class Evaluator {
+	public:
+		Evaluator(const std::vector<Target>& targets, const size_t samples, const uint32_t seed, ThreadPool* pool) :
+			targets_(targets), jitters_(Calibration::MakeJitters(samples, seed)), pool_(pool) {}
+
+		std::vector<float> Measure(const std::vector<PhysicsParams>& candidates) {
+			const size_t per_candidate = targets_.size() * jitters_.size();
+			std::vector<float> shots(candidates.size() * per_candidate);
+			auto body = [&](const size_t begin, const size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					const size_t candidate = i / per_candidate;
+					const size_t target = i % per_candidate / jitters_.size();
+					const size_t jitter = i % jitters_.size();
+					shots[i] = Calibration::Measure(targets_[target], candidates[candidate], jitters_[jitter]);
+				}
+			};
+			if (pool_)
+				pool_->ParallelFor(shots.size(), 1, body);
+			else
+				body(0, shots.size());
+			simulations_ += shots.size();
+
+			std::vector<float> means(candidates.size() * targets_.size());
+			for (size_t i = 0; i < means.size(); ++i) {
+				float sum = 0.0f;
+				for (size_t jitter = 0; jitter < jitters_.size(); ++jitter)
+					sum += shots[i * jitters_.size() + jitter];
+				means[i] = sum / static_cast<float>(jitters_.size());
+			}
+			return means;
+		}
+
+		float Cost(const float* measured) const {
+			float cost = 0.0f;
+			for (size_t target = 0; target < targets_.size(); ++target)
+				cost += Calibration::Cost(targets_[target], measured[target]);
+			return cost;
+		}
+
+		[[nodiscard]] size_t Simulations() const { return simulations_; }
+
+	private:
+		const std::vector<Target>& targets_;
+		std::vector<Calibration::Jitter> jitters_;
+		ThreadPool* pool_;
+		size_t simulations_ = 0;
+	};
+
+	const char* unitOf(const Target& target) {
+		return target.kind == Target::Kind::Rebound ? "deg" : "m";
+	}
+
+	int runSweep(const Options& options, const std::vector<Target>& targets, Evaluator& evaluator) {
+		const Sweep& sweep = *options.sweep;
+		std::vector<PhysicsParams> candidates(sweep.steps, options.start);
+		for (int step = 0; step < sweep.steps; ++step)
+			candidates[step].*sweep.param->field = sweep.low + (sweep.high - sweep.low) * static_cast<float>(step) / static_cast<float>(sweep.steps - 1);
+		const std::vector<float> measured = evaluator.Measure(candidates);
+
+		for (size_t target = 0; target < targets.size(); ++target)
+			std::cout << std::format("# t{}: {} ({}, expected {})\n", target + 1, Calibration::Describe(targets[target]),
+				unitOf(targets[target]), targets[target].expected);
+		std::cout << sweep.param->name << ",cost";
+		for (size_t target = 0; target < targets.size(); ++target)
+			std::cout << ",t" << target + 1;
+		std::cout << '\n';
+
+		for (int step = 0; step < sweep.steps; ++step) {
+			const float* row = &measured[step * targets.size()];
+			std::cout << std::format("{},{}", candidates[step].*sweep.param->field, evaluator.Cost(row));
+			for (size_t target = 0; target < targets.size(); ++target)
+				std::cout << std::format(",{}", row[target]);
+			std::cout << '\n';
+		}
+		return 0;
+	}
+
+	int runFit(const Options& options, const std::vector<Target>& targets, Evaluator& evaluator) {
+		// The search runs in [0, 1] per constant, mapped onto its range
+		const size_t dims = options.fit.size();
+		auto toParams = [&](const std::vector<float>& unit) {
+			PhysicsParams params = options.start;
+			for (size_t d = 0; d < dims; ++d) {
+				const Param& param = *options.fit[d];
+				params.*param.field = param.low + unit[d] * (param.high - param.low);
+			}
+			return params;
+		};
+
+		std::vector<float> mean(dims);
+		for (size_t d = 0; d < dims; ++d) {
+			const Param& param = *options.fit[d];
+			mean[d] = std::clamp((options.start.*param.field - param.low) / (param.high - param.low), 0.0f, 1.0f);
+		}
+
+		std::vector<float> best = mean;
+		std::vector<float> best_measured;
+		float best_cost = std::numeric_limits<float>::infinity();
+
+		// Log-rank weights over the better half. Candidate 0 of every generation is the
+		// mean itself: the parent the others are judged against
+		const size_t lambda = options.population;
+		const size_t mu = lambda / 2;
+		std::vector<float> weights(mu);
+		for (size_t k = 0; k < mu; ++k)
+			weights[k] = std::log(static_cast<float>(mu) + 0.5f) - std::log(static_cast<float>(k) + 1.0f);
+		const float weight_sum = std::accumulate(weights.begin(), weights.end(), 0.0f);
+
+		std::mt19937 rng(options.seed);
+		std::normal_distribution<float> normal(0.0f, 1.0f);
+		float step = 0.1f;
+		for (int generation = 1; generation <= options.generations && step > 1e-4f; ++generation) {
+			std::vector<std::vector<float>> points(lambda, mean);
+			std::vector<PhysicsParams> candidates(lambda);
+			for (size_t i = 0; i < lambda; ++i) {
+				for (size_t d = 0; d < dims && i > 0; ++d)
+					points[i][d] = std::clamp(mean[d] + step * normal(rng), 0.0f, 1.0f);
+				candidates[i] = toParams(points[i]);
+			}
+
+			const std::vector<float> measured = evaluator.Measure(candidates);
+			std::vector<std::pair<float, size_t>> ranked(lambda);
+			for (size_t i = 0; i < lambda; ++i)
+				ranked[i] = { evaluator.Cost(&measured[i * targets.size()]), i };
+			std::sort(ranked.begin(), ranked.end());
+
+			std::fill(mean.begin(), mean.end(), 0.0f);
+			for (size_t k = 0; k < mu; ++k)
+				for (size_t d = 0; d < dims; ++d)
+					mean[d] += weights[k] / weight_sum * points[ranked[k].second][d];
+
+			const auto [cost, index] = ranked.front();
+			if (cost < best_cost) {
+				best_cost = cost;
+				best = points[index];
+				best_measured.assign(measured.begin() + index * targets.size(), measured.begin() + (index + 1) * targets.size());
+			}
+
+			// One-fifth rule: widen while more than a fifth of the offspring beat their parent
+			const float parent = evaluator.Cost(&measured[0]);
+			const auto successes = std::count_if(ranked.begin(), ranked.end(),
+				[parent](const std::pair<float, size_t>& entry) { return entry.first < parent; });
+			step *= 5 * successes > static_cast<std::ptrdiff_t>(lambda - 1) ? 1.25f : 0.85f;
+			std::cout << std::format("generation {}: parent {:.3f}, best {:.3f}, step {:.4f}\n", generation, parent, best_cost, step) << std::flush;
+		}
+
+		std::cout << '\n';
+		for (size_t target = 0; target < targets.size(); ++target)
+			std::cout << std::format("  {:<32} {:8.3f} {} (expected {}, cost {:.3f})\n", Calibration::Describe(targets[target]),
+				best_measured[target], unitOf(targets[target]), targets[target].expected,
+				Calibration::Cost(targets[target], best_measured[target]));
+
+		// Ready to paste back into Config.hpp
+		const PhysicsParams fitted = toParams(best);
+		std::cout << "\nConfig.hpp:\n";
+		for (const Param* param : options.fit)
+			std::cout << std::format("\tinline static float {} = {}f;\n", param->name, fitted.*param->field);
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		if (!parseOptions(argc, argv, options))
+		{
+			std::cerr << "usage: Calibrate [--targets FILE] [--fit NAME,NAME...] [--set NAME=VALUE]... [--population N]\n"
+				"                 [--generations G] [--samples K] [--seed S] [--threads N]\n"
+				"       Calibrate [--targets FILE] [--set NAME=VALUE]... --sweep NAME:LOW:HIGH:STEPS\n"
+				"       NAME:";
+			for (const Param& param : Calibration::Params())
+				std::cerr << ' ' << param.name;
+			std::cerr << '\n';
+			return 2;
+		}
+		const std::vector<Target> targets = Calibration::LoadTargets(options.targets);
+
+		// The caller runs chunks too, so N threads is N - 1 workers
+		std::unique_ptr<ThreadPool> own_pool;
+		if (options.threads > 1)
+			own_pool = std::make_unique<ThreadPool>(options.threads - 1);
+		ThreadPool* pool = options.threads == 1 ? nullptr : own_pool ? own_pool.get() : &ThreadPool::Shared();
+		const size_t threads = pool ? pool->WorkerCount() + 1 : 1;
+
+		Evaluator evaluator(targets, options.samples, options.seed, pool);
+		const auto start = std::chrono::steady_clock::now();
+		const int result = options.sweep ? runSweep(options, targets, evaluator) : runFit(options, targets, evaluator);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cerr << std::format("Calibrate: {} simulations on {} threads in {:.2f} s -> {:.0f} simulations/s\n",
+			evaluator.Simulations(), threads, seconds, evaluator.Simulations() / seconds);
+		return result;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Calibrate: " << e.what() << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,224 @@
+#include "headless.h"
+#include "Calibration.hpp"
+#include "Common/HeadlessRun.hpp"
+
+#include <limits>
+#include <sstream>
+
+namespace
+{
+	using Target = Calibration::Target;
+	using Param = Calibration::Param;
+
+	constexpr float kFailedCost = 1.0e4f;
+	constexpr float kDrawDistance = 0.5f;     // cue ball to object ball, centre to centre
+	constexpr float kReboundRunUp = 0.3f;     // cue ball to the cushion
+
+	constexpr std::array<Param, 14> kParams = { {
+		{ "linear_damping", &PhysicsParams::linear_damping, 0.985f, 0.9995f },
+		{ "angular_damping", &PhysicsParams::angular_damping, 0.5f, 0.999f },
+		{ "spin_longitudinal_accel", &PhysicsParams::spin_longitudinal_accel, 0.0f, 20.0f },
+		{ "spin_lateral_accel", &PhysicsParams::spin_lateral_accel, 0.0f, 5.0f },
+		{ "draw_kick", &PhysicsParams::draw_kick, 0.0f, 0.5f },
+		{ "ball_restitution", &PhysicsParams::ball_restitution, 0.8f, 1.0f },
+		{ "table_friction", &PhysicsParams::table_friction, 0.0f, 0.4f },
+		{ "spin_transfer_coef", &PhysicsParams::spin_transfer_coef, 0.0f, 1.0f },
+		{ "impact_spin_keep", &PhysicsParams::impact_spin_keep, 0.5f, 1.0f },
+		{ "cushion_restitution", &PhysicsParams::cushion_restitution, 0.5f, 1.0f },
+		{ "cushion_friction", &PhysicsParams::cushion_friction, 0.0f, 0.5f },
+		{ "rail_longitudinal_keep", &PhysicsParams::rail_longitudinal_keep, 0.0f, 1.0f },
+		{ "rail_side_flip", &PhysicsParams::rail_side_flip, 0.0f, 1.5f },
+		{ "rail_throw_impulse", &PhysicsParams::rail_throw_impulse, 0.0f, 0.3f },
+	} };
+
+	// Only the cue ball and, if given, one more ball on the table; the others lie in a
+	// pocket as if potted earlier
+	TableSimulation Stage(const PhysicsParams& params, const glm::vec3 cue, const std::optional<glm::vec3> object)
+	{
+		TableSimulation table(0, params);
+		TableSimulation::Snapshot snapshot = table.Save();
+		snapshot.touching.fill(0);
+		for (int slot = 1; slot < TableSimulation::ball_count; ++slot)
+		{
+			BallBody& ball = snapshot.balls[slot];
+			ball.in_hole = true;
+			ball.drawn = false;
+			ball.hole = TableGeometry::holes[0];
+			ball.position = glm::vec3(ball.hole.x, TableGeometry::hole_bottom + BallBody::radius, ball.hole.z);
+		}
+		snapshot.balls[0].position = glm::vec3(cue.x, BallBody::radius, cue.z);
+		if (object)
+		{
+			BallBody& ball = snapshot.balls[1];
+			ball.in_hole = false;
+			ball.drawn = true;
+			ball.position = glm::vec3(object->x, BallBody::radius, object->z);
+		}
+		table.Restore(snapshot);
+		return table;
+	}
+
+	// Horizontal direction at 'radians' from +x, turning towards +z
+	glm::vec3 Heading(const float radians)
+	{
+		return glm::vec3(std::cos(radians), 0.0f, std::sin(radians));
+	}
+}
+
+std::vector<Target> Calibration::LoadTargets(const std::filesystem::path& path)
+{
+	std::ifstream file(path);
+	if (!file)
+		throw std::runtime_error(std::format("cannot open {}", path.string()));
+
+	std::vector<Target> targets;
+	std::string text;
+	for (int line = 1; std::getline(file, text); ++line)
+	{
+		std::istringstream in(text.substr(0, text.find('#')));
+		std::string kind;
+		if (!(in >> kind))
+			continue;
+
+		Target target;
+		target.line = line;
+		bool ok = false;
+		if (kind == "stop")
+		{
+			target.kind = Target::Kind::Stop;
+			target.tolerance = 0.05f;
+			ok = static_cast<bool>(in >> target.speed >> target.expected);
+		}
+		else if (kind == "rebound")
+		{
+			target.kind = Target::Kind::Rebound;
+			target.tolerance = 1.0f;
+			ok = static_cast<bool>(in >> target.speed >> target.angle >> target.expected) &&
+				target.angle >= 0.0f && target.angle < 80.0f;
+		}
+		else if (kind == "draw")
+		{
+			target.kind = Target::Kind::Draw;
+			target.tolerance = 0.05f;
+			ok = static_cast<bool>(in >> target.speed >> target.spin >> target.expected) && std::abs(target.spin) <= 1.0f;
+		}
+
+		// Optional tolerance, then nothing
+		float tolerance = 0.0f;
+		if (ok && in >> tolerance)
+			target.tolerance = tolerance;
+		else if (ok && !in.eof())
+			ok = false;
+		in.clear();
+		std::string extra;
+		if (ok && in >> extra)
+			ok = false;
+
+		if (!ok || target.speed <= 0.0f || target.speed > TableSimulation::MaxShotSpeed() || target.tolerance <= 0.0f)
+			throw std::runtime_error(std::format("{}:{}: expected 'stop <speed> <m>', 'rebound <speed> <deg in> <deg out>' "
+				"or 'draw <speed> <spin> <m>', then an optional tolerance", path.string(), line));
+		targets.push_back(target);
+	}
+	if (targets.empty())
+		throw std::runtime_error(std::format("{}: no targets", path.string()));
+	return targets;
+}
+
+std::string Calibration::Describe(const Target& target)
+{
+	switch (target.kind)
+	{
+	case Target::Kind::Stop:
+		return std::format("stop at {:.2f} m/s", target.speed);
+	case Target::Kind::Rebound:
+		return std::format("rebound at {:.2f} m/s, {:.1f} deg in", target.speed, target.angle);
+	case Target::Kind::Draw:
+		return std::format("draw at {:.2f} m/s, spin {:+.2f}", target.speed, target.spin);
+	}
+	return {};
+}
+
+std::vector<Calibration::Jitter> Calibration::MakeJitters(const size_t count, const uint32_t seed)
+{
+	// The first is the exact shot
+	std::vector<Jitter> jitters(std::max<size_t>(count, 1));
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	for (size_t i = 1; i < jitters.size(); ++i)
+		jitters[i] = { 0.25f * unit(rng), 0.005f * unit(rng) };
+	return jitters;
+}
+
+float Calibration::Measure(const Target& target, const PhysicsParams& params, const Jitter& jitter)
+{
+	const float dt = 1.0f / static_cast<float>(Config::simulation_rate);
+	const float turn = glm::radians(jitter.aim_degrees);
+
+	switch (target.kind)
+	{
+	case Target::Kind::Stop:
+	{
+		TableSimulation table = Stage(params, glm::vec3(-1.0f, 0.0f, jitter.offset), std::nullopt);
+		table.Shoot(Heading(turn), target.speed, glm::vec2(0.0f));
+
+		// Path length, so a long roll that comes off the far cushion still counts in full
+		float path = 0.0f;
+		glm::vec3 last = table.CueBall().position;
+		for (int tick = 0; tick < HeadlessRun::max_shot_ticks && table.AreBallsInMotion(); ++tick)
+		{
+			table.Step(dt);
+			path += glm::distance(table.CueBall().position, last);
+			last = table.CueBall().position;
+		}
+		return path;
+	}
+	case Target::Kind::Rebound:
+	{
+		// Into the +z cushion between the side and corner pockets; the angle is from its normal
+		const glm::vec3 direction = Heading(glm::half_pi<float>() - glm::radians(target.angle) + turn);
+		const glm::vec3 impact(0.5f + jitter.offset, 0.0f, TableGeometry::bound_z);
+		TableSimulation table = Stage(params, impact - direction * kReboundRunUp, std::nullopt);
+		table.Shoot(direction, target.speed, glm::vec2(0.0f));
+
+		for (int tick = 0; tick < HeadlessRun::max_shot_ticks && table.AreBallsInMotion(); ++tick)
+		{
+			table.Step(dt);
+			const glm::vec3& velocity = table.CueBall().velocity;
+			if (velocity.z < 0.0f)
+				return glm::degrees(std::atan2(std::abs(velocity.x), -velocity.z));
+		}
+		return std::numeric_limits<float>::quiet_NaN();
+	}
+	case Target::Kind::Draw:
+	{
+		TableSimulation table = Stage(params, glm::vec3(-kDrawDistance, 0.0f, jitter.offset), glm::vec3(0.0f));
+		table.Shoot(Heading(turn), target.speed, glm::vec2(0.0f, target.spin));
+		if (HeadlessRun::ResolveShot(table, dt).timed_out)
+			return std::numeric_limits<float>::quiet_NaN();
+		const float contact_x = -2.0f * BallBody::radius;
+		return contact_x - table.CueBall().position.x;
+	}
+	}
+	return std::numeric_limits<float>::quiet_NaN();
+}
+
+float Calibration::Cost(const Target& target, const float measured)
+{
+	if (!std::isfinite(measured))
+		return kFailedCost;
+	const float error = (measured - target.expected) / target.tolerance;
+	return std::min(error * error, kFailedCost);
+}
+
+std::span<const Param> Calibration::Params()
+{
+	return kParams;
+}
+
+const Param* Calibration::FindParam(const std::string_view name)
+{
+	for (const Param& param : kParams)
+		if (name == param.name)
+			return &param;
+	return nullptr;
+}
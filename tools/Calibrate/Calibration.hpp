@@ -0,0 +1,64 @@
+#pragma once
+#include "headless.h"
+#include "physics/TableSimulation.hpp"
+
+#include <optional>
+#include <span>
+
+// What Calibrate measures and fits: staged single shots on otherwise empty tables,
+// each run with a given PhysicsParams, and the constants it is allowed to move.
+namespace Calibration
+{
+	// One measurement and the value it should come out at
+	struct Target
+	{
+		enum class Kind : uint8_t {
+			Stop,      // cue ball alone: path length until it stops (m)
+			Rebound,   // straight into the long cushion at 'angle' from its normal: angle it leaves at (deg)
+			Draw,      // full hit on a ball 0.5 m away with tip offset 'spin': how far the cue ball
+			           // comes back from the contact point (m, negative when it follows through)
+		};
+
+		Kind kind = Kind::Stop;
+		float speed = 0.0f;      // cue ball speed off the tip, m/s
+		float angle = 0.0f;      // Rebound
+		float spin = 0.0f;       // Draw
+		float expected = 0.0f;
+		float tolerance = 0.0f;  // error worth one unit of cost
+		int line = 0;            // in the targets file
+	};
+
+	// '#' comments, one target per line:  stop <speed> <metres> [tolerance]
+	//                                     rebound <speed> <angle in> <angle out> [tolerance]
+	//                                     draw <speed> <spin> <metres> [tolerance]
+	// Throws std::runtime_error naming the line that does not parse
+	std::vector<Target> LoadTargets(const std::filesystem::path& path);
+	std::string Describe(const Target& target);
+
+	// Small offsets of the staged shot (aim and cue ball spot), so a measurement is an
+	// average over nearby shots rather than one exact line; the same for every candidate
+	struct Jitter
+	{
+		float aim_degrees = 0.0f;
+		float offset = 0.0f;     // metres, across the line of the shot
+	};
+	std::vector<Jitter> MakeJitters(size_t count, uint32_t seed);
+
+	// Plays the staged shot to rest. NaN if it never gets to what it measures
+	// (a rebound that stops short of the cushion)
+	float Measure(const Target& target, const PhysicsParams& params, const Jitter& jitter);
+
+	// Squared error in tolerances; a measurement that failed costs a flat penalty
+	float Cost(const Target& target, float measured);
+
+	// A constant the fit may move, with the range it stays in
+	struct Param
+	{
+		const char* name;
+		float PhysicsParams::* field;
+		float low;
+		float high;
+	};
+	std::span<const Param> Params();
+	const Param* FindParam(std::string_view name);
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "headless.h"
+#include "physics/TableSimulation.hpp"
+
+#include <cmath>
+
+// What the headless tools share about playing shots out and reporting rates.
+namespace HeadlessRun
+{
+	// A shot still rolling after this is stopped where it is, so the rules still run
+	inline constexpr int max_shot_seconds = 60;
+	inline constexpr int max_shot_ticks = max_shot_seconds * Config::simulation_rate;
+
+	struct ResolvedShot
+	{
+		int ticks = 0;
+		bool timed_out = false;   // stopped at max_shot_seconds
+	};
+
+	// TableSimulation::ResolveShot with the cap above
+	inline ResolvedShot ResolveShot(TableSimulation& table, const float dt)
+	{
+		const int ticks = table.ResolveShot(dt, max_shot_ticks);
+		return { ticks, ticks > max_shot_ticks };
+	}
+
+	// Wilson score interval (95 %) for 'k' successes out of 'n'; 0 - 0 for no trials
+	inline std::pair<double, double> Wilson(const uint64_t k, const uint64_t n)
+	{
+		if (n == 0)
+			return { 0.0, 0.0 };
+		constexpr double z = 1.96;
+		const double p = static_cast<double>(k) / static_cast<double>(n);
+		const double z2n = z * z / static_cast<double>(n);
+		const double centre = (p + z2n / 2.0) / (1.0 + z2n);
+		const double half = z * std::sqrt(p * (1.0 - p) / static_cast<double>(n) + z2n / (4.0 * static_cast<double>(n))) / (1.0 + z2n);
+		return { centre - half, centre + half };
+	}
+}
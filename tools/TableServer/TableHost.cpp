@@ -0,0 +1,212 @@
+#include "headless.h"
+#include "TableHost.hpp"
+#include "core/ThreadPool.hpp"
+#include "Common/HeadlessRun.hpp"
+
+namespace
+{
+	using namespace TableProtocol;
+
+	TableView Capture(const TableSimulation& simulation)
+	{
+		TableView view;
+		const auto& balls = simulation.Balls();
+		for (int slot = 0; slot < ball_count; ++slot)
+		{
+			view.x[slot] = Quantize(balls[slot].position.x);
+			view.z[slot] = Quantize(balls[slot].position.z);
+			view.numbers[slot] = static_cast<uint8_t>(balls[slot].number);
+			if (balls[slot].drawn)
+				view.drawn |= static_cast<uint16_t>(1u << slot);
+		}
+
+		const GameState& state = simulation.State();
+		view.current_player = static_cast<uint8_t>(state.CurrentPlayerIndex());
+		view.flags = static_cast<uint8_t>((state.BallInHand() ? BallInHand : 0) | (state.IsGameOver() ? GameOver : 0) |
+			(state.IsAfterBreak() ? AfterBreak : 0) | (state.IsFirstShot() ? TableOpen : 0));
+		for (int player = 0; player < 2; ++player)
+		{
+			view.groups[player] = static_cast<int8_t>(state.GroupOfPlayer(player));
+			view.scores[player] = static_cast<uint8_t>(std::clamp(state.Players()[player].GetScore(), 0, 255));
+		}
+		view.message = state.Message();
+		return view;
+	}
+
+	std::vector<uint8_t> Reply(const Request& request, const Status status)
+	{
+		Writer writer;
+		writer.Put(MessageType::Result);
+		writer.Put(request.table);
+		writer.Put(request.sequence);
+		writer.Put(status);
+		writer.Put(uint16_t{ 0 });
+		return writer.Frame();
+	}
+}
+
+TableHost::TableHost(const size_t table_count, ThreadPool& pool) :
+	table_count_(table_count),
+	tables_(std::make_unique<Table[]>(table_count)),
+	pool_(pool)
+{
+	for (size_t i = 0; i < table_count_; ++i)
+	{
+		tables_[i].simulation = TableSimulation(static_cast<uint32_t>(i));
+		tables_[i].sent = Capture(tables_[i].simulation);
+	}
+}
+
+TableHost::~TableHost()
+{
+	Stop();
+}
+
+void TableHost::Serve(Socket& listener)
+{
+	listener_ = &listener;
+	while (!stopping_.load())
+	{
+		Socket client = listener.Accept();
+		if (!client.IsValid())
+			break;
+
+		auto connection = std::make_shared<Connection>();
+		connection->socket = std::move(client);
+
+		std::lock_guard lock(connections_mutex_);
+		if (stopping_.load())
+			break;
+
+		// Reap clients that went away
+		std::erase_if(connections_, [](const std::shared_ptr<Connection>& old) {
+			if (!old->closed.load())
+				return false;
+			old->reader.join();
+			return true;
+		});
+
+		connection->reader = std::thread([this, connection] { ReadRequests(connection); });
+		connections_.push_back(std::move(connection));
+	}
+}
+
+void TableHost::Stop()
+{
+	if (stopping_.exchange(true))
+		return;
+	// Wake the threads only: each handle closes once nothing can be inside a call on it
+	if (listener_)
+		listener_->WakeAccept();
+
+	std::vector<std::shared_ptr<Connection>> connections;
+	{
+		std::lock_guard lock(connections_mutex_);
+		connections.swap(connections_);
+	}
+	for (const auto& connection : connections)
+		connection->socket.Shutdown();
+	for (const auto& connection : connections)
+		if (connection->reader.joinable())
+			connection->reader.join();
+
+	// Queued shots still reference the tables
+	while (in_flight_.load() > 0)
+		std::this_thread::yield();
+}
+
+void TableHost::ReadRequests(const std::shared_ptr<Connection>& connection)
+{
+	std::vector<uint8_t> payload;
+	while (!stopping_.load())
+	{
+		uint16_t size = 0;
+		if (!connection->socket.ReceiveAll(&size, sizeof(size)) || size > max_payload)
+			break;
+		payload.resize(size);
+		if (!connection->socket.ReceiveAll(payload.data(), payload.size()))
+			break;
+
+		const std::optional<Request> request = DecodeRequest(payload.data(), payload.size());
+		if (!request)
+		{
+			const auto reply = Reply(Request{}, Status::Malformed);
+			std::lock_guard lock(connection->send_mutex);
+			connection->socket.SendAll(reply.data(), reply.size());
+			continue;
+		}
+
+		++in_flight_;
+		pool_.Submit([this, connection, request = *request] {
+			const auto reply = Handle(request);
+			{
+				std::lock_guard lock(connection->send_mutex);
+				connection->socket.SendAll(reply.data(), reply.size());
+			}
+			--in_flight_;
+		});
+	}
+	connection->closed.store(true);
+}
+
+std::vector<uint8_t> TableHost::Handle(const Request& request)
+{
+	// NaN or inf would be carried into the table by Shoot/PlaceCueBall and spread by the contacts
+	if (!IsFinite(request))
+		return Reply(request, Status::Malformed);
+	if (request.table >= table_count_)
+		return Reply(request, Status::InvalidTable);
+
+	Table& table = tables_[request.table];
+	if (table.busy.test_and_set(std::memory_order_acquire))
+		return Reply(request, Status::TableBusy);
+
+	TableSimulation& simulation = table.simulation;
+	GameState& state = simulation.State();
+	const float dt = 1.0f / static_cast<float>(Config::simulation_rate);
+
+	bool accepted = true;
+	bool full = false;
+	int ticks = 0;
+	switch (request.type)
+	{
+	case MessageType::NewRack:
+		simulation = TableSimulation(request.seed);
+		full = true;
+		break;
+	case MessageType::FullState:
+		full = true;
+		break;
+	case MessageType::Shot:
+		state.SetMessage("", 0.0f);   // the reply carries what this shot said
+		accepted = simulation.Shoot(glm::vec3(request.aim_x, 0.0f, request.aim_z), request.speed,
+			glm::vec2(request.spin_x, request.spin_y));
+		if (accepted)
+			ticks = HeadlessRun::ResolveShot(simulation, dt).ticks;
+		break;
+	case MessageType::PlaceCueBall:
+		state.SetMessage("", 0.0f);
+		accepted = state.BallInHand() && !state.IsGameOver() &&
+			simulation.PlaceCueBall(glm::vec3(request.x, BallBody::radius, request.z));
+		if (accepted)
+			simulation.ConfirmCueBall();
+		break;
+	default:
+		accepted = false;
+		break;
+	}
+
+	const TableView now = Capture(simulation);
+
+	Writer writer;
+	writer.Put(MessageType::Result);
+	writer.Put(request.table);
+	writer.Put(request.sequence);
+	writer.Put(accepted ? Status::Ok : Status::Rejected);
+	writer.Put(static_cast<uint16_t>(ticks));
+	EncodeView(writer, now, table.sent, full);
+	table.sent = now;
+
+	table.busy.clear(std::memory_order_release);
+	return writer.Frame();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "headless.h"
+#include "TableProtocol.hpp"
+#include "physics/TableSimulation.hpp"
+#include "net/Socket.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class ThreadPool;
+
+// Hosts many independent tables. A table costs nothing between shots: a request
+// resolves the whole shot at the fixed tick (TableSimulation::ResolveShot) on the
+// pool and answers with the resulting state delta. Each connection has a reader
+// thread that only decodes and dispatches, so one client can keep shots on many
+// tables in flight at once; replies may come back out of order (match by sequence).
+// A table runs one request at a time, a second one meanwhile gets TableBusy.
+// Tables have no shot clock here, the players' side is expected to enforce one.
+class TableHost final
+{
+public:
+	TableHost(size_t table_count, ThreadPool& pool);
+	~TableHost();
+
+	TableHost(const TableHost&) = delete;
+	TableHost& operator= (const TableHost&) = delete;
+
+	// Accepts clients until Stop() (blocks)
+	void Serve(Socket& listener);
+	// Wakes Serve and shuts every connection down, then waits for their threads and requests
+	void Stop();
+
+	[[nodiscard]] size_t TableCount() const { return table_count_; }
+	[[nodiscard]] static constexpr size_t BytesPerTable() { return sizeof(Table); }
+
+	// Runs one request against its table and returns the framed reply (any thread)
+	std::vector<uint8_t> Handle(const TableProtocol::Request& request);
+
+private:
+	struct Table
+	{
+		TableSimulation simulation{ 0 };
+		TableProtocol::TableView sent{};      // state as of the last reply: the base of the next delta
+		std::atomic_flag busy{};
+	};
+
+	struct Connection
+	{
+		Socket socket;
+		std::mutex send_mutex;
+		std::thread reader;
+		std::atomic<bool> closed{ false };   // reader finished, ready to be joined
+	};
+
+	void ReadRequests(const std::shared_ptr<Connection>& connection);
+
+	size_t table_count_;
+	std::unique_ptr<Table[]> tables_;
+	ThreadPool& pool_;
+
+	Socket* listener_ = nullptr;
+	std::atomic<bool> stopping_{ false };
+	std::atomic<int> in_flight_{ 0 };         // requests queued or running on the pool
+	std::mutex connections_mutex_;
+	std::vector<std::shared_ptr<Connection>> connections_{};
+};
@@ -0,0 +1,201 @@
+#pragma once
+#include "headless.h"
+#include "net/ByteStream.hpp"
+
+#include <cmath>
+#include <optional>
+
+// Wire format between TableServer and its clients. Every message is a frame
+// (see net/ByteStream.hpp): u16 payload size, then the payload.
+//
+// Request:  u8 type, u32 table, u32 sequence, then per type
+//           NewRack      u32 seed
+//           Shot         f32 aim_x, f32 aim_z, f32 speed, f32 spin_x, f32 spin_y
+//           PlaceCueBall f32 x, f32 z        (ball in hand, placed and confirmed)
+//           FullState    -
+// Reply:    u8 Result, u32 table, u32 sequence, u8 status, u16 ticks simulated,
+//           then, for Ok and Rejected only, the table as a delta against the previous
+//           reply for that table (see EncodeView). NewRack and FullState send everything.
+namespace TableProtocol
+{
+	enum class MessageType : uint8_t { NewRack = 1, Shot = 2, PlaceCueBall = 3, FullState = 4, Result = 0x80 };
+	enum class Status : uint8_t { Ok = 0, Rejected = 1, TableBusy = 2, InvalidTable = 3, Malformed = 4 };
+
+	inline constexpr int ball_count = 16;
+	inline constexpr float position_scale = 16384.0f;   // 1/16384 m steps: +-2 m fits in an int16
+	inline constexpr size_t max_payload = 512;
+
+	struct Request
+	{
+		MessageType type = MessageType::FullState;
+		uint32_t table = 0;
+		uint32_t sequence = 0;
+		uint32_t seed = 0;
+		float aim_x = 0.0f, aim_z = 0.0f, speed = 0.0f;
+		float spin_x = 0.0f, spin_y = 0.0f;
+		float x = 0.0f, z = 0.0f;
+	};
+
+	// What a client knows about one table: quantized, so both ends compare exactly
+	struct TableView
+	{
+		std::array<int16_t, ball_count> x{};
+		std::array<int16_t, ball_count> z{};
+		std::array<uint8_t, ball_count> numbers{};   // ball number per slot (rack order)
+		uint16_t drawn = 0;                           // bit per slot: still on the table
+		uint8_t current_player = 0;
+		uint8_t flags = 0;                            // see Flag
+		std::array<int8_t, 2> groups{ -1, -1 };       // -1 open, 0 solids, 1 stripes
+		std::array<uint8_t, 2> scores{};
+		std::string message{};
+
+		bool operator== (const TableView&) const = default;
+	};
+
+	enum Flag : uint8_t { BallInHand = 1, GameOver = 2, AfterBreak = 4, TableOpen = 8 };
+
+	inline int16_t Quantize(const float meters)
+	{
+		return static_cast<int16_t>(std::clamp(std::lround(meters * position_scale), -32767L, 32767L));
+	}
+
+	inline float Dequantize(const int16_t value)
+	{
+		return static_cast<float>(value) / position_scale;
+	}
+
+	using Writer = ByteWriter;
+	using Reader = ByteReader;
+
+	inline std::vector<uint8_t> EncodeRequest(const Request& request)
+	{
+		Writer writer;
+		writer.Put(request.type);
+		writer.Put(request.table);
+		writer.Put(request.sequence);
+		switch (request.type)
+		{
+		case MessageType::NewRack:
+			writer.Put(request.seed);
+			break;
+		case MessageType::Shot:
+			writer.Put(request.aim_x);
+			writer.Put(request.aim_z);
+			writer.Put(request.speed);
+			writer.Put(request.spin_x);
+			writer.Put(request.spin_y);
+			break;
+		case MessageType::PlaceCueBall:
+			writer.Put(request.x);
+			writer.Put(request.z);
+			break;
+		default:
+			break;
+		}
+		return writer.Frame();
+	}
+
+	// Every number a request carries is finite (fields its type does not use are 0)
+	inline bool IsFinite(const Request& request)
+	{
+		for (const float value : { request.aim_x, request.aim_z, request.speed, request.spin_x, request.spin_y, request.x, request.z })
+			if (!std::isfinite(value))
+				return false;
+		return true;
+	}
+
+	inline std::optional<Request> DecodeRequest(const uint8_t* payload, const size_t size)
+	{
+		Reader reader(payload, size);
+		Request request;
+		if (!reader.Get(request.type) || !reader.Get(request.table) || !reader.Get(request.sequence))
+			return std::nullopt;
+
+		bool ok = true;
+		switch (request.type)
+		{
+		case MessageType::NewRack:
+			ok = reader.Get(request.seed);
+			break;
+		case MessageType::Shot:
+			ok = reader.Get(request.aim_x) && reader.Get(request.aim_z) && reader.Get(request.speed) &&
+				reader.Get(request.spin_x) && reader.Get(request.spin_y);
+			break;
+		case MessageType::PlaceCueBall:
+			ok = reader.Get(request.x) && reader.Get(request.z);
+			break;
+		case MessageType::FullState:
+			break;
+		default:
+			return std::nullopt;
+		}
+		if (!ok || !reader.AtEnd())
+			return std::nullopt;
+		return request;
+	}
+
+	// u8 full, u16 moved mask, (i16 x, i16 z) per moved slot, [u8 numbers x16 if full],
+	// u16 drawn, u8 player, u8 flags, i8 groups x2, u8 scores x2, u8 length + message
+	inline void EncodeView(Writer& writer, const TableView& now, const TableView& before, const bool full)
+	{
+		uint16_t moved = 0;
+		for (int slot = 0; slot < ball_count; ++slot)
+			if (full || now.x[slot] != before.x[slot] || now.z[slot] != before.z[slot])
+				moved |= static_cast<uint16_t>(1u << slot);
+
+		writer.Put(static_cast<uint8_t>(full));
+		writer.Put(moved);
+		for (int slot = 0; slot < ball_count; ++slot)
+		{
+			if (moved & (1u << slot))
+			{
+				writer.Put(now.x[slot]);
+				writer.Put(now.z[slot]);
+			}
+		}
+		if (full)
+			for (const uint8_t number : now.numbers)
+				writer.Put(number);
+
+		writer.Put(now.drawn);
+		writer.Put(now.current_player);
+		writer.Put(now.flags);
+		writer.Put(now.groups[0]);
+		writer.Put(now.groups[1]);
+		writer.Put(now.scores[0]);
+		writer.Put(now.scores[1]);
+
+		const auto length = static_cast<uint8_t>(std::min<size_t>(now.message.size(), 255));
+		writer.Put(length);
+		for (size_t i = 0; i < length; ++i)
+			writer.Put(now.message[i]);
+	}
+
+	// Applies an encoded view onto 'view' (the client's copy of that table)
+	inline bool DecodeView(Reader& reader, TableView& view)
+	{
+		uint8_t full = 0;
+		uint16_t moved = 0;
+		if (!reader.Get(full) || !reader.Get(moved))
+			return false;
+		for (int slot = 0; slot < ball_count; ++slot)
+			if ((moved & (1u << slot)) && !(reader.Get(view.x[slot]) && reader.Get(view.z[slot])))
+				return false;
+		if (full)
+			for (uint8_t& number : view.numbers)
+				if (!reader.Get(number))
+					return false;
+
+		uint8_t length = 0;
+		if (!(reader.Get(view.drawn) && reader.Get(view.current_player) && reader.Get(view.flags) &&
+			reader.Get(view.groups[0]) && reader.Get(view.groups[1]) &&
+			reader.Get(view.scores[0]) && reader.Get(view.scores[1]) && reader.Get(length)))
+			return false;
+
+		view.message.resize(length);
+		for (char& c : view.message)
+			if (!reader.Get(c))
+				return false;
+		return true;
+	}
+}
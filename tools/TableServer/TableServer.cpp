@@ -0,0 +1,209 @@
+#include "headless.h"
+#include "TableHost.hpp"
+#include "core/ThreadPool.hpp"
+#include "Logger.hpp"
+
+#include <chrono>
+
+// Headless server for hosted matches: thousands of independent tables (physics,
+// rules and game state only, no window or GL context) on one thread pool.
+// Clients submit shots over TCP (see TableProtocol.hpp) and get state deltas back.
+//
+// usage: TableServer [--tables N] [--port P] [--any]        serve (loopback only unless --any)
+//        TableServer --client [--port P] [--tables N] [--shots S]
+//        TableServer --loopback [--tables N] [--shots S]   server + client in one process
+
+namespace {
+	using namespace TableProtocol;
+
+	struct Options {
+		bool client = false;
+		bool loopback = false;
+		bool any_interface = false;
+		uint16_t port = 27015;
+		size_t tables = 1000;
+		int shots = 50;   // per table, client only
+	};
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			const bool has_value = i + 1 < argc;
+			if (arg == "--client") options.client = true;
+			else if (arg == "--loopback") options.loopback = true;
+			else if (arg == "--any") options.any_interface = true;
+			else if (arg == "--port" && has_value) options.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+			else if (arg == "--tables" && has_value) options.tables = std::stoul(argv[++i]);
+			else if (arg == "--shots" && has_value) options.shots = std::stoi(argv[++i]);
+			else return false;
+		}
+		return options.tables > 0 && options.tables <= 1'000'000;
+	}
+
+	// Test client: keeps one request in flight on every table (the server resolves them
+	// in parallel), plays random legal-looking shots, mirrors each table from the deltas
+	// and finally checks every mirror against a full state from the server
+	int runClient(const uint16_t port, const size_t tables, const int shots) {
+		const Socket socket = Socket::Connect("127.0.0.1", port);
+
+		std::vector<TableView> mirrors(tables);
+		std::vector<int> shots_left(tables, shots);
+		std::vector<bool> verifying(tables, false);
+		std::mt19937 rng(12345);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+		size_t shots_played = 0, racks = 0, fouls = 0, mismatches = 0, bytes = 0;
+		uint64_t ticks = 0;
+		uint32_t sequence = 0;
+
+		auto send = [&](Request request) {
+			request.sequence = sequence++;
+			const auto frame = EncodeRequest(request);
+			if (!socket.SendAll(frame.data(), frame.size()))
+				throw std::runtime_error("server closed the connection");
+		};
+
+		// Next request for a table, from what the client knows about it
+		auto next = [&](const uint32_t table) {
+			Request request;
+			request.table = table;
+			const TableView& view = mirrors[table];
+			if (shots_left[table] <= 0) {
+				request.type = MessageType::FullState;
+				verifying[table] = true;
+			}
+			else if (view.flags & GameOver) {
+				request.type = MessageType::NewRack;
+				request.seed = static_cast<uint32_t>(rng());
+				++racks;
+			}
+			else if (view.flags & BallInHand) {
+				request.type = MessageType::PlaceCueBall;
+				request.x = unit(rng) * 1.2f;
+				request.z = unit(rng) * 0.6f;
+			}
+			else {
+				// At a random ball still on the table, with some english
+				int target = 1 + static_cast<int>(rng() % (ball_count - 1));
+				for (int tries = 0; tries < ball_count && !(view.drawn & (1u << target)); ++tries)
+					target = 1 + (target % (ball_count - 1));
+				request.type = MessageType::Shot;
+				request.aim_x = Dequantize(view.x[target]) - Dequantize(view.x[0]) + unit(rng) * 0.01f;
+				request.aim_z = Dequantize(view.z[target]) - Dequantize(view.z[0]) + unit(rng) * 0.01f;
+				request.speed = 1.0f + 2.5f * (unit(rng) + 1.0f);
+				request.spin_x = unit(rng) * 0.3f;
+				request.spin_y = unit(rng) * 0.5f;
+				--shots_left[table];
+			}
+			send(request);
+		};
+
+		const auto start = std::chrono::steady_clock::now();
+		for (uint32_t table = 0; table < tables; ++table) {
+			Request rack;
+			rack.type = MessageType::NewRack;
+			rack.table = table;
+			rack.seed = table;
+			send(rack);
+		}
+
+		size_t finished = 0;
+		std::vector<uint8_t> payload;
+		while (finished < tables) {
+			uint16_t size = 0;
+			if (!socket.ReceiveAll(&size, sizeof(size)))
+				throw std::runtime_error("server closed the connection");
+			payload.resize(size);
+			if (!socket.ReceiveAll(payload.data(), payload.size()))
+				throw std::runtime_error("server closed the connection");
+			bytes += sizeof(size) + size;
+
+			Reader reader(payload.data(), payload.size());
+			MessageType type{};
+			uint32_t table = 0, reply_sequence = 0;
+			Status status{};
+			uint16_t reply_ticks = 0;
+			if (!reader.Get(type) || !reader.Get(table) || !reader.Get(reply_sequence) || !reader.Get(status) ||
+				!reader.Get(reply_ticks) || type != MessageType::Result || table >= tables)
+				throw std::runtime_error("malformed reply");
+			if (status != Status::Ok && status != Status::Rejected)
+				throw std::runtime_error(std::format("table {}: request failed ({})", table, static_cast<int>(status)));
+
+			if (verifying[table]) {
+				TableView full = mirrors[table];
+				if (!DecodeView(reader, full))
+					throw std::runtime_error("malformed state");
+				if (full != mirrors[table])
+					++mismatches;
+				++finished;
+				continue;
+			}
+
+			if (!DecodeView(reader, mirrors[table]))
+				throw std::runtime_error("malformed state");
+			ticks += reply_ticks;
+			shots_played += reply_ticks > 0;
+			fouls += status == Status::Rejected;
+			next(table);
+		}
+
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << std::format("TableServer client: {} shots on {} tables in {:.2f} s -> {:.0f} shots/s, {:.2f} M ticks/s\n",
+			shots_played, tables, seconds, shots_played / seconds, ticks / seconds * 1e-6);
+		std::cout << std::format("  {} re-racks, {} rejected requests, {:.1f} bytes per reply, {} mirror mismatches\n",
+			racks, fouls, static_cast<double>(bytes) / static_cast<double>(shots_played + racks + fouls + tables * 2), mismatches);
+		return mismatches == 0 ? 0 : 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		if (!parseOptions(argc, argv, options))
+		{
+			std::cerr << "usage: TableServer [--tables N] [--port P] [--any]\n"
+				"       TableServer --client [--port P] [--tables N] [--shots S]\n"
+				"       TableServer --loopback [--tables N] [--shots S]\n";
+			return 2;
+		}
+
+		if (options.client)
+			return runClient(options.port, options.tables, options.shots);
+
+		Logger::Init("table_server.log");
+		TableHost host(options.tables, ThreadPool::Shared());
+		Socket listener = Socket::Listen(options.loopback ? 0 : options.port, !options.any_interface);
+		LOG_INFO(General, std::format("TableServer: {} tables ({} bytes each) on port {}, {} workers",
+			host.TableCount(), TableHost::BytesPerTable(), listener.LocalPort(), ThreadPool::Shared().WorkerCount()));
+
+		if (!options.loopback)
+		{
+			host.Serve(listener);
+			Logger::Close();
+			return 0;
+		}
+
+		std::thread server([&] { host.Serve(listener); });
+		int result = 1;
+		try
+		{
+			result = runClient(listener.LocalPort(), options.tables, options.shots);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "TableServer: " << e.what() << '\n';
+		}
+		host.Stop();
+		server.join();
+		Logger::Close();
+		return result;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "TableServer: " << e.what() << '\n';
+		return 1;
+	}
+}
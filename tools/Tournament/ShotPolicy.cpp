@@ -0,0 +1,358 @@
+#include "headless.h"
+#include "ShotPolicy.hpp"
+#include "Common/HeadlessRun.hpp"
+
+#include <limits>
+
+namespace
+{
+	constexpr float kRadius = BallBody::radius;
+	constexpr float kPathClearance = 2.0f * kRadius + 0.002f;
+	constexpr float kMinCut = 0.3f;              // cos of the thinnest cut worth playing (~72 degrees)
+	constexpr float kArrivalSpeed = 0.4f;        // m/s the object ball should still have at the pocket
+	constexpr float kLeaveDistance = 0.25f;      // ball in hand: cue ball this far behind the ghost ball
+
+	glm::vec2 XZ(const glm::vec3& v) { return { v.x, v.z }; }
+	glm::vec3 FromXZ(const glm::vec2& v) { return { v.x, 0.0f, v.y }; }
+
+	// Speed a rolling ball loses per metre: damping is exponential in time, so it is
+	// linear in distance (dv/dx = -lambda)
+	float SpeedLossPerMetre(const TableSimulation& table)
+	{
+		return -std::log(table.Params().linear_damping) * 60.0f;
+	}
+
+	float SegmentDistance(const glm::vec2 p, const glm::vec2 a, const glm::vec2 b)
+	{
+		const glm::vec2 ab = b - a;
+		const float length2 = glm::dot(ab, ab);
+		const float t = length2 > 0.0f ? glm::clamp(glm::dot(p - a, ab) / length2, 0.0f, 1.0f) : 0.0f;
+		return glm::length(p - (a + ab * t));
+	}
+
+	// No object ball but 'skip' within a ball's width of the path a -> b (the cue ball is
+	// left out: callers check its spot themselves, it may be about to be placed)
+	bool IsClear(const std::array<BallBody, TableSimulation::ball_count>& balls, const glm::vec2 a, const glm::vec2 b, const int skip)
+	{
+		for (int slot = 1; slot < TableSimulation::ball_count; ++slot)
+		{
+			const BallBody& ball = balls[slot];
+			if (slot == skip || !ball.drawn || ball.in_hole)
+				continue;
+			if (SegmentDistance(XZ(ball.position), a, b) < kPathClearance)
+				return false;
+		}
+		return true;
+	}
+
+	struct Pot
+	{
+		int slot = 0;
+		glm::vec2 aim{ 0.0f };
+		float speed = 0.0f;
+		float score = 0.0f;    // higher is easier
+	};
+
+	// Every clear pot from 'cue': a legal ball sent straight into a pocket by the ghost ball
+	void FindPots(const TableSimulation& table, const glm::vec2 cue, std::vector<Pot>& out)
+	{
+		out.clear();
+		const auto& balls = table.Balls();
+		const uint16_t legal = table.LegalTargets();
+		const float loss = SpeedLossPerMetre(table);
+
+		for (int slot = 1; slot < TableSimulation::ball_count; ++slot)
+		{
+			const BallBody& ball = balls[slot];
+			if (!ball.drawn || ball.in_hole || !(legal & RackMask::Bit(ball.number)))
+				continue;
+
+			const glm::vec2 target = XZ(ball.position);
+			for (const glm::vec3& hole : TableGeometry::holes)
+			{
+				const glm::vec2 pocket = XZ(hole);
+				const float run = glm::length(pocket - target);
+				if (run < 1e-4f)
+					continue;
+				const glm::vec2 line = (pocket - target) / run;
+
+				// Side pockets only take balls coming in across the table
+				if (hole.x == 0.0f && std::abs(line.y) < 0.6f)
+					continue;
+
+				const glm::vec2 ghost = target - line * (2.0f * kRadius);
+				const float approach = glm::length(ghost - cue);
+				if (approach < 1e-4f)
+					continue;
+				const glm::vec2 aim = (ghost - cue) / approach;
+				const float cut = glm::dot(aim, line);
+				if (cut < kMinCut)
+					continue;
+
+				if (!IsClear(balls, cue, ghost, slot) || !IsClear(balls, target, pocket, slot) ||
+					SegmentDistance(cue, target, pocket) < kPathClearance)
+					continue;
+
+				// The object ball leaves with about speed * cut
+				const float object_speed = loss * run + kArrivalSpeed;
+				const float speed = glm::clamp(object_speed / cut + loss * approach, 0.6f, TableSimulation::MaxShotSpeed());
+				out.push_back({ slot, aim, speed, cut * cut / (1.0f + approach + run) });
+			}
+		}
+		std::sort(out.begin(), out.end(), [](const Pot& a, const Pot& b) { return a.score > b.score; });
+	}
+
+	// Nothing to pot: hit the nearest legal ball full and hard enough to reach a cushion
+	ShotPolicy::Shot SafeHit(const TableSimulation& table)
+	{
+		const auto& balls = table.Balls();
+		const uint16_t legal = table.LegalTargets();
+		const glm::vec2 cue = XZ(balls[0].position);
+
+		int best = -1;
+		float best_distance = std::numeric_limits<float>::max();
+		bool best_clear = false;
+		for (int slot = 1; slot < TableSimulation::ball_count; ++slot)
+		{
+			const BallBody& ball = balls[slot];
+			if (!ball.drawn || ball.in_hole || !(legal & RackMask::Bit(ball.number)))
+				continue;
+			const glm::vec2 target = XZ(ball.position);
+			const bool clear = IsClear(balls, cue, target, slot);
+			const float distance = glm::length(target - cue);
+			if ((clear && !best_clear) || (clear == best_clear && distance < best_distance))
+			{
+				best = slot;
+				best_distance = distance;
+				best_clear = clear;
+			}
+		}
+
+		ShotPolicy::Shot shot;
+		if (best == -1)
+			return { glm::vec3(-1.0f, 0.0f, 0.0f), 2.0f, glm::vec2(0.0f) };
+		shot.aim = FromXZ(XZ(balls[best].position) - cue);
+		shot.speed = glm::clamp(SpeedLossPerMetre(table) * (best_distance + 1.0f) + 1.0f, 0.6f, TableSimulation::MaxShotSpeed());
+		return shot;
+	}
+
+	ShotPolicy::Shot Break(const TableSimulation& table, std::mt19937& rng)
+	{
+		// Full power into the head ball, a touch off centre
+		std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+		const auto& balls = table.Balls();
+		const glm::vec3 head = balls[1].position + glm::vec3(0.0f, 0.0f, offset(rng) * kRadius);
+		return { head - balls[0].position, TableSimulation::MaxShotSpeed(), glm::vec2(0.0f) };
+	}
+
+	bool IsFreeSpot(const TableSimulation& table, const glm::vec2 spot)
+	{
+		if (std::abs(spot.x) > TableGeometry::bound_x - 0.01f || std::abs(spot.y) > TableGeometry::bound_z - 0.01f)
+			return false;
+		for (const glm::vec3& hole : TableGeometry::holes)
+			if (glm::length(XZ(hole) - spot) < TableGeometry::hole_radius + 2.0f * kRadius)
+				return false;
+		for (int slot = 1; slot < TableSimulation::ball_count; ++slot)
+		{
+			const BallBody& ball = table.Balls()[slot];
+			if (ball.drawn && !ball.in_hole && glm::length(XZ(ball.position) - spot) < 2.0f * kRadius + 0.01f)
+				return false;
+		}
+		return true;
+	}
+
+	glm::vec2 RandomFreeSpot(const TableSimulation& table, std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> x(-TableGeometry::bound_x, TableGeometry::bound_x);
+		std::uniform_real_distribution<float> z(-TableGeometry::bound_z, TableGeometry::bound_z);
+		glm::vec2 spot(x(rng), z(rng));
+		for (int tries = 0; tries < 64 && !IsFreeSpot(table, spot); ++tries)
+			spot = glm::vec2(x(rng), z(rng));
+		return spot;
+	}
+
+	// How good the table is for the player to move, with the cue ball where it is
+	float BestPotScore(const TableSimulation& table, std::vector<Pot>& scratch)
+	{
+		FindPots(table, XZ(table.CueBall().position), scratch);
+		return scratch.empty() ? 0.0f : scratch.front().score;
+	}
+}
+
+ShotPolicy::ShotPolicy(const Kind kind, const float aim_noise, const int candidates) :
+	kind_(kind),
+	aim_noise_(aim_noise),
+	candidates_(std::max(candidates, 1))
+{
+}
+
+std::optional<ShotPolicy> ShotPolicy::Parse(const std::string_view spec)
+{
+	std::vector<std::string_view> parts;
+	size_t start = 0;
+	while (start <= spec.size())
+	{
+		const size_t end = std::min(spec.find(':', start), spec.size());
+		parts.push_back(spec.substr(start, end - start));
+		start = end + 1;
+	}
+
+	Kind kind;
+	if (parts[0] == "random") kind = Kind::Random;
+	else if (parts[0] == "greedy") kind = Kind::Greedy;
+	else if (parts[0] == "search") kind = Kind::Search;
+	else return std::nullopt;
+
+	try
+	{
+		const float noise = parts.size() > 1 ? std::stof(std::string(parts[1])) : 0.0f;
+		const int candidates = parts.size() > 2 ? std::stoi(std::string(parts[2])) : 6;
+		if (noise < 0.0f || candidates < 1 || parts.size() > 3 || (kind != Kind::Search && parts.size() > 2))
+			return std::nullopt;
+		return ShotPolicy(kind, noise, candidates);
+	}
+	catch (const std::exception&)
+	{
+		return std::nullopt;
+	}
+}
+
+std::string ShotPolicy::Name() const
+{
+	switch (kind_)
+	{
+	case Kind::Random: return std::format("random({:g} deg)", aim_noise_);
+	case Kind::Greedy: return std::format("greedy({:g} deg)", aim_noise_);
+	case Kind::Search: return std::format("search({:g} deg, {} candidates)", aim_noise_, candidates_);
+	}
+	return "?";
+}
+
+ShotPolicy::Shot ShotPolicy::ChooseShot(TableSimulation& table, std::mt19937& rng) const
+{
+	Shot shot;
+	std::vector<Pot> pots;
+
+	if (table.State().IsAfterBreak())
+	{
+		shot = Break(table, rng);
+	}
+	else if (kind_ == Kind::Random)
+	{
+		// A legal ball, cut anywhere up to half a ball either side
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		const auto& balls = table.Balls();
+		const uint16_t legal = table.LegalTargets();
+		std::vector<int> slots;
+		for (int slot = 1; slot < TableSimulation::ball_count; ++slot)
+			if (balls[slot].drawn && !balls[slot].in_hole && (legal & RackMask::Bit(balls[slot].number)))
+				slots.push_back(slot);
+		if (slots.empty())
+			return SafeHit(table);
+
+		const glm::vec3 target = balls[slots[rng() % slots.size()]].position;
+		const glm::vec3 to_target = target - balls[0].position;
+		const glm::vec3 side = glm::normalize(glm::vec3(-to_target.z, 0.0f, to_target.x));
+		shot.aim = to_target + side * (unit(rng) * kRadius);
+		shot.speed = 1.0f + 1.5f * (unit(rng) + 1.0f);
+		shot.spin = glm::vec2(unit(rng) * 0.3f, unit(rng) * 0.5f);
+	}
+	else
+	{
+		FindPots(table, XZ(table.CueBall().position), pots);
+		if (pots.empty())
+			shot = SafeHit(table);
+		else if (kind_ == Kind::Greedy)
+			shot = { FromXZ(pots.front().aim), pots.front().speed, glm::vec2(0.0f) };
+		else
+		{
+			// Play the easiest few out for real (stun, follow, draw) and keep the one that
+			// leaves the best table: our next pot if we keep it, else the opponent's worst
+			const int me = table.State().CurrentPlayerIndex();
+			const TableSimulation::Snapshot before = table.Save();
+			const float dt = 1.0f / static_cast<float>(Config::simulation_rate);
+			std::vector<Pot> scratch;
+
+			const int count = std::min(static_cast<int>(pots.size()), candidates_);
+			float best_value = -std::numeric_limits<float>::max();
+			for (int i = 0; i < count; ++i)
+			{
+				for (const float draw : { 0.0f, 0.4f, -0.4f })
+				{
+					const Shot candidate{ FromXZ(pots[i].aim), pots[i].speed, glm::vec2(0.0f, draw) };
+					table.Restore(before);
+					if (!table.Shoot(candidate.aim, candidate.speed, candidate.spin))
+						continue;
+					table.ResolveShot(dt, HeadlessRun::max_shot_ticks);
+
+					const GameState& state = table.State();
+					float value;
+					if (state.IsGameOver())
+						value = state.Winner() == me ? 1000.0f : -1000.0f;
+					else if (state.CurrentPlayerIndex() == me && !state.BallInHand())
+						value = 10.0f + BestPotScore(table, scratch);
+					else
+						value = state.BallInHand() ? -10.0f : -BestPotScore(table, scratch);
+
+					if (value > best_value)
+					{
+						best_value = value;
+						shot = candidate;
+					}
+				}
+			}
+			table.Restore(before);
+			if (best_value == -std::numeric_limits<float>::max())
+				shot = SafeHit(table);
+		}
+	}
+
+	if (aim_noise_ > 0.0f)
+	{
+		std::normal_distribution<float> error(0.0f, glm::radians(aim_noise_));
+		const float angle = error(rng);
+		const float c = std::cos(angle), s = std::sin(angle);
+		shot.aim = glm::vec3(c * shot.aim.x + s * shot.aim.z, 0.0f, c * shot.aim.z - s * shot.aim.x);
+	}
+	return shot;
+}
+
+glm::vec3 ShotPolicy::PlaceCueBall(const TableSimulation& table, std::mt19937& rng) const
+{
+	if (kind_ == Kind::Random)
+		return FromXZ(RandomFreeSpot(table, rng)) + glm::vec3(0.0f, kRadius, 0.0f);
+
+	// Straight in: the cue ball a little behind the ghost ball of the easiest pot
+	const auto& balls = table.Balls();
+	const uint16_t legal = table.LegalTargets();
+	glm::vec2 best_spot = RandomFreeSpot(table, rng);
+	float best_score = -1.0f;
+	for (int slot = 1; slot < TableSimulation::ball_count; ++slot)
+	{
+		const BallBody& ball = balls[slot];
+		if (!ball.drawn || ball.in_hole || !(legal & RackMask::Bit(ball.number)))
+			continue;
+
+		const glm::vec2 target = XZ(ball.position);
+		for (const glm::vec3& hole : TableGeometry::holes)
+		{
+			const glm::vec2 pocket = XZ(hole);
+			const float run = glm::length(pocket - target);
+			if (run < 1e-4f)
+				continue;
+			const glm::vec2 line = (pocket - target) / run;
+			if (hole.x == 0.0f && std::abs(line.y) < 0.6f)
+				continue;
+
+			const glm::vec2 ghost = target - line * (2.0f * kRadius);
+			const glm::vec2 spot = ghost - line * kLeaveDistance;
+			const float score = 1.0f / (1.0f + run);
+			if (score <= best_score || !IsFreeSpot(table, spot) ||
+				!IsClear(balls, spot, ghost, slot) || !IsClear(balls, target, pocket, slot))
+				continue;
+			best_score = score;
+			best_spot = spot;
+		}
+	}
+	return FromXZ(best_spot) + glm::vec3(0.0f, kRadius, 0.0f);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "headless.h"
+#include "physics/TableSimulation.hpp"
+
+#include <optional>
+
+// One side of an AI-vs-AI game: picks shots and ball-in-hand spots from what is on
+// the table, the way a player would (no peeking at the rng of the other side).
+//   random   any legal ball, random cut, power and spin
+//   greedy   the easiest clear pot (ghost ball to a pocket), else a safe hit
+//   search   the best few greedy pots (with stun, follow and draw) played out on
+//            the real table and scored by what they leave; restores the table after
+// Each takes an aiming error: the aim is turned by a normal draw of 'aim_noise' degrees.
+class ShotPolicy final
+{
+public:
+	enum class Kind : uint8_t { Random, Greedy, Search };
+
+	struct Shot
+	{
+		glm::vec3 aim{ 1.0f, 0.0f, 0.0f };
+		float speed = 0.0f;
+		glm::vec2 spin{ 0.0f };
+	};
+
+	ShotPolicy(Kind kind, float aim_noise, int candidates);
+
+	// "random", "greedy[:noise]", "search[:noise[:candidates]]"
+	static std::optional<ShotPolicy> Parse(std::string_view spec);
+
+	// For the player to move, ball not in hand. 'table' is only borrowed by search
+	Shot ChooseShot(TableSimulation& table, std::mt19937& rng) const;
+	// Ball in hand: where to put the cue ball
+	glm::vec3 PlaceCueBall(const TableSimulation& table, std::mt19937& rng) const;
+
+	[[nodiscard]] std::string Name() const;
+
+private:
+	Kind kind_;
+	float aim_noise_;    // degrees
+	int candidates_;     // search only
+};
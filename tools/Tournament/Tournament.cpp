@@ -0,0 +1,242 @@
+#include "headless.h"
+#include "ShotPolicy.hpp"
+#include "core/ThreadPool.hpp"
+#include "Common/HeadlessRun.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+// Headless AI-vs-AI 8-ball: plays whole games between two shot policies on every
+// core, adjudicated by the game's own rules (GameRules::EvaluateEndOfShot through
+// TableSimulation), and reports throughput, win rates and how each side fouls.
+// Games are seeded from --seed and their index, so a run is reproducible whatever
+// the thread count. Doubles as a soak test: a table that breaks an invariant
+// (mask out of step with the balls, a ball off the table, a shot that never
+// settles) is counted as an anomaly and fails the run.
+//
+// usage: Tournament [--games N] [--a POLICY] [--b POLICY] [--seed S] [--max-turns T] [--threads N]
+//        POLICY: random | greedy[:aim noise deg] | search[:aim noise deg[:candidates]]
+
+namespace {
+	using Foul = GameRules::Foul;
+
+	struct Options {
+		size_t games = 1000;
+		ShotPolicy a{ ShotPolicy::Kind::Greedy, 0.5f, 6 };
+		ShotPolicy b{ ShotPolicy::Kind::Random, 0.0f, 6 };
+		uint32_t seed = 1;
+		int max_turns = 400;     // per game, then it is a draw
+		size_t threads = 0;      // 0: every hardware thread
+	};
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (i + 1 >= argc)
+				return false;
+			const std::string_view value = argv[++i];
+			if (arg == "--games") options.games = std::stoul(std::string(value));
+			else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(std::string(value)));
+			else if (arg == "--max-turns") options.max_turns = std::stoi(std::string(value));
+			else if (arg == "--threads") options.threads = std::stoul(std::string(value));
+			else if (arg == "--a" || arg == "--b") {
+				const std::optional<ShotPolicy> policy = ShotPolicy::Parse(value);
+				if (!policy)
+					return false;
+				(arg == "--a" ? options.a : options.b) = *policy;
+			}
+			else return false;
+		}
+		return options.games > 0 && options.max_turns > 0;
+	}
+
+	// Per side (0 = A, 1 = B) unless noted
+	struct Totals {
+		size_t games = 0;
+		std::array<size_t, 2> wins{};
+		std::array<size_t, 2> breaks_won{};        // games won by the side that broke
+		std::array<size_t, 2> lost_on_eight{};     // 8 pocketed early or with a foul
+		size_t draws = 0;                          // hit --max-turns
+		std::array<size_t, 2> shots{};
+		std::array<std::array<size_t, GameRules::foul_kinds>, 2> fouls{};
+		std::array<size_t, 2> placement_fouls{};   // ball in hand put down touching a ball
+		uint64_t ticks = 0;
+		size_t timeouts = 0;                       // shots stopped after HeadlessRun::max_shot_seconds
+		size_t anomalies = 0;
+
+		void Add(const Totals& other) {
+			games += other.games;
+			draws += other.draws;
+			ticks += other.ticks;
+			timeouts += other.timeouts;
+			anomalies += other.anomalies;
+			for (int side = 0; side < 2; ++side) {
+				wins[side] += other.wins[side];
+				breaks_won[side] += other.breaks_won[side];
+				lost_on_eight[side] += other.lost_on_eight[side];
+				shots[side] += other.shots[side];
+				placement_fouls[side] += other.placement_fouls[side];
+				for (int kind = 0; kind < GameRules::foul_kinds; ++kind)
+					fouls[side][kind] += other.fouls[side][kind];
+			}
+		}
+	};
+
+	// What the rules and the physics promise after every shot
+	bool isConsistent(const TableSimulation& table) {
+		uint16_t drawn = 0;
+		for (const BallBody& ball : table.Balls()) {
+			if (ball.drawn)
+				drawn |= RackMask::Bit(ball.number);
+			const glm::vec3& p = ball.position;
+			if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z))
+				return false;
+			// Pocket mouths reach past the cushion lines, but not past the table's edge
+			if (ball.drawn && !ball.in_hole &&
+				(std::abs(p.x) > TableGeometry::bound_x + TableGeometry::hole_radius ||
+					std::abs(p.z) > TableGeometry::bound_z + TableGeometry::hole_radius))
+				return false;
+		}
+		return drawn == table.OnTable().on_table && !table.AreBallsInMotion() && !table.State().CheckRulesPending();
+	}
+
+	// Side A breaks the even games, B the odd ones; the breaker is player 0
+	void playGame(const Options& options, const size_t game, Totals& totals) {
+		const uint32_t seed = options.seed * 0x9E3779B9u + static_cast<uint32_t>(game);
+		TableSimulation table(seed);
+		std::mt19937 rng(seed);
+		const int breaker = static_cast<int>(game % 2);
+		const std::array<const ShotPolicy*, 2> policies{ &options.a, &options.b };
+		auto sideOf = [breaker](const int player) { return player == 0 ? breaker : 1 - breaker; };
+
+		const float dt = 1.0f / static_cast<float>(Config::simulation_rate);
+		GameState& state = table.State();
+		int last_shooter = 0;
+		for (int turn = 0; turn < options.max_turns && !state.IsGameOver(); ++turn) {
+			const int side = sideOf(state.CurrentPlayerIndex());
+			const ShotPolicy& policy = *policies[side];
+
+			if (state.BallInHand()) {
+				// A touching spot is a foul: the turn passes, still ball in hand
+				if (table.PlaceCueBall(policy.PlaceCueBall(table, rng)))
+					table.ConfirmCueBall();
+				else
+					++totals.placement_fouls[side];
+				continue;
+			}
+
+			const ShotPolicy::Shot shot = policy.ChooseShot(table, rng);
+			if (!table.Shoot(shot.aim, shot.speed, shot.spin)) {
+				++totals.anomalies;
+				break;
+			}
+			last_shooter = side;
+			const HeadlessRun::ResolvedShot resolved = HeadlessRun::ResolveShot(table, dt);
+			totals.ticks += static_cast<uint64_t>(resolved.ticks);
+			totals.timeouts += resolved.timed_out;
+			++totals.shots[side];
+			++totals.fouls[side][static_cast<int>(table.LastFoul())];
+			if (!isConsistent(table)) {
+				++totals.anomalies;
+				break;
+			}
+		}
+
+		++totals.games;
+		if (!state.IsGameOver() || state.Winner() < 0) {
+			++totals.draws;
+			return;
+		}
+		const int winner = sideOf(state.Winner());
+		++totals.wins[winner];
+		totals.breaks_won[breaker] += winner == breaker;
+		totals.lost_on_eight[last_shooter] += winner != last_shooter;
+	}
+
+	void report(const Options& options, const Totals& totals, const size_t threads, const double seconds) {
+		const size_t shots = totals.shots[0] + totals.shots[1];
+		std::cout << std::format("Tournament: {} games on {} threads in {:.2f} s -> {:.1f} games/s, {:.0f} shots/s, {:.2f} M ticks/s\n",
+			totals.games, threads, seconds, totals.games / seconds, shots / seconds, totals.ticks / seconds * 1e-6);
+
+		const size_t decided = totals.games - totals.draws;
+		const std::array<std::string, 2> names{ "A " + options.a.Name(), "B " + options.b.Name() };
+		for (int side = 0; side < 2; ++side) {
+			const auto [low, high] = HeadlessRun::Wilson(totals.wins[side], decided);
+			std::cout << std::format("  {:<36} wins {:>6} ({:5.1f} %, 95 % CI {:5.1f} - {:5.1f} %)\n", names[side], totals.wins[side],
+				decided ? 100.0 * totals.wins[side] / decided : 0.0, 100.0 * low, 100.0 * high);
+		}
+
+		const size_t breaker_wins = totals.breaks_won[0] + totals.breaks_won[1];
+		const auto [low, high] = HeadlessRun::Wilson(breaker_wins, decided);
+		std::cout << std::format("  breaker wins {:.1f} % (95 % CI {:.1f} - {:.1f} %), {} draws at {} turns\n",
+			decided ? 100.0 * breaker_wins / decided : 0.0, 100.0 * low, 100.0 * high, totals.draws, options.max_turns);
+
+		std::cout << "  fouls per 100 shots:\n";
+		for (int side = 0; side < 2; ++side) {
+			const double per = totals.shots[side] ? 100.0 / static_cast<double>(totals.shots[side]) : 0.0;
+			std::string line = std::format("    {} ({} shots):", side == 0 ? "A" : "B", totals.shots[side]);
+			for (int kind = 1; kind < GameRules::foul_kinds; ++kind)
+				line += std::format(" {} {:.1f},", GameRules::FoulName(static_cast<Foul>(kind)), totals.fouls[side][kind] * per);
+			line += std::format(" bad placement {}, lost on the 8 {}", totals.placement_fouls[side], totals.lost_on_eight[side]);
+			std::cout << line << '\n';
+		}
+		std::cout << std::format("  {} shots stopped after {} s, {} anomalies\n", totals.timeouts, HeadlessRun::max_shot_seconds, totals.anomalies);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		if (!parseOptions(argc, argv, options))
+		{
+			std::cerr << "usage: Tournament [--games N] [--a POLICY] [--b POLICY] [--seed S] [--max-turns T] [--threads N]\n"
+				"       POLICY: random | greedy[:aim noise deg] | search[:aim noise deg[:candidates]]\n";
+			return 2;
+		}
+
+		// The caller runs chunks too, so N threads is N - 1 workers
+		std::unique_ptr<ThreadPool> own_pool;
+		if (options.threads > 1)
+			own_pool = std::make_unique<ThreadPool>(options.threads - 1);
+		ThreadPool& pool = own_pool ? *own_pool : ThreadPool::Shared();
+		const size_t threads = options.threads == 1 ? 1 : pool.WorkerCount() + 1;
+
+		std::cout << std::format("A: {}\nB: {}\n", options.a.Name(), options.b.Name());
+
+		Totals totals;
+		std::mutex totals_mutex;
+		std::atomic<size_t> finished{ 0 };
+		const size_t progress_step = std::max<size_t>(options.games / 10, 1);
+
+		auto play = [&](const size_t begin, const size_t end) {
+			Totals local;
+			for (size_t game = begin; game < end; ++game)
+				playGame(options, game, local);
+
+			std::lock_guard lock(totals_mutex);
+			totals.Add(local);
+			const size_t before = finished.fetch_add(end - begin);
+			if ((before + end - begin) / progress_step != before / progress_step && before + end - begin < options.games)
+				std::cout << std::format("  {} / {} games\n", before + end - begin, options.games) << std::flush;
+		};
+
+		const auto start = std::chrono::steady_clock::now();
+		if (threads == 1)
+			play(0, options.games);
+		else
+			pool.ParallelFor(options.games, std::max<size_t>(options.games / (threads * 16), 1), play);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		report(options, totals, threads, seconds);
+		return totals.anomalies == 0 ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Tournament: " << e.what() << '\n';
+		return 1;
+	}
+}